@@ -1,3 +1,5 @@
 "E:\Development\CLI Tools\shaderc\bin\glslc.exe" shader.vert -o vert.spv
 "E:\Development\CLI Tools\shaderc\bin\glslc.exe" shader.frag -o frag.spv
+"E:\Development\CLI Tools\shaderc\bin\glslc.exe" shader_quantized.vert -o vert_quantized.spv
+"E:\Development\CLI Tools\shaderc\bin\glslc.exe" meshlet_cull.comp -o comp_meshlet_cull.spv
 
@@ -0,0 +1,569 @@
+#include "BCEncoder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+#include "Image.h"
+#include "KTX2Image.h"
+#include "PNGImage.h"
+#include "PixelKernels.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define BC_ENCODER_SSE2
+#endif
+
+static constexpr uint32_t TEXELS_PER_BLOCK = 16;
+
+/* Interpolation weights of BC7's 4-bit indices, out of 64
+*/
+static constexpr uint32_t BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+/* @brief Accumulates fields into a 128-bit block from the least significant bit up
+*/
+class BlockWriter
+{
+public:
+	void put(uint64_t value, uint32_t numBits)
+	{
+		for (uint32_t i = 0; i < numBits; ++i, ++_bitPos)
+		{
+			_words[_bitPos / 64] |= ((value >> i) & 1) << (_bitPos % 64);
+		}
+	}
+
+	void store(uint8_t* pDst, size_t numBytes) const
+	{
+		memcpy(pDst, _words, numBytes);
+	}
+
+private:
+	uint64_t _words[2] = {};
+	uint32_t _bitPos = 0;
+};
+
+/* @brief Rounds an 8-bit RGB color to a packed RGB565 value
+*/
+static uint16_t pack_565(const uint8_t* pColor)
+{
+	uint32_t r = (pColor[0] * 31 + 127) / 255;
+	uint32_t g = (pColor[1] * 63 + 127) / 255;
+	uint32_t b = (pColor[2] * 31 + 127) / 255;
+	return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+/* @brief Expands a packed RGB565 value to an opaque 8-bit RGBA color
+*/
+static void unpack_565(uint16_t packed, uint8_t* pColor)
+{
+	uint32_t r = (packed >> 11) & 31;
+	uint32_t g = (packed >> 5) & 63;
+	uint32_t b = packed & 31;
+	pColor[0] = static_cast<uint8_t>((r << 3) | (r >> 2));
+	pColor[1] = static_cast<uint8_t>((g << 2) | (g >> 4));
+	pColor[2] = static_cast<uint8_t>((b << 3) | (b >> 2));
+	pColor[3] = 0xFF;
+}
+
+static bool is_srgb(VkFormat format)
+{
+	return format == VK_FORMAT_BC1_RGB_SRGB_BLOCK || format == VK_FORMAT_BC3_SRGB_BLOCK || format == VK_FORMAT_BC7_SRGB_BLOCK;
+}
+
+
+/*
+* PUBLIC STATIC METHOD DEFINITIONS
+*/
+
+const char* BCEncoder::instruction_set()
+{
+#if defined(BC_ENCODER_SSE2)
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
+
+bool BCEncoder::is_supported_format(VkFormat format)
+{
+	switch (format)
+	{
+	case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+	case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+	case VK_FORMAT_BC3_UNORM_BLOCK:
+	case VK_FORMAT_BC3_SRGB_BLOCK:
+	case VK_FORMAT_BC5_UNORM_BLOCK:
+	case VK_FORMAT_BC7_UNORM_BLOCK:
+	case VK_FORMAT_BC7_SRGB_BLOCK:
+		return true;
+	default:
+		return false;
+	}
+}
+
+size_t BCEncoder::block_size(VkFormat format)
+{
+	switch (format)
+	{
+	case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+	case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+	case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+	case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+		return 8;
+	case VK_FORMAT_BC3_UNORM_BLOCK:
+	case VK_FORMAT_BC3_SRGB_BLOCK:
+	case VK_FORMAT_BC5_UNORM_BLOCK:
+	case VK_FORMAT_BC5_SNORM_BLOCK:
+	case VK_FORMAT_BC7_UNORM_BLOCK:
+	case VK_FORMAT_BC7_SRGB_BLOCK:
+		return 16;
+	default:
+		return 0;
+	}
+}
+
+size_t BCEncoder::encoded_size(VkFormat format, uint32_t width, uint32_t height)
+{
+	size_t blocksX = (static_cast<size_t>(width) + 3) / 4;
+	size_t blocksY = (static_cast<size_t>(height) + 3) / 4;
+	return blocksX * blocksY * block_size(format);
+}
+
+void BCEncoder::encode_block(const uint8_t* pTexels, VkFormat format, uint8_t* pDst)
+{
+	switch (format)
+	{
+	case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+	case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+		_encode_color_block(pTexels, pDst);
+		break;
+	case VK_FORMAT_BC3_UNORM_BLOCK:
+	case VK_FORMAT_BC3_SRGB_BLOCK:
+		_encode_channel_block(pTexels, 3, pDst);
+		_encode_color_block(pTexels, pDst + 8);
+		break;
+	case VK_FORMAT_BC5_UNORM_BLOCK:
+		_encode_channel_block(pTexels, 0, pDst);
+		_encode_channel_block(pTexels, 1, pDst + 8);
+		break;
+	case VK_FORMAT_BC7_UNORM_BLOCK:
+	case VK_FORMAT_BC7_SRGB_BLOCK:
+		_encode_bc7_block(pTexels, pDst);
+		break;
+	default:
+		throw std::invalid_argument("Only BC1, BC3, BC5 and BC7 formats can be encoded");
+	}
+}
+
+void BCEncoder::encode(const uint8_t* pPixels, uint32_t width, uint32_t height, VkFormat format, uint8_t* pDst, ThreadPool& pool)
+{
+	if (!is_supported_format(format))
+	{
+		throw std::invalid_argument("Only BC1, BC3, BC5 and BC7 formats can be encoded");
+	}
+
+	uint32_t blocksX = (width + 3) / 4;
+	uint32_t blocksY = (height + 3) / 4;
+	size_t blockSize = block_size(format);
+
+	auto encode_rows = [=](uint32_t firstRow, uint32_t endRow) {
+		uint8_t texels[TEXELS_PER_BLOCK * 4];
+		for (uint32_t by = firstRow; by < endRow; ++by)
+		{
+			for (uint32_t bx = 0; bx < blocksX; ++bx)
+			{
+				for (uint32_t i = 0; i < TEXELS_PER_BLOCK; ++i)
+				{
+					uint32_t x = std::min(bx * 4 + i % 4, width - 1);
+					uint32_t y = std::min(by * 4 + i / 4, height - 1);
+					memcpy(texels + i * 4, pPixels + (static_cast<size_t>(y) * width + x) * 4, 4);
+				}
+				encode_block(texels, format, pDst + (static_cast<size_t>(by) * blocksX + bx) * blockSize);
+			}
+		}
+	};
+
+	// A few tasks per worker keeps them busy when some rows encode slower than others
+	uint32_t rowsPerTask = std::max(1u, blocksY / static_cast<uint32_t>(pool.size() * 4));
+	std::vector<std::future<void>> tasks;
+	for (uint32_t row = 0; row < blocksY; row += rowsPerTask)
+	{
+		uint32_t endRow = std::min(blocksY, row + rowsPerTask);
+		tasks.push_back(pool.submit([=]() { encode_rows(row, endRow); }));
+	}
+
+	for (auto& task : tasks)
+	{
+		task.wait();
+	}
+	for (auto& task : tasks)
+	{
+		task.get();
+	}
+}
+
+void BCEncoder::encode_png_to_ktx2(const std::string& pngPath, const std::string& ktx2Path, VkFormat format, ThreadPool& pool)
+{
+	if (!is_supported_format(format))
+	{
+		throw std::invalid_argument("Only BC1, BC3, BC5 and BC7 formats can be encoded");
+	}
+
+	PNGImage png(pngPath);
+	uint32_t width = png.width();
+	uint32_t height = png.height();
+	std::vector<uint8_t> pixels(png.size_in_bytes());
+	png.decode(pixels.data());
+
+	uint32_t levelCount = Image::full_mip_chain_length(width, height);
+	std::vector<std::vector<uint8_t>> levels(levelCount);
+	for (uint32_t level = 0; level < levelCount; ++level)
+	{
+		levels[level].resize(encoded_size(format, width, height));
+		encode(pixels.data(), width, height, format, levels[level].data(), pool);
+
+		if (level + 1 < levelCount)
+		{
+			std::vector<uint8_t> nextPixels(static_cast<size_t>(std::max(1u, width / 2)) * std::max(1u, height / 2) * 4);
+			PixelKernels::downsample(pixels.data(), width, height, 4, nextPixels.data(), is_srgb(format));
+
+			pixels = std::move(nextPixels);
+			width = std::max(1u, width / 2);
+			height = std::max(1u, height / 2);
+		}
+	}
+
+	KTX2Image::write(ktx2Path, format, png.width(), png.height(), levels);
+}
+
+
+
+
+
+/*
+* PRIVATE STATIC METHOD DEFINITIONS
+*/
+
+void BCEncoder::_encode_color_block(const uint8_t* pTexels, uint8_t* pDst)
+{
+	uint8_t low[4];
+	uint8_t high[4];
+	_find_endpoints(pTexels, 3, low, high);
+
+	uint16_t color0 = pack_565(high);
+	uint16_t color1 = pack_565(low);
+
+	// Four-color mode needs the first endpoint to compare greater
+	if (color0 < color1)
+	{
+		std::swap(color0, color1);
+	}
+
+	uint8_t palette[4 * 4];
+	unpack_565(color0, palette);
+	unpack_565(color1, palette + 4);
+	for (uint32_t c = 0; c < 4; ++c)
+	{
+		palette[8 + c] = static_cast<uint8_t>((2 * palette[c] + palette[4 + c] + 1) / 3);
+		palette[12 + c] = static_cast<uint8_t>((palette[c] + 2 * palette[4 + c] + 1) / 3);
+	}
+
+	uint8_t indices[TEXELS_PER_BLOCK] = {};
+	if (color0 != color1)
+	{
+		_nearest_indices(pTexels, palette, 4, false, indices);
+	}
+
+	uint32_t packedIndices = 0;
+	for (uint32_t i = 0; i < TEXELS_PER_BLOCK; ++i)
+	{
+		packedIndices |= static_cast<uint32_t>(indices[i]) << (i * 2);
+	}
+
+	memcpy(pDst, &color0, sizeof(color0));
+	memcpy(pDst + 2, &color1, sizeof(color1));
+	memcpy(pDst + 4, &packedIndices, sizeof(packedIndices));
+}
+
+void BCEncoder::_encode_channel_block(const uint8_t* pTexels, uint32_t channel, uint8_t* pDst)
+{
+	uint8_t minValue = 0xFF;
+	uint8_t maxValue = 0;
+	for (uint32_t i = 0; i < TEXELS_PER_BLOCK; ++i)
+	{
+		minValue = std::min(minValue, pTexels[i * 4 + channel]);
+		maxValue = std::max(maxValue, pTexels[i * 4 + channel]);
+	}
+
+	// With the first endpoint greater, index 0 and 1 are the endpoints and 2 to 7 step from the first to the second
+	int32_t palette[8] = { maxValue, minValue };
+	for (int32_t i = 1; i < 7; ++i)
+	{
+		palette[i + 1] = ((7 - i) * maxValue + i * minValue + 3) / 7;
+	}
+
+	uint64_t packedIndices = 0;
+	if (maxValue != minValue)
+	{
+		for (uint32_t i = 0; i < TEXELS_PER_BLOCK; ++i)
+		{
+			int32_t value = pTexels[i * 4 + channel];
+			uint32_t bestIndex = 0;
+			int32_t bestError = std::abs(value - palette[0]);
+			for (uint32_t p = 1; p < 8; ++p)
+			{
+				int32_t error = std::abs(value - palette[p]);
+				if (error < bestError)
+				{
+					bestError = error;
+					bestIndex = p;
+				}
+			}
+			packedIndices |= static_cast<uint64_t>(bestIndex) << (i * 3);
+		}
+	}
+
+	pDst[0] = maxValue;
+	pDst[1] = minValue;
+	for (uint32_t i = 0; i < 6; ++i)
+	{
+		pDst[2 + i] = static_cast<uint8_t>(packedIndices >> (i * 8));
+	}
+}
+
+void BCEncoder::_encode_bc7_block(const uint8_t* pTexels, uint8_t* pDst)
+{
+	uint8_t endpoints[2][4];
+	_find_endpoints(pTexels, 4, endpoints[0], endpoints[1]);
+
+	// Each endpoint is stored as 7 bits per channel plus a shared low bit, whichever low bit lands closer
+	uint8_t quantized[2][4];
+	uint32_t pBits[2];
+	for (uint32_t e = 0; e < 2; ++e)
+	{
+		uint32_t bestError = UINT32_MAX;
+		for (uint32_t p = 0; p < 2; ++p)
+		{
+			uint8_t candidate[4];
+			uint32_t error = 0;
+			for (uint32_t c = 0; c < 4; ++c)
+			{
+				int32_t q = std::clamp((static_cast<int32_t>(endpoints[e][c]) - static_cast<int32_t>(p) + 1) >> 1, 0, 127);
+				int32_t diff = ((q << 1) | static_cast<int32_t>(p)) - endpoints[e][c];
+				candidate[c] = static_cast<uint8_t>(q);
+				error += diff * diff;
+			}
+
+			if (error < bestError)
+			{
+				bestError = error;
+				pBits[e] = p;
+				memcpy(quantized[e], candidate, sizeof(candidate));
+			}
+		}
+	}
+
+	uint8_t palette[16 * 4];
+	for (uint32_t i = 0; i < 16; ++i)
+	{
+		for (uint32_t c = 0; c < 4; ++c)
+		{
+			uint32_t e0 = (quantized[0][c] << 1) | pBits[0];
+			uint32_t e1 = (quantized[1][c] << 1) | pBits[1];
+			palette[i * 4 + c] = static_cast<uint8_t>(((64 - BC7_WEIGHTS[i]) * e0 + BC7_WEIGHTS[i] * e1 + 32) >> 6);
+		}
+	}
+
+	uint8_t indices[TEXELS_PER_BLOCK];
+	_nearest_indices(pTexels, palette, 16, true, indices);
+
+	// The first index is stored without its high bit, so it has to point into the first half of the palette.
+	// The weights are symmetric, so swapping the endpoints and mirroring the indices keeps every color
+	if (indices[0] & 8)
+	{
+		std::swap(quantized[0], quantized[1]);
+		std::swap(pBits[0], pBits[1]);
+		for (auto& index : indices)
+		{
+			index = static_cast<uint8_t>(15 - index);
+		}
+	}
+
+	BlockWriter block;
+	block.put(1 << 6, 7);
+	for (uint32_t c = 0; c < 4; ++c)
+	{
+		block.put(quantized[0][c], 7);
+		block.put(quantized[1][c], 7);
+	}
+	block.put(pBits[0], 1);
+	block.put(pBits[1], 1);
+
+	block.put(indices[0], 3);
+	for (uint32_t i = 1; i < TEXELS_PER_BLOCK; ++i)
+	{
+		block.put(indices[i], 4);
+	}
+
+	block.store(pDst, 16);
+}
+
+void BCEncoder::_find_endpoints(const uint8_t* pTexels, uint32_t numChannels, uint8_t* pLow, uint8_t* pHigh)
+{
+	float mean[4] = {};
+	for (uint32_t i = 0; i < TEXELS_PER_BLOCK; ++i)
+	{
+		for (uint32_t c = 0; c < numChannels; ++c)
+		{
+			mean[c] += pTexels[i * 4 + c];
+		}
+	}
+	for (uint32_t c = 0; c < numChannels; ++c)
+	{
+		mean[c] /= TEXELS_PER_BLOCK;
+	}
+
+	float covariance[4][4] = {};
+	for (uint32_t i = 0; i < TEXELS_PER_BLOCK; ++i)
+	{
+		for (uint32_t a = 0; a < numChannels; ++a)
+		{
+			for (uint32_t b = a; b < numChannels; ++b)
+			{
+				covariance[a][b] += (pTexels[i * 4 + a] - mean[a]) * (pTexels[i * 4 + b] - mean[b]);
+			}
+		}
+	}
+	for (uint32_t a = 0; a < numChannels; ++a)
+	{
+		for (uint32_t b = 0; b < a; ++b)
+		{
+			covariance[a][b] = covariance[b][a];
+		}
+	}
+
+	// A few power iterations are enough to separate the dominant axis for endpoint selection
+	float axis[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	for (uint32_t iteration = 0; iteration < 8; ++iteration)
+	{
+		float next[4] = {};
+		float largest = 0.0f;
+		for (uint32_t a = 0; a < numChannels; ++a)
+		{
+			for (uint32_t b = 0; b < numChannels; ++b)
+			{
+				next[a] += covariance[a][b] * axis[b];
+			}
+			largest = std::max(largest, std::abs(next[a]));
+		}
+
+		if (largest == 0.0f)
+		{
+			break;
+		}
+
+		for (uint32_t c = 0; c < numChannels; ++c)
+		{
+			axis[c] = next[c] / largest;
+		}
+	}
+
+	uint32_t lowIndex = 0;
+	uint32_t highIndex = 0;
+	float lowProjection = INFINITY;
+	float highProjection = -INFINITY;
+	for (uint32_t i = 0; i < TEXELS_PER_BLOCK; ++i)
+	{
+		float projection = 0.0f;
+		for (uint32_t c = 0; c < numChannels; ++c)
+		{
+			projection += pTexels[i * 4 + c] * axis[c];
+		}
+
+		if (projection < lowProjection)
+		{
+			lowProjection = projection;
+			lowIndex = i;
+		}
+		if (projection > highProjection)
+		{
+			highProjection = projection;
+			highIndex = i;
+		}
+	}
+
+	memcpy(pLow, pTexels + lowIndex * 4, 4);
+	memcpy(pHigh, pTexels + highIndex * 4, 4);
+}
+
+void BCEncoder::_nearest_indices(const uint8_t* pTexels, const uint8_t* pPalette, uint32_t paletteSize, bool includeAlpha, uint8_t* pIndices)
+{
+	uint32_t channelMask = includeAlpha ? 0xFFFFFFFFu : 0x00FFFFFFu;
+
+#if defined(BC_ENCODER_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i mask = _mm_set1_epi32(static_cast<int32_t>(channelMask));
+	for (uint32_t group = 0; group < TEXELS_PER_BLOCK; group += 4)
+	{
+		// Four texels at a time, widened to 16 bits so differences can be squared and summed with madd
+		__m128i texels = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pTexels + group * 4)), mask);
+		__m128i texelsLow = _mm_unpacklo_epi8(texels, zero);
+		__m128i texelsHigh = _mm_unpackhi_epi8(texels, zero);
+
+		__m128i bestDistance = _mm_set1_epi32(INT32_MAX);
+		__m128i bestIndex = zero;
+		for (uint32_t p = 0; p < paletteSize; ++p)
+		{
+			uint32_t entry;
+			memcpy(&entry, pPalette + p * 4, sizeof(entry));
+			__m128i color = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int32_t>(entry & channelMask)), zero);
+
+			__m128i diffLow = _mm_sub_epi16(texelsLow, color);
+			__m128i diffHigh = _mm_sub_epi16(texelsHigh, color);
+			__m128i squaresLow = _mm_madd_epi16(diffLow, diffLow);
+			__m128i squaresHigh = _mm_madd_epi16(diffHigh, diffHigh);
+
+			// Each texel has its red and green sum in one lane and its blue and alpha sum in the next
+			__m128 evenLanes = _mm_shuffle_ps(_mm_castsi128_ps(squaresLow), _mm_castsi128_ps(squaresHigh), _MM_SHUFFLE(2, 0, 2, 0));
+			__m128 oddLanes = _mm_shuffle_ps(_mm_castsi128_ps(squaresLow), _mm_castsi128_ps(squaresHigh), _MM_SHUFFLE(3, 1, 3, 1));
+			__m128i distance = _mm_add_epi32(_mm_castps_si128(evenLanes), _mm_castps_si128(oddLanes));
+
+			__m128i isCloser = _mm_cmplt_epi32(distance, bestDistance);
+			bestDistance = _mm_or_si128(_mm_and_si128(isCloser, distance), _mm_andnot_si128(isCloser, bestDistance));
+			bestIndex = _mm_or_si128(_mm_and_si128(isCloser, _mm_set1_epi32(static_cast<int32_t>(p))), _mm_andnot_si128(isCloser, bestIndex));
+		}
+
+		uint32_t groupIndices[4];
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(groupIndices), bestIndex);
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			pIndices[group + i] = static_cast<uint8_t>(groupIndices[i]);
+		}
+	}
+#else
+	uint32_t numChannels = includeAlpha ? 4 : 3;
+	for (uint32_t i = 0; i < TEXELS_PER_BLOCK; ++i)
+	{
+		int32_t bestDistance = INT32_MAX;
+		for (uint32_t p = 0; p < paletteSize; ++p)
+		{
+			int32_t distance = 0;
+			for (uint32_t c = 0; c < numChannels; ++c)
+			{
+				int32_t diff = static_cast<int32_t>(pTexels[i * 4 + c]) - pPalette[p * 4 + c];
+				distance += diff * diff;
+			}
+
+			if (distance < bestDistance)
+			{
+				bestDistance = distance;
+				pIndices[i] = static_cast<uint8_t>(p);
+			}
+		}
+	}
+#endif
+}
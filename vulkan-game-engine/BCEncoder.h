@@ -0,0 +1,97 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "ThreadPool.h"
+
+/*
+* Class that compresses 8-bit RGBA images to BC1, BC3, BC5 and BC7 blocks offline
+*
+* Endpoints come from the principal axis of each block's colors and every texel takes the nearest palette entry.
+* BC7 only uses mode 6, a single subset with RGBA endpoints and 4-bit indices, which trades some quality on blocks
+* with several distinct colors for a much simpler and faster search. Palette searches use SSE2 on x86-64 builds.
+* Images are split into rows of blocks that are encoded in parallel on a thread pool.
+*/
+class BCEncoder
+{
+public:
+
+	/*
+	* PUBLIC STATIC METHODS
+	*/
+
+	/* @brief Returns the name of the instruction set the palette search was compiled for
+	*/
+	static const char* instruction_set();
+
+	/* @brief Checks if a format can be encoded
+	*/
+	static bool is_supported_format(VkFormat format);
+
+	/* @brief Returns the bytes per 4x4 block of a BC1, BC3, BC5 or BC7 format, or 0 for any other format
+	*/
+	static size_t block_size(VkFormat format);
+
+	/* @brief Returns the size of an image encoded in the given format in bytes
+	*/
+	static size_t encoded_size(VkFormat format, uint32_t width, uint32_t height);
+
+	/* @brief Compresses a single 4x4 block
+	*
+	* @param pTexels 16 RGBA texels in row order
+	* @param pDst Room for one block, 8 bytes for BC1 and 16 for the rest
+	* @throws std::invalid_argument if the format isn't supported
+	*/
+	static void encode_block(const uint8_t* pTexels, VkFormat format, uint8_t* pDst);
+
+	/* @brief Compresses an RGBA image. Partial blocks at the right and bottom edges repeat the last column and row
+	*
+	* @param pPixels Tightly packed RGBA rows
+	* @param pDst Room for `encoded_size(format, width, height)` bytes
+	*/
+	static void encode(const uint8_t* pPixels, uint32_t width, uint32_t height, VkFormat format, uint8_t* pDst, ThreadPool& pool);
+
+	/* @brief Decodes a PNG, builds its full mip chain, compresses every level and writes them to a KTX2 file
+	*
+	* Levels are downsampled in linear space for sRGB formats
+	*/
+	static void encode_png_to_ktx2(const std::string& pngPath, const std::string& ktx2Path, VkFormat format, ThreadPool& pool);
+
+private:
+
+	/*
+	* PRIVATE STATIC METHODS
+	*/
+
+	/* @brief Writes a BC1 color block using the RGB of the texels in four-color mode
+	*/
+	static void _encode_color_block(const uint8_t* pTexels, uint8_t* pDst);
+
+	/* @brief Writes a BC4 style block for one channel of the texels, as used for BC3 alpha and both BC5 channels
+	*/
+	static void _encode_channel_block(const uint8_t* pTexels, uint32_t channel, uint8_t* pDst);
+
+	/* @brief Writes a BC7 mode 6 block
+	*/
+	static void _encode_bc7_block(const uint8_t* pTexels, uint8_t* pDst);
+
+	/* @brief Finds the endpoints of a block along the principal axis of its colors
+	*
+	* @param numChannels 3 to ignore alpha, 4 to include it
+	* @param[out] pLow Texel with the lowest projection onto the axis
+	* @param[out] pHigh Texel with the highest projection onto the axis
+	*/
+	static void _find_endpoints(const uint8_t* pTexels, uint32_t numChannels, uint8_t* pLow, uint8_t* pHigh);
+
+	/* @brief Picks the nearest palette entry for each texel by squared distance
+	*
+	* @param pPalette `paletteSize` RGBA colors
+	* @param includeAlpha Whether alpha counts toward the distance
+	* @param[out] pIndices 16 palette indices
+	*/
+	static void _nearest_indices(const uint8_t* pTexels, const uint8_t* pPalette, uint32_t paletteSize, bool includeAlpha, uint8_t* pIndices);
+};
@@ -0,0 +1,229 @@
+#include "Benchmarks.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include <png++/png.hpp>
+
+#include "BCEncoder.h"
+#include "KTX2Image.h"
+#include "MeshKernels.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "MeshletBuilder.h"
+#include "ObjFile.h"
+#include "PNGImage.h"
+#include "PixelKernels.h"
+#include "ThreadPool.h"
+
+/*
+* PUBLIC STATIC METHOD DEFINITIONS
+*/
+
+int Benchmarks::run_obj_parser(const std::string& objPath, uint32_t numIterations)
+{
+	using Clock = std::chrono::steady_clock;
+
+	auto time_reads = [&](auto readFn) {
+		double bestMs = 0.0;
+		for (uint32_t i = 0; i < numIterations; ++i)
+		{
+			auto start = Clock::now();
+			readFn();
+			double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+			bestMs = (i == 0) ? ms : std::min(bestMs, ms);
+		}
+		return bestMs;
+	};
+
+	ObjFile native;
+	ObjFile reference;
+	double nativeMs = time_reads([&]() { native.read(objPath); });
+	double referenceMs = time_reads([&]() { reference.read_tinyobj(objPath); });
+
+	ObjFile::DedupStats dedupStats{};
+	Mesh nativeMesh = native.get_mesh(&dedupStats);
+	Mesh referenceMesh = reference.get_mesh();
+	bool identical = nativeMesh.vertices() == referenceMesh.vertices() && nativeMesh.indices() == referenceMesh.indices();
+
+	std::cout << "Parsed " << objPath << " (" << nativeMesh.vertices().size() << " vertices, "
+		<< nativeMesh.indices().size() << " indices), best of " << numIterations << std::endl;
+	std::cout << "Native: " << nativeMs << " ms" << std::endl;
+	std::cout << "tinyobj: " << referenceMs << " ms" << std::endl;
+	std::cout << "Speedup: " << referenceMs / nativeMs << "x" << std::endl;
+	std::cout << "Dedup (" << (dedupStats.usedSort ? "sort" : "hash") << "): "
+		<< dedupStats.cornerCount << " corners -> " << dedupStats.uniqueVertexCount << " vertices, "
+		<< dedupStats.ratio() * 100.0 << "% merged in " << dedupStats.milliseconds << " ms" << std::endl;
+	MeshOptimizer::Report optimizeReport{};
+	Mesh optimizedMesh = MeshOptimizer::optimize(nativeMesh, &optimizeReport);
+	std::cout << "Vertex cache ACMR " << optimizeReport.before.acmr << " -> " << optimizeReport.after.acmr
+		<< ", ATVR " << optimizeReport.before.atvr << " -> " << optimizeReport.after.atvr
+		<< " (" << optimizeReport.clusterCount << " clusters)" << std::endl;
+
+	auto lodStart = Clock::now();
+	auto lods = MeshSimplifier::build_lod_chain(nativeMesh);
+	double lodMs = std::chrono::duration<double, std::milli>(Clock::now() - lodStart).count();
+	std::cout << "LOD chain (" << lodMs << " ms):";
+	for (const auto& lod : lods)
+	{
+		std::cout << " " << lod.indices.size() / 3 << " tris @ " << lod.error;
+	}
+	std::cout << std::endl;
+
+	auto meshlets = MeshletBuilder::build(optimizedMesh);
+	size_t meshletVertices = 0;
+	size_t backfacing = 0;
+	glm::vec3 camera(0.0f, 0.0f, 1000.0f);
+	for (const auto& meshlet : meshlets)
+	{
+		meshletVertices += meshlet.vertexCount;
+		backfacing += MeshletBuilder::is_backfacing(meshlet, camera) ? 1 : 0;
+	}
+	std::cout << "Meshlets: " << meshlets.size() << ", avg " << optimizedMesh.indices().size() / 3.0 / std::max<size_t>(1, meshlets.size()) << " tris / "
+		<< meshletVertices / static_cast<double>(std::max<size_t>(1, meshlets.size())) << " verts, "
+		<< 100.0 * backfacing / std::max<size_t>(1, meshlets.size()) << "% backface culled from +z" << std::endl;
+	std::cout << "Meshes " << (identical ? "match" : "DIFFER") << std::endl;
+
+	return identical ? 0 : 1;
+}
+
+int Benchmarks::run_mesh_kernels(uint32_t numVertices)
+{
+	using Clock = std::chrono::steady_clock;
+
+	std::vector<Vertex> vertices;
+	vertices.reserve(numVertices);
+	for (uint32_t i = 0; i < numVertices; ++i)
+	{
+		float t = static_cast<float>(i) / numVertices;
+		vertices.emplace_back(std::array<float, 3>{ t, 1.0f - t, t * t }, std::array<float, 3>{ 1.0f, 1.0f, 1.0f }, std::array<float, 2>{ t, t });
+	}
+
+	auto report = [&](const char* name, auto fn) {
+		auto start = Clock::now();
+		fn();
+		double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		std::cout << name << ": " << ms << " ms, " << numVertices / (ms * 1000.0) << " Mverts/s" << std::endl;
+	};
+
+	std::cout << "Mesh kernels (" << MeshKernels::instruction_set() << ") on " << numVertices << " vertices" << std::endl;
+
+	report("Per-vertex rotate", [&]() {
+		for (auto& vertex : vertices)
+		{
+			vertex.rotate_x(90.0f);
+		}
+	});
+	report("Batch rotate", [&]() { MeshKernels::rotate_positions(vertices.data(), vertices.size(), 90.0f, glm::vec3(1, 0, 0)); });
+	report("Batch scale", [&]() { MeshKernels::scale_positions(vertices.data(), vertices.size(), 0.5f); });
+
+	glm::vec3 boundsMin;
+	glm::vec3 boundsMax;
+	report("Batch bounds", [&]() { MeshKernels::compute_bounds(vertices.data(), vertices.size(), boundsMin, boundsMax); });
+
+	return 0;
+}
+
+int Benchmarks::run_png_decode(const std::string& pngPath, uint32_t numIterations)
+{
+	using Clock = std::chrono::steady_clock;
+
+	auto time_best = [&](auto fn) {
+		double bestMs = 0.0;
+		for (uint32_t i = 0; i < numIterations; ++i)
+		{
+			auto start = Clock::now();
+			fn();
+			double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+			bestMs = (i == 0) ? ms : std::min(bestMs, ms);
+		}
+		return bestMs;
+	};
+	auto mb_per_s = [](size_t bytes, double ms) { return bytes / (ms * 1000.0); };
+
+	PNGImage header(pngPath);
+	size_t imageBytes = header.size_in_bytes();
+	std::vector<uint8_t> pixels(imageBytes);
+
+	double decodeMs = time_best([&]() { PNGImage(pngPath).decode(pixels.data()); });
+
+	std::vector<uint32_t> legacyPixels;
+	double legacyMs = time_best([&]() {
+		png::image<png::rgba_pixel> image(pngPath);
+		legacyPixels.clear();
+		for (size_t y = 0; y < image.get_height(); ++y)
+		{
+			const auto& row = image.get_pixbuf()[y];
+			std::transform(row.begin(), row.end(), std::back_inserter(legacyPixels), [](png::rgba_pixel pixel) {
+				return uint32_t(pixel.red) | uint32_t(pixel.green) << 8 | uint32_t(pixel.blue) << 16 | uint32_t(pixel.alpha) << 24;
+			});
+		}
+	});
+	bool identical = legacyPixels.size() * sizeof(uint32_t) == imageBytes && memcmp(legacyPixels.data(), pixels.data(), imageBytes) == 0;
+
+	std::cout << "Decoded " << pngPath << " (" << header.width() << "x" << header.height() << "), best of " << numIterations << std::endl;
+	std::cout << "Direct: " << decodeMs << " ms, " << mb_per_s(imageBytes, decodeMs) << " MB/s" << std::endl;
+	std::cout << "png++ and repack: " << legacyMs << " ms, " << mb_per_s(imageBytes, legacyMs) << " MB/s" << std::endl;
+	std::cout << "Pixels " << (identical ? "match" : "DIFFER") << std::endl;
+
+	// Kernels alone, over a buffer big enough to leave the caches
+	constexpr size_t KERNEL_PIXELS = 1 << 22;
+	std::vector<uint8_t> source(KERNEL_PIXELS * 8);
+	for (size_t i = 0; i < source.size(); ++i)
+	{
+		source[i] = static_cast<uint8_t>(i * 31);
+	}
+	std::vector<uint8_t> dest(KERNEL_PIXELS * 4);
+	std::vector<uint32_t> palette(256, 0xFF336699u);
+
+	std::cout << "Pixel kernels (" << PixelKernels::instruction_set() << "), MB/s of RGBA output:" << std::endl;
+	auto report = [&](const char* name, auto fn) {
+		std::cout << "  " << name << ": " << mb_per_s(dest.size(), time_best(fn)) << std::endl;
+	};
+	report("gray", [&]() { PixelKernels::gray_to_rgba(source.data(), dest.data(), KERNEL_PIXELS); });
+	report("gray+alpha", [&]() { PixelKernels::gray_alpha_to_rgba(source.data(), dest.data(), KERNEL_PIXELS); });
+	report("rgb", [&]() { PixelKernels::rgb_to_rgba(source.data(), dest.data(), KERNEL_PIXELS); });
+	report("palette", [&]() { PixelKernels::palette_to_rgba(source.data(), dest.data(), KERNEL_PIXELS, palette.data()); });
+	report("16-bit rgba", [&]() { PixelKernels::strip_16(source.data(), dest.data(), KERNEL_PIXELS * 4); });
+
+	return identical ? 0 : 1;
+}
+
+int Benchmarks::run_ktx2_encode(const std::string& pngPath, const std::string& ktx2Path, const std::string& formatName)
+{
+	const std::vector<std::pair<std::string, VkFormat>> formats = {
+		{ "bc1", VK_FORMAT_BC1_RGB_SRGB_BLOCK },
+		{ "bc3", VK_FORMAT_BC3_SRGB_BLOCK },
+		{ "bc5", VK_FORMAT_BC5_UNORM_BLOCK },
+		{ "bc7", VK_FORMAT_BC7_SRGB_BLOCK }
+	};
+
+	auto match = std::find_if(formats.begin(), formats.end(), [&](const auto& entry) { return entry.first == formatName; });
+	if (match == formats.end())
+	{
+		std::cerr << "Unknown block format " << formatName << ", expected bc1, bc3, bc5 or bc7" << std::endl;
+		return 1;
+	}
+
+	ThreadPool pool;
+	auto start = std::chrono::steady_clock::now();
+	BCEncoder::encode_png_to_ktx2(pngPath, ktx2Path, match->second, pool);
+	double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	KTX2Image encoded(ktx2Path);
+	size_t rgbaBytes = 0;
+	for (uint32_t level = 0; level < encoded.level_count(); ++level)
+	{
+		rgbaBytes += static_cast<size_t>(std::max(1u, encoded.width() >> level)) * std::max(1u, encoded.height() >> level) * 4;
+	}
+
+	std::cout << "Encoded " << pngPath << " (" << encoded.width() << "x" << encoded.height() << ", " << encoded.level_count() << " levels) as " << formatName
+		<< " in " << ms << " ms on " << pool.size() << " threads (" << BCEncoder::instruction_set() << ")" << std::endl;
+	std::cout << "Payload: " << encoded.size_in_bytes() << " bytes, " << static_cast<double>(rgbaBytes) / encoded.size_in_bytes() << "x smaller than RGBA8" << std::endl;
+	return 0;
+}
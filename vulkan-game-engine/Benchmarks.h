@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/*
+* Class of command line benchmarks and tools that run without a window or a Vulkan device
+*
+* Each one prints its results to stdout and returns the process exit code, non-zero when a check against the
+* reference implementation fails.
+*/
+class Benchmarks
+{
+public:
+
+	/*
+	* PUBLIC STATIC METHODS
+	*/
+
+	/* @brief Times the native OBJ parser against tinyobj and checks that both produce the same mesh
+	*
+	* @param objPath OBJ file to parse
+	* @param numIterations Number of times each parser reads the file
+	*/
+	static int run_obj_parser(const std::string& objPath, uint32_t numIterations);
+
+	/* @brief Measures the throughput of the batch mesh kernels against transforming one vertex at a time
+	*
+	* @param numVertices Number of vertices in the synthetic mesh
+	*/
+	static int run_mesh_kernels(uint32_t numVertices);
+
+	/* @brief Measures PNG decoding into caller memory against the old png++ decode and repack, and the throughput of each pixel kernel.
+	* Everything runs on the calling thread, so the rates are per core
+	*
+	* @param pngPath PNG file to decode
+	* @param numIterations Number of decodes, the fastest one is reported
+	*/
+	static int run_png_decode(const std::string& pngPath, uint32_t numIterations);
+
+	/* @brief Compresses a PNG and its mip chain into a KTX2 file and reports the size against uncompressed RGBA
+	*
+	* @param formatName One of bc1, bc3, bc5 or bc7. Color formats are sRGB, bc5 is linear for normal maps
+	*/
+	static int run_ktx2_encode(const std::string& pngPath, const std::string& ktx2Path, const std::string& formatName);
+};
@@ -10,7 +10,8 @@ Buffer::Buffer()
 	: VulkanObject(),
 	_usageFlags(0),
 	_memFlags(0),
-	_bufMem(VK_NULL_HANDLE),
+	_allocation({}),
+	_pAllocator(nullptr),
 	_bufSize(0),
 	_physicalDeviceHandle(VK_NULL_HANDLE)
 {
@@ -20,7 +21,8 @@ Buffer::Buffer(const Device& device, Buffer::Type bufferType, size_t bufferSize)
 	: VulkanObject(device.handle()),
 	_usageFlags(0),
 	_memFlags(0),
-	_bufMem(VK_NULL_HANDLE),
+	_allocation({}),
+	_pAllocator(device.allocator()),
 	_bufSize(bufferSize),
 	_physicalDeviceHandle(device.get_physical_device())
 {
@@ -42,6 +44,22 @@ Buffer::Buffer(const Device& device, Buffer::Type bufferType, size_t bufferSize)
 		_usageFlags = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
 		_memFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
 		break;
+	case Buffer::READBACK:
+		_usageFlags = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		_memFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+		break;
+	case Buffer::DYNAMIC:
+		_usageFlags = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+		_memFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+		break;
+	case Buffer::STORAGE:
+		_usageFlags = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+		_memFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+		break;
+	case Buffer::INDIRECT:
+		_usageFlags = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+		_memFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+		break;
 	}
 
 	_create_buffer(_usageFlags, _memFlags);
@@ -51,7 +69,8 @@ Buffer::Buffer(const Buffer& other)
 	: VulkanObject(other),
 	_usageFlags(other._usageFlags),
 	_memFlags(other._memFlags),
-	_bufMem(VK_NULL_HANDLE),
+	_allocation({}),
+	_pAllocator(other._pAllocator),
 	_bufSize(other._bufSize),
 	_physicalDeviceHandle(other._physicalDeviceHandle)
 {
@@ -75,9 +94,9 @@ Buffer::~Buffer()
 	if (_handle != VK_NULL_HANDLE)
 	{
 		vkDestroyBuffer(_deviceHandle, _handle, nullptr);
-		vkFreeMemory(_deviceHandle, _bufMem, nullptr);
+		_pAllocator->free(_allocation);
 		_handle = VK_NULL_HANDLE;
-		_bufMem = VK_NULL_HANDLE;
+		_allocation = {};
 	}
 }
 
@@ -97,6 +116,14 @@ void Buffer::copy_to_mapped_mem(const void* data)
 	unmap_memory();
 }
 
+void Buffer::copy_from_mapped_mem(void* data)
+{
+	void* mappedData;
+	map_memory(&mappedData);
+	memcpy(data, mappedData, (size_t)_bufSize);
+	unmap_memory();
+}
+
 void Buffer::copy_to(Buffer& destBuf, VkCommandPool commandPool, VkQueue graphicsQueue)
 {
 	CommandBufferPool commandBuffer(_deviceHandle, 1, commandPool);
@@ -107,13 +134,16 @@ void Buffer::copy_to(Buffer& destBuf, VkCommandPool commandPool, VkQueue graphic
 	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
 	commandBuffer.begin_all(beginInfo);
+	record_copy_to(cmdBufHandle, destBuf);
+	commandBuffer.end_all();
+	commandBuffer.submit_all_to_queue(graphicsQueue);
+}
 
+void Buffer::record_copy_to(VkCommandBuffer cmdBuffer, Buffer& destBuf)
+{
 	VkBufferCopy copyRegion{};
 	copyRegion.size = _bufSize;
-	vkCmdCopyBuffer(cmdBufHandle, _handle, destBuf._handle, 1, &copyRegion);
-
-	commandBuffer.end_all();
-	commandBuffer.submit_all_to_queue(graphicsQueue);
+	vkCmdCopyBuffer(cmdBuffer, _handle, destBuf._handle, 1, &copyRegion);
 }
 
 
@@ -137,15 +167,8 @@ void Buffer::_create_buffer(VkBufferUsageFlags usage, VkMemoryPropertyFlags memP
 	VkMemoryRequirements memRequirements;
 	vkGetBufferMemoryRequirements(_deviceHandle, _handle, &memRequirements);
 
-	VkMemoryAllocateInfo memAllocInfo{};
-	_configure_mem_alloc(&memAllocInfo, memRequirements, memPropFlags);
-
-	if (vkAllocateMemory(_deviceHandle, &memAllocInfo, nullptr, &_bufMem) != VK_SUCCESS)
-	{
-		throw std::runtime_error("Failed to allocate buffer memory");
-	}
-
-	vkBindBufferMemory(_deviceHandle, _handle, _bufMem, 0);
+	_allocation = _pAllocator->allocate(memRequirements, memPropFlags, true);
+	vkBindBufferMemory(_deviceHandle, _handle, _allocation.memory, _allocation.offset);
 }
 
 
@@ -163,12 +186,4 @@ void Buffer::_configure_buffer(VkBufferCreateInfo* pCreateInfo, VkBufferUsageFla
 	pCreateInfo->size = _bufSize;
 	pCreateInfo->usage = usage;
 	pCreateInfo->sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-}
-
-void Buffer::_configure_mem_alloc(VkMemoryAllocateInfo* pAllocInfo, VkMemoryRequirements memRequirements, VkMemoryPropertyFlags memPropFlags) const
-{
-	memset(pAllocInfo, 0, sizeof(VkMemoryAllocateInfo));
-	pAllocInfo->sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-	pAllocInfo->allocationSize = memRequirements.size;
-	pAllocInfo->memoryTypeIndex = Device::find_memory_type(_physicalDeviceHandle, memRequirements.memoryTypeBits, memPropFlags);
 }
\ No newline at end of file
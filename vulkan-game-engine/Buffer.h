@@ -24,6 +24,10 @@ public:
 		VERTEX,
 		INDEX,
 		UNIFORM,
+		READBACK,
+		DYNAMIC,
+		STORAGE,
+		INDIRECT,
 		NONE
 	};
 
@@ -42,7 +46,8 @@ public:
 		swap(bufA._handle, bufB._handle);
 		swap(bufA._usageFlags, bufB._usageFlags);
 		swap(bufA._memFlags, bufB._memFlags);
-		swap(bufA._bufMem, bufB._bufMem);
+		swap(bufA._allocation, bufB._allocation);
+		swap(bufA._pAllocator, bufB._pAllocator);
 		swap(bufA._bufSize, bufB._bufSize);
 		swap(bufA._deviceHandle, bufB._deviceHandle);
 		swap(bufA._physicalDeviceHandle, bufB._physicalDeviceHandle);
@@ -73,22 +78,40 @@ public:
 	* PUBLIC METHODS
 	*/
 
-	/* @brief Maps host data to GPU memory
+	/* @brief Returns a pointer to the buffer's memory. Host visible memory stays mapped for the lifetime of the buffer
 	*/
-	inline void map_memory(void** pData) { vkMapMemory(_deviceHandle, _bufMem, 0, _bufSize, 0, pData); }
+	inline void map_memory(void** pData) { *pData = _allocation.pMappedData; }
 
-	/* @brief Unmaps GPU memory
+	/* @brief Kept for symmetry with map_memory, the allocator unmaps memory when its block is freed
 	*/
-	inline void unmap_memory() { vkUnmapMemory(_deviceHandle, _bufMem); }
+	inline void unmap_memory() {}
 
 	/* @brief Copies the given data into mapped memory
 	*/
 	void copy_to_mapped_mem(const void* data);
 
-	/* @brief Copies data from this buffer to the given buffer
+	/* @brief Copies the contents of mapped memory into the given host pointer
+	*/
+	void copy_from_mapped_mem(void* data);
+
+	/* @brief Copies data from this buffer to the given buffer, waiting for the copy to finish
 	*/
 	void copy_to(Buffer& destBuf, VkCommandPool commandPool, VkQueue graphicsQueue);
 
+	/* @brief Records a copy of this buffer into the given buffer
+	*/
+	void record_copy_to(VkCommandBuffer cmdBuffer, Buffer& destBuf);
+
+
+
+	/*
+	* PUBLIC CONST METHODS
+	*/
+
+	/* @brief Returns the buffer size in bytes
+	*/
+	inline VkDeviceSize size() const { return _bufSize; }
+
 private:
 
 	/*
@@ -103,9 +126,13 @@ private:
 	*/
 	VkMemoryPropertyFlags _memFlags;
 
-	/* Handle to device memory
+	/* Range of device memory the buffer is bound to
 	*/
-	VkDeviceMemory _bufMem;
+	MemoryAllocator::Allocation _allocation;
+
+	/* Allocator that owns the buffer memory
+	*/
+	MemoryAllocator* _pAllocator;
 
 	/* Buffer size
 	*/
@@ -134,9 +161,5 @@ private:
 	/* @brief Fills struct with necessary info for creating a buffer
 	*/
 	void _configure_buffer(VkBufferCreateInfo* pCreateInfo, VkBufferUsageFlags usage) const;
-
-	/* @brief Fills struct with necessary info for allocating buffer memory
-	*/
-	void _configure_mem_alloc(VkMemoryAllocateInfo* pAllocInfo, VkMemoryRequirements memRequirements, VkMemoryPropertyFlags memPropFlags) const;
 };
 
@@ -108,6 +108,59 @@ void CommandBufferPool::submit_all_to_queue(VkQueue queue)
 	}
 }
 
+void CommandBufferPool::dispatch(size_t index, const ComputePipeline& pipeline, VkDescriptorSet descriptorSet, const std::vector<uint32_t>& dynamicOffsets, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
+{
+	auto cmdBuffer = _cmdBuffers[index];
+	vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline.handle());
+	vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline.layout_handle(), 0, 1, &descriptorSet, static_cast<uint32_t>(dynamicOffsets.size()), dynamicOffsets.data());
+	vkCmdDispatch(cmdBuffer, groupCountX, groupCountY, groupCountZ);
+}
+
+void CommandBufferPool::push_constants(size_t index, const ComputePipeline& pipeline, const void* pData, uint32_t size)
+{
+	if (size > pipeline.push_constant_size())
+	{
+		throw std::invalid_argument("Push constant data is larger than the pipeline's push constant block");
+	}
+
+	vkCmdPushConstants(_cmdBuffers[index], pipeline.layout_handle(), VK_SHADER_STAGE_COMPUTE_BIT, 0, size, pData);
+}
+
+void CommandBufferPool::buffer_barrier(size_t index, VkBuffer buffer, VkPipelineStageFlags srcStage, VkAccessFlags srcAccess, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+{
+	VkBufferMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	barrier.srcAccessMask = srcAccess;
+	barrier.dstAccessMask = dstAccess;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.buffer = buffer;
+	barrier.offset = 0;
+	barrier.size = VK_WHOLE_SIZE;
+
+	vkCmdPipelineBarrier(_cmdBuffers[index], srcStage, dstStage, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+}
+
+void CommandBufferPool::image_barrier(size_t index, VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout, VkPipelineStageFlags srcStage, VkAccessFlags srcAccess, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+{
+	VkImageMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.srcAccessMask = srcAccess;
+	barrier.dstAccessMask = dstAccess;
+	barrier.oldLayout = oldLayout;
+	barrier.newLayout = newLayout;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = image;
+	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	barrier.subresourceRange.baseMipLevel = 0;
+	barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+	barrier.subresourceRange.baseArrayLayer = 0;
+	barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+
+	vkCmdPipelineBarrier(_cmdBuffers[index], srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
 void CommandBufferPool::_configure_alloc_info(VkCommandBufferAllocateInfo* pAllocInfo) const
 {
 	memset(pAllocInfo, 0, sizeof(VkCommandBufferAllocateInfo));
@@ -5,6 +5,8 @@
 #include <algorithm>
 #include <vector>
 
+#include "ComputePipeline.h"
+
 class CommandBufferPool
 {
 public:
@@ -34,6 +36,15 @@ public:
 	void submit_one_to_queue(VkQueue queue, size_t index);
 	void submit_all_to_queue(VkQueue queue);
 
+	// Binds the pipeline and its descriptor set, then records a dispatch of x * y * z workgroups
+	void dispatch(size_t index, const ComputePipeline& pipeline, VkDescriptorSet descriptorSet, const std::vector<uint32_t>& dynamicOffsets, uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1);
+	void push_constants(size_t index, const ComputePipeline& pipeline, const void* pData, uint32_t size);
+
+	// Makes writes to a whole buffer in the source stages visible to the given accesses in the destination stages
+	void buffer_barrier(size_t index, VkBuffer buffer, VkPipelineStageFlags srcStage, VkAccessFlags srcAccess, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess);
+	// Same as buffer_barrier for every mip level of a color image, also moving it between layouts
+	void image_barrier(size_t index, VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout, VkPipelineStageFlags srcStage, VkAccessFlags srcAccess, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess);
+
 	inline VkCommandBuffer operator[](size_t index) { return _cmdBuffers[index]; }
 	inline VkCommandBuffer* buffers() { return _cmdBuffers.data(); }
 
@@ -115,6 +115,17 @@ void CommandPool::submit_to_queue(VkCommandBuffer* pCmdBuffer, VkQueue queue)
 	}
 }
 
+void CommandPool::submit_offscreen_to_queue(VkCommandBuffer* pCmdBuffer, VkQueue queue)
+{
+	VkSubmitInfo submitInfo{};
+	_configure_offscreen_submission(&submitInfo, pCmdBuffer);
+
+	if (vkQueueSubmit(queue, 1, &submitInfo, _inFlightFences[_currentFrameNum]) != VK_SUCCESS)
+	{
+		throw std::runtime_error("Failed to submit command buffer");
+	}
+}
+
 
 
 
@@ -155,4 +166,13 @@ void CommandPool::_configure_queue_submission(VkSubmitInfo* pCreateInfo, VkPipel
 
 	pCreateInfo->signalSemaphoreCount = 1;
 	pCreateInfo->pSignalSemaphores = &_renderFinishedSemaphores[_currentFrameNum];
+}
+
+void CommandPool::_configure_offscreen_submission(VkSubmitInfo* pCreateInfo, VkCommandBuffer* pCmdBuffer) const
+{
+	memset(pCreateInfo, 0, sizeof(VkSubmitInfo));
+	pCreateInfo->sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+
+	pCreateInfo->commandBufferCount = 1;
+	pCreateInfo->pCommandBuffers = pCmdBuffer;
 }
\ No newline at end of file
@@ -76,6 +76,11 @@ public:
 	*/
 	void submit_to_queue(VkCommandBuffer* pCmdBuffer, VkQueue queue);
 
+	/* @brief Submits command buffer for current frame without waiting on or signaling semaphores. 
+	* Used when rendering offscreen, where no swap chain image needs to be acquired or presented
+	*/
+	void submit_offscreen_to_queue(VkCommandBuffer* pCmdBuffer, VkQueue queue);
+
 	/* @brief Waits for the fences for the current frame
 	*/
 	inline void wait_for_fences() { vkWaitForFences(_deviceHandle, 1, &_inFlightFences[_currentFrameNum], VK_TRUE, UINT64_MAX); }
@@ -168,4 +173,8 @@ private:
 	*/
 	void _configure_queue_submission(VkSubmitInfo* pCreateInfo, VkPipelineStageFlags* pWaitStages, VkCommandBuffer* pCmdBuffer) const;
 
+	/* @brief Fills struct with necessary info for submitting a command to a queue without any semaphores
+	*/
+	void _configure_offscreen_submission(VkSubmitInfo* pCreateInfo, VkCommandBuffer* pCmdBuffer) const;
+
 };
\ No newline at end of file
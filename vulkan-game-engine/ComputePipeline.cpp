@@ -0,0 +1,120 @@
+#include "ComputePipeline.h"
+
+#include <stdexcept>
+#include <vector>
+
+/*
+* CTOR / ASSIGNMENT DEFINITIONS
+*/
+
+ComputePipeline::ComputePipeline()
+	: VulkanObject(),
+	_layout(VK_NULL_HANDLE),
+	_pushConstantSize(0)
+{
+}
+
+ComputePipeline::ComputePipeline(const Device& device, const Shader& shader, VkDescriptorSetLayout setLayout, uint32_t pushConstantSize)
+	: VulkanObject(device.handle()),
+	_layout(VK_NULL_HANDLE),
+	_pushConstantSize(pushConstantSize)
+{
+	if (shader.shader_type() != Shader::COMPUTE)
+	{
+		throw std::invalid_argument("Compute pipelines need a compute shader");
+	}
+
+	// Create pipeline layout
+	VkPushConstantRange pushConstants{};
+	pushConstants.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+	pushConstants.offset = 0;
+	pushConstants.size = pushConstantSize;
+
+	VkPipelineLayoutCreateInfo layoutInfo;
+	_configure_pipeline_layout(&layoutInfo, &setLayout, pushConstantSize > 0 ? &pushConstants : nullptr);
+
+	if (vkCreatePipelineLayout(_deviceHandle, &layoutInfo, nullptr, &_layout) != VK_SUCCESS)
+	{
+		throw std::runtime_error("Failed to create pipeline layout");
+	}
+
+	// Create pipeline
+	// The specialization info points into the entry and data vectors, which live until the pipeline is created
+	VkSpecializationInfo specialization{};
+	std::vector<VkSpecializationMapEntry> specEntries;
+	std::vector<uint32_t> specData;
+	shader.constants().configure_info(&specialization, specEntries, specData);
+
+	VkComputePipelineCreateInfo pipelineInfo{};
+	_configure_pipeline(&pipelineInfo, shader, shader.constants().empty() ? nullptr : &specialization);
+
+	try
+	{
+		_handle = device.pipeline_cache()->create_compute_pipeline(pipelineInfo);
+	}
+	catch (...)
+	{
+		vkDestroyPipelineLayout(_deviceHandle, _layout, nullptr);
+		throw;
+	}
+}
+
+ComputePipeline::ComputePipeline(const ComputePipeline& other)
+	: VulkanObject(other),
+	_layout(other._layout),
+	_pushConstantSize(other._pushConstantSize)
+{
+}
+
+ComputePipeline::ComputePipeline(ComputePipeline&& other) noexcept
+	: ComputePipeline()
+{
+	swap(*this, other);
+}
+
+ComputePipeline& ComputePipeline::operator=(ComputePipeline other)
+{
+	swap(*this, other);
+	return *this;
+}
+
+ComputePipeline::~ComputePipeline()
+{
+	if (_handle != VK_NULL_HANDLE)
+	{
+		vkDestroyPipeline(_deviceHandle, _handle, nullptr);
+		vkDestroyPipelineLayout(_deviceHandle, _layout, nullptr);
+	}
+}
+
+
+
+
+
+/*
+* PRIVATE CONST METHOD DEFINITIONS
+*/
+
+void ComputePipeline::_configure_pipeline_layout(VkPipelineLayoutCreateInfo* pCreateInfo, VkDescriptorSetLayout* pSetLayouts, const VkPushConstantRange* pPushConstants) const
+{
+	memset(pCreateInfo, 0, sizeof(VkPipelineLayoutCreateInfo));
+	pCreateInfo->sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pCreateInfo->setLayoutCount = 1;
+	pCreateInfo->pSetLayouts = pSetLayouts;
+	pCreateInfo->pushConstantRangeCount = pPushConstants != nullptr ? 1 : 0;
+	pCreateInfo->pPushConstantRanges = pPushConstants;
+}
+
+void ComputePipeline::_configure_pipeline(VkComputePipelineCreateInfo* pCreateInfo, const Shader& shader, const VkSpecializationInfo* pSpecialization) const
+{
+	memset(pCreateInfo, 0, sizeof(VkComputePipelineCreateInfo));
+	pCreateInfo->sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+	pCreateInfo->stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	pCreateInfo->stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+	pCreateInfo->stage.module = shader.handle();
+	pCreateInfo->stage.pName = "main";
+	pCreateInfo->stage.pSpecializationInfo = pSpecialization;
+	pCreateInfo->layout = _layout;
+	pCreateInfo->basePipelineHandle = VK_NULL_HANDLE;
+	pCreateInfo->basePipelineIndex = -1;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "VulkanObject.h"
+#include "Device.h"
+#include "Shader.h"
+
+/*
+* Class implementing a Vulkan compute pipeline
+*
+* The pipeline has its own layout: one descriptor set and an optional block of push constants visible to the compute stage.
+* It goes through the device's pipeline cache like the graphics pipelines do.
+*/
+class ComputePipeline : public VulkanObject<VkPipeline>
+{
+public:
+
+	/*
+	* PUBLIC STATIC METHODS
+	*/
+
+	/* @brief Returns the number of workgroups needed to cover every item, the last group may be partially used
+	*/
+	static inline uint32_t group_count(uint32_t itemCount, uint32_t groupSize) { return (itemCount + groupSize - 1) / groupSize; }
+
+
+
+	/*
+	* PUBLIC FRIEND METHODS
+	*/
+
+	/* @brief Swap implementation for ComputePipeline class
+	*/
+	friend void swap(ComputePipeline& pipelineA, ComputePipeline& pipelineB)
+	{
+		using std::swap;
+
+		swap(pipelineA._layout, pipelineB._layout);
+		swap(pipelineA._handle, pipelineB._handle);
+		swap(pipelineA._pushConstantSize, pipelineB._pushConstantSize);
+		swap(pipelineA._deviceHandle, pipelineB._deviceHandle);
+	}
+
+
+
+	/*
+	* CTORS / ASSIGNMENT
+	*/
+
+	ComputePipeline();
+
+	/*
+	* @param device Device being used
+	* @param shader Compute shader to run, its specialization constants are applied. It can be destroyed once the pipeline exists
+	* @param setLayout Layout of the single descriptor set bound with this pipeline
+	* @param pushConstantSize Size in bytes of the push constant block, 0 for none. Must be a multiple of 4
+	* @throws std::invalid_argument if the shader isn't a compute shader
+	*/
+	ComputePipeline(const Device& device, const Shader& shader, VkDescriptorSetLayout setLayout, uint32_t pushConstantSize = 0);
+	ComputePipeline(const ComputePipeline& other);
+	ComputePipeline(ComputePipeline&& other) noexcept;
+	ComputePipeline& operator=(ComputePipeline other);
+	~ComputePipeline();
+
+
+
+	/*
+	* PUBLIC CONST METHODS
+	*/
+
+	/* @brief Returns handle to pipeline layout object
+	*/
+	inline VkPipelineLayout layout_handle() const { return _layout; }
+
+	/* @brief Returns the size in bytes of the push constant block
+	*/
+	inline uint32_t push_constant_size() const { return _pushConstantSize; }
+
+private:
+
+	/*
+	* PRIVATE MEMBERS
+	*/
+
+	/* Handle to pipeline layout object
+	*/
+	VkPipelineLayout _layout;
+
+	/* Size in bytes of the push constant block
+	*/
+	uint32_t _pushConstantSize;
+
+
+
+	/*
+	* PRIVATE CONST METHODS
+	*/
+
+	/* @brief Fills struct with info necessary for creating the pipeline layout
+	*
+	* @param pPushConstants Range of the push constant block, or nullptr for none
+	*/
+	void _configure_pipeline_layout(VkPipelineLayoutCreateInfo* pCreateInfo, VkDescriptorSetLayout* pSetLayouts, const VkPushConstantRange* pPushConstants) const;
+
+	/* @brief Fills struct with info necessary for creating a pipeline
+	*
+	* @param pSpecialization Specialization constants of the shader, or nullptr for none
+	*/
+	void _configure_pipeline(VkComputePipelineCreateInfo* pCreateInfo, const Shader& shader, const VkSpecializationInfo* pSpecialization) const;
+};
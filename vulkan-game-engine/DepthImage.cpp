@@ -6,9 +6,14 @@ DepthImage::DepthImage()
 }
 
 DepthImage::DepthImage(const Device& device, const SwapChain& swapChain)
+    : DepthImage(device, swapChain.surface_extent())
+{
+}
+
+DepthImage::DepthImage(const Device& device, VkExtent2D extent)
 	: Image(device, {
-        swapChain.surface_extent().width,
-        swapChain.surface_extent().height,
+        extent.width,
+        extent.height,
         Device::select_supported_depth_format(device.get_physical_device(), SwapChain::available_depth_formats(), VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT),
         VK_IMAGE_TILING_OPTIMAL,
         VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
@@ -17,11 +22,6 @@ DepthImage::DepthImage(const Device& device, const SwapChain& swapChain)
 {
 }
 
-DepthImage::DepthImage(const DepthImage& other)
-    : Image(other)
-{
-}
-
 DepthImage::DepthImage(DepthImage&& other) noexcept
     : Image(std::move(other))
 {
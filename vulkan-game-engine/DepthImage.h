@@ -11,7 +11,8 @@ public:
 
 	DepthImage();
 	DepthImage(const Device& device, const SwapChain& swapChain);
-	DepthImage(const DepthImage& other);
+	DepthImage(const Device& device, VkExtent2D extent);
+	DepthImage(const DepthImage&) = delete;
 	DepthImage(DepthImage&& other) noexcept;
 	DepthImage& operator=(DepthImage other);
 	~DepthImage();
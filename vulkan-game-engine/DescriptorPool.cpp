@@ -3,6 +3,7 @@
 DescriptorPool::DescriptorPool()
 	: _poolSize(0),
 	_bindingTypes({}),
+	_stageFlags(0),
 	_layout(VK_NULL_HANDLE),
 	_descriptorPool(VK_NULL_HANDLE),
 	_descriptorSets({}),
@@ -10,9 +11,10 @@ DescriptorPool::DescriptorPool()
 {
 }
 
-DescriptorPool::DescriptorPool(const Device& device, size_t poolSize, const std::vector<BindingType>& bindings)
+DescriptorPool::DescriptorPool(const Device& device, size_t poolSize, const std::vector<BindingType>& bindings, VkShaderStageFlags stageFlags)
 	: _poolSize(poolSize),
 	_bindingTypes(bindings),
+	_stageFlags(stageFlags),
 	_layout(VK_NULL_HANDLE),
 	_descriptorPool(VK_NULL_HANDLE),
 	_descriptorSets(poolSize),
@@ -21,8 +23,10 @@ DescriptorPool::DescriptorPool(const Device& device, size_t poolSize, const std:
 	// Configure bindings
 	std::vector<VkDescriptorSetLayoutBinding> layoutBindings;
 	std::vector<VkDescriptorPoolSize> poolSizes;
-	for (auto bindingType : bindings)
+	for (size_t i = 0; i < bindings.size(); ++i)
 	{
+		auto bindingType = bindings[i];
+		auto bindingIndex = static_cast<uint32_t>(i);
 		VkDescriptorSetLayoutBinding binding{};
 		VkDescriptorPoolSize poolSizeInfo{};
 
@@ -30,18 +34,41 @@ DescriptorPool::DescriptorPool(const Device& device, size_t poolSize, const std:
 		{
 		case DescriptorPool::UBO:
 		{
-			_configure_ubo_binding(&binding);
+			_configure_ubo_binding(&binding, bindingIndex, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
 			poolSizeInfo.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
 			poolSizeInfo.descriptorCount = static_cast<uint32_t>(_poolSize);
 		}
 		break;
+		case DescriptorPool::UBO_DYNAMIC:
+		{
+			_configure_ubo_binding(&binding, bindingIndex, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC);
+			poolSizeInfo.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+			poolSizeInfo.descriptorCount = static_cast<uint32_t>(_poolSize);
+		}
+		break;
 		case DescriptorPool::TEXTURE_SAMPLER:
 		{
-			_configure_texture_sampler_binding(&binding);
+			_configure_texture_sampler_binding(&binding, bindingIndex);
 			poolSizeInfo.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
 			poolSizeInfo.descriptorCount = static_cast<uint32_t>(_poolSize);
 		}
 		break;
+		case DescriptorPool::STORAGE_BUFFER:
+		{
+			_configure_storage_binding(&binding, bindingIndex, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+			poolSizeInfo.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			poolSizeInfo.descriptorCount = static_cast<uint32_t>(_poolSize);
+		}
+		break;
+		case DescriptorPool::STORAGE_IMAGE:
+		{
+			_configure_storage_binding(&binding, bindingIndex, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+			poolSizeInfo.type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+			poolSizeInfo.descriptorCount = static_cast<uint32_t>(_poolSize);
+		}
+		break;
+		default:
+			throw std::invalid_argument("Unsupported descriptor binding type");
 		}
 
 		layoutBindings.push_back(binding);
@@ -78,6 +105,7 @@ DescriptorPool::DescriptorPool(const Device& device, size_t poolSize, const std:
 DescriptorPool::DescriptorPool(const DescriptorPool& other)
 	: _poolSize(other._poolSize),
 	_bindingTypes(other._bindingTypes),
+	_stageFlags(other._stageFlags),
 	_layout(other._layout),
 	_descriptorPool(other._descriptorPool),
 	_descriptorSets(other._descriptorSets),
@@ -123,24 +151,41 @@ void DescriptorPool::write_descriptor_set(const std::vector<std::vector<Descript
 			throw std::runtime_error("Length of descriptor data does not match the number of binding types");
 		}
 
+		// Write sets point at these until the update, so they have to outlive the loop below
+		std::vector<VkDescriptorBufferInfo> bufferInfos(_bindingTypes.size());
+		std::vector<VkDescriptorImageInfo> imageInfos(_bindingTypes.size());
 		std::vector<VkWriteDescriptorSet> writeSets;
 		for (size_t i = 0; i < _bindingTypes.size(); ++i)
 		{
 			auto bindingType = _bindingTypes[i];
 			auto descriptorData = bindingsData[i];
+			auto bindingIndex = static_cast<uint32_t>(i);
 
 			switch (bindingType)
 			{
 			case DescriptorPool::UBO:
 			{
-				VkDescriptorBufferInfo uboInfo{};
-				writeSets.push_back(_create_ubo_write_set(&uboInfo, descriptorData.uniformBuffer, descriptorData.uboSize, _descriptorSets[pool]));
+				writeSets.push_back(_create_ubo_write_set(&bufferInfos[i], descriptorData.uniformBuffer, descriptorData.uboSize, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, _descriptorSets[pool], bindingIndex));
+			}
+			break;
+			case DescriptorPool::UBO_DYNAMIC:
+			{
+				writeSets.push_back(_create_ubo_write_set(&bufferInfos[i], descriptorData.uniformBuffer, descriptorData.uboSize, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, _descriptorSets[pool], bindingIndex));
 			}
 			break;
 			case DescriptorPool::TEXTURE_SAMPLER:
 			{
-				VkDescriptorImageInfo samplerInfo{};
-				writeSets.push_back(_create_texture_sampler_write_set(&samplerInfo, descriptorData.textureSampler, descriptorData.textureImageView, _descriptorSets[pool]));
+				writeSets.push_back(_create_texture_sampler_write_set(&imageInfos[i], descriptorData.textureSampler, descriptorData.textureImageView, _descriptorSets[pool], bindingIndex));
+			}
+			break;
+			case DescriptorPool::STORAGE_BUFFER:
+			{
+				writeSets.push_back(_create_storage_buffer_write_set(&bufferInfos[i], descriptorData.storageBuffer, descriptorData.storageSize, _descriptorSets[pool], bindingIndex));
+			}
+			break;
+			case DescriptorPool::STORAGE_IMAGE:
+			{
+				writeSets.push_back(_create_storage_image_write_set(&imageInfos[i], descriptorData.storageImageView, _descriptorSets[pool], bindingIndex));
 			}
 			break;
 			}
@@ -150,24 +195,34 @@ void DescriptorPool::write_descriptor_set(const std::vector<std::vector<Descript
 	}
 }
 
-void DescriptorPool::_configure_ubo_binding(VkDescriptorSetLayoutBinding* pBinding) const
+void DescriptorPool::_configure_ubo_binding(VkDescriptorSetLayoutBinding* pBinding, uint32_t bindingIndex, VkDescriptorType descriptorType) const
 {
 	memset(pBinding, 0, sizeof(VkDescriptorSetLayoutBinding));
-	pBinding->binding = 0;
+	pBinding->binding = bindingIndex;
 	pBinding->descriptorCount = 1;
-	pBinding->descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	pBinding->descriptorType = descriptorType;
 	pBinding->pImmutableSamplers = nullptr;
-	pBinding->stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+	pBinding->stageFlags = _stageFlags != 0 ? _stageFlags : VK_SHADER_STAGE_VERTEX_BIT;
 }
 
-void DescriptorPool::_configure_texture_sampler_binding(VkDescriptorSetLayoutBinding* pBinding) const
+void DescriptorPool::_configure_texture_sampler_binding(VkDescriptorSetLayoutBinding* pBinding, uint32_t bindingIndex) const
 {
 	memset(pBinding, 0, sizeof(VkDescriptorSetLayoutBinding));
-	pBinding->binding = 1;
+	pBinding->binding = bindingIndex;
 	pBinding->descriptorCount = 1;
 	pBinding->descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
 	pBinding->pImmutableSamplers = nullptr;
-	pBinding->stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+	pBinding->stageFlags = _stageFlags != 0 ? _stageFlags : VK_SHADER_STAGE_FRAGMENT_BIT;
+}
+
+void DescriptorPool::_configure_storage_binding(VkDescriptorSetLayoutBinding* pBinding, uint32_t bindingIndex, VkDescriptorType descriptorType) const
+{
+	memset(pBinding, 0, sizeof(VkDescriptorSetLayoutBinding));
+	pBinding->binding = bindingIndex;
+	pBinding->descriptorCount = 1;
+	pBinding->descriptorType = descriptorType;
+	pBinding->pImmutableSamplers = nullptr;
+	pBinding->stageFlags = _stageFlags != 0 ? _stageFlags : VK_SHADER_STAGE_COMPUTE_BIT;
 }
 
 void DescriptorPool::_configure_descriptor_set_layout(VkDescriptorSetLayoutCreateInfo* pCreateInfo, const std::vector<VkDescriptorSetLayoutBinding>& bindings) const
@@ -196,7 +251,7 @@ void DescriptorPool::_configure_descriptor_set_alloc(VkDescriptorSetAllocateInfo
 	pAllocInfo->pSetLayouts = setLayouts.data();
 }
 
-VkWriteDescriptorSet DescriptorPool::_create_ubo_write_set(VkDescriptorBufferInfo* pBufInfo, VkBuffer uniformBuffer, size_t uboSize, VkDescriptorSet descriptorSet) const
+VkWriteDescriptorSet DescriptorPool::_create_ubo_write_set(VkDescriptorBufferInfo* pBufInfo, VkBuffer uniformBuffer, size_t uboSize, VkDescriptorType descriptorType, VkDescriptorSet descriptorSet, uint32_t bindingIndex) const
 {
 	memset(pBufInfo, 0, sizeof(VkDescriptorBufferInfo));
 	pBufInfo->buffer = uniformBuffer;
@@ -206,16 +261,16 @@ VkWriteDescriptorSet DescriptorPool::_create_ubo_write_set(VkDescriptorBufferInf
 	VkWriteDescriptorSet uboDescriptorSet{};
 	uboDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
 	uboDescriptorSet.dstSet = descriptorSet;
-	uboDescriptorSet.dstBinding = 0;
+	uboDescriptorSet.dstBinding = bindingIndex;
 	uboDescriptorSet.dstArrayElement = 0;
-	uboDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	uboDescriptorSet.descriptorType = descriptorType;
 	uboDescriptorSet.descriptorCount = 1;
 	uboDescriptorSet.pBufferInfo = pBufInfo;
 
 	return uboDescriptorSet;
 }
 
-VkWriteDescriptorSet DescriptorPool::_create_texture_sampler_write_set(VkDescriptorImageInfo* pImageInfo, VkSampler textureSampler, VkImageView imageView, VkDescriptorSet descriptorSet) const
+VkWriteDescriptorSet DescriptorPool::_create_texture_sampler_write_set(VkDescriptorImageInfo* pImageInfo, VkSampler textureSampler, VkImageView imageView, VkDescriptorSet descriptorSet, uint32_t bindingIndex) const
 {
 	memset(pImageInfo, 0, sizeof(VkDescriptorImageInfo));
 	pImageInfo->imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
@@ -225,11 +280,50 @@ VkWriteDescriptorSet DescriptorPool::_create_texture_sampler_write_set(VkDescrip
 	VkWriteDescriptorSet samplerDescriptorSet{};
 	samplerDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
 	samplerDescriptorSet.dstSet = descriptorSet;
-	samplerDescriptorSet.dstBinding = 1;
+	samplerDescriptorSet.dstBinding = bindingIndex;
 	samplerDescriptorSet.dstArrayElement = 0;
 	samplerDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
 	samplerDescriptorSet.descriptorCount = 1;
 	samplerDescriptorSet.pImageInfo = pImageInfo;
 
 	return samplerDescriptorSet;
+}
+
+VkWriteDescriptorSet DescriptorPool::_create_storage_buffer_write_set(VkDescriptorBufferInfo* pBufInfo, VkBuffer storageBuffer, VkDeviceSize storageSize, VkDescriptorSet descriptorSet, uint32_t bindingIndex) const
+{
+	memset(pBufInfo, 0, sizeof(VkDescriptorBufferInfo));
+	pBufInfo->buffer = storageBuffer;
+	pBufInfo->offset = 0;
+	pBufInfo->range = storageSize;
+
+	VkWriteDescriptorSet storageDescriptorSet{};
+	storageDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	storageDescriptorSet.dstSet = descriptorSet;
+	storageDescriptorSet.dstBinding = bindingIndex;
+	storageDescriptorSet.dstArrayElement = 0;
+	storageDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	storageDescriptorSet.descriptorCount = 1;
+	storageDescriptorSet.pBufferInfo = pBufInfo;
+
+	return storageDescriptorSet;
+}
+
+VkWriteDescriptorSet DescriptorPool::_create_storage_image_write_set(VkDescriptorImageInfo* pImageInfo, VkImageView imageView, VkDescriptorSet descriptorSet, uint32_t bindingIndex) const
+{
+	// Storage images are read and written in the general layout
+	memset(pImageInfo, 0, sizeof(VkDescriptorImageInfo));
+	pImageInfo->imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+	pImageInfo->imageView = imageView;
+	pImageInfo->sampler = VK_NULL_HANDLE;
+
+	VkWriteDescriptorSet storageDescriptorSet{};
+	storageDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	storageDescriptorSet.dstSet = descriptorSet;
+	storageDescriptorSet.dstBinding = bindingIndex;
+	storageDescriptorSet.dstArrayElement = 0;
+	storageDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+	storageDescriptorSet.descriptorCount = 1;
+	storageDescriptorSet.pImageInfo = pImageInfo;
+
+	return storageDescriptorSet;
 }
\ No newline at end of file
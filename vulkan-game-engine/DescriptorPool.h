@@ -12,7 +12,10 @@ public:
 	enum BindingType
 	{
 		UBO,
+		UBO_DYNAMIC,
 		TEXTURE_SAMPLER,
+		STORAGE_BUFFER,
+		STORAGE_IMAGE,
 		NONE,
 	};
 
@@ -26,7 +29,14 @@ public:
 			VkSampler textureSampler;
 			VkImageView textureImageView;
 		};
-		
+		struct {
+			VkBuffer storageBuffer;
+			VkDeviceSize storageSize;
+		};
+		struct {
+			VkImageView storageImageView;
+		};
+
 	};
 
 	friend void swap(DescriptorPool& setA, DescriptorPool& setB)
@@ -35,6 +45,7 @@ public:
 
 		swap(setA._poolSize, setB._poolSize);
 		swap(setA._bindingTypes, setB._bindingTypes);
+		swap(setA._stageFlags, setB._stageFlags);
 		swap(setA._layout, setB._layout);
 		swap(setA._descriptorPool, setB._descriptorPool);
 		swap(setA._descriptorSets, setB._descriptorSets);
@@ -42,7 +53,9 @@ public:
 	}
 
 	DescriptorPool();
-	DescriptorPool(const Device& device, size_t poolSize, const std::vector<BindingType>& bindings);
+	// Bindings are numbered in the order given. Stage flags of 0 give uniforms to the vertex stage, samplers to the
+	// fragment stage and storage bindings to the compute stage
+	DescriptorPool(const Device& device, size_t poolSize, const std::vector<BindingType>& bindings, VkShaderStageFlags stageFlags = 0);
 	DescriptorPool(const DescriptorPool& other);
 	DescriptorPool(DescriptorPool&& other) noexcept;
 	DescriptorPool& operator=(DescriptorPool other);
@@ -58,17 +71,21 @@ private:
 
 	size_t _poolSize;
 	std::vector<BindingType> _bindingTypes;
+	VkShaderStageFlags _stageFlags;
 	VkDescriptorSetLayout _layout;
 	VkDescriptorPool _descriptorPool;
 	std::vector<VkDescriptorSet> _descriptorSets;
 	VkDevice _deviceHandle;
 
-	void _configure_ubo_binding(VkDescriptorSetLayoutBinding* pBinding) const;
-	void _configure_texture_sampler_binding(VkDescriptorSetLayoutBinding* pBinding) const;
+	void _configure_ubo_binding(VkDescriptorSetLayoutBinding* pBinding, uint32_t bindingIndex, VkDescriptorType descriptorType) const;
+	void _configure_texture_sampler_binding(VkDescriptorSetLayoutBinding* pBinding, uint32_t bindingIndex) const;
+	void _configure_storage_binding(VkDescriptorSetLayoutBinding* pBinding, uint32_t bindingIndex, VkDescriptorType descriptorType) const;
 	void _configure_descriptor_set_layout(VkDescriptorSetLayoutCreateInfo* pCreateInfo, const std::vector<VkDescriptorSetLayoutBinding>& bindings) const;
 	void _configure_descriptor_pool(VkDescriptorPoolCreateInfo* pCreateInfo, const std::vector<VkDescriptorPoolSize>& poolSizes) const;
 	void _configure_descriptor_set_alloc(VkDescriptorSetAllocateInfo* pAllocInfo, const std::vector<VkDescriptorSetLayout>& setLayouts) const;
-	VkWriteDescriptorSet _create_ubo_write_set(VkDescriptorBufferInfo* pBufInfo, VkBuffer uniformBuffer, size_t uboSize, VkDescriptorSet descriptorSet) const;
-	VkWriteDescriptorSet _create_texture_sampler_write_set(VkDescriptorImageInfo* pImageInfo, VkSampler textureSampler, VkImageView imageView, VkDescriptorSet descriptorSet) const;
+	VkWriteDescriptorSet _create_ubo_write_set(VkDescriptorBufferInfo* pBufInfo, VkBuffer uniformBuffer, size_t uboSize, VkDescriptorType descriptorType, VkDescriptorSet descriptorSet, uint32_t bindingIndex) const;
+	VkWriteDescriptorSet _create_texture_sampler_write_set(VkDescriptorImageInfo* pImageInfo, VkSampler textureSampler, VkImageView imageView, VkDescriptorSet descriptorSet, uint32_t bindingIndex) const;
+	VkWriteDescriptorSet _create_storage_buffer_write_set(VkDescriptorBufferInfo* pBufInfo, VkBuffer storageBuffer, VkDeviceSize storageSize, VkDescriptorSet descriptorSet, uint32_t bindingIndex) const;
+	VkWriteDescriptorSet _create_storage_image_write_set(VkDescriptorImageInfo* pImageInfo, VkImageView imageView, VkDescriptorSet descriptorSet, uint32_t bindingIndex) const;
 };
 
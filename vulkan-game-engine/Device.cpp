@@ -1,4 +1,5 @@
 #include "Device.h"
+#include <cstring>
 #include <stdexcept>
 
 /*
@@ -54,29 +55,59 @@ Device::Device()
     : _logicalDevice(VK_NULL_HANDLE),
     _physicalDevice(VK_NULL_HANDLE),
     _physicalProps({}),
+    _enabledFeatures({}),
     _queueFamilyInfo({}),
-    _extensions({})
+    _extensions({}),
+    _allocator(nullptr),
+    _pipelineCache(nullptr),
+    _shaderModules(nullptr)
 {
 }
 
 Device::Device(VkPhysicalDevice physicalDevice, const QueueFamilyInfo& queueFamilyInfo, const std::vector<const char*>& deviceExtensions, const std::vector<const char*>& validationLayers)
 	: _logicalDevice(VK_NULL_HANDLE),
     _physicalDevice(physicalDevice),
+    _enabledFeatures({}),
 	_queueFamilyInfo(queueFamilyInfo),
-    _extensions(deviceExtensions)
+    _extensions(deviceExtensions),
+    _allocator(nullptr),
+    _pipelineCache(nullptr),
+    _shaderModules(nullptr)
 {
+    VkPhysicalDeviceFeatures availableFeatures;
+    vkGetPhysicalDeviceFeatures(physicalDevice, &availableFeatures);
+
+    // Creation feedback is optional, it only lets the pipeline cache tell hits from misses
+    uint32_t extensionCount = 0;
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
+    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, availableExtensions.data());
+
+    bool hasCreationFeedback = std::any_of(availableExtensions.begin(), availableExtensions.end(), [](const VkExtensionProperties& ext) {
+        return strcmp(ext.extensionName, VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME) == 0;
+    });
+    if (hasCreationFeedback)
+    {
+        _extensions.push_back(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+    }
+
     VkDeviceCreateInfo createInfo{};
-    VkPhysicalDeviceFeatures deviceFeatures{};
-    deviceFeatures.samplerAnisotropy = true;
+    _enabledFeatures.samplerAnisotropy = true;
+    _enabledFeatures.textureCompressionBC = availableFeatures.textureCompressionBC;
+    // Culled draws are issued as one indirect draw per meshlet, which needs more than one draw per call
+    _enabledFeatures.multiDrawIndirect = availableFeatures.multiDrawIndirect;
 
     std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-    _configure_logical_device(&createInfo, &deviceFeatures, queueCreateInfos, validationLayers);
+    _configure_logical_device(&createInfo, &_enabledFeatures, queueCreateInfos, validationLayers);
 
     if (vkCreateDevice(physicalDevice, &createInfo, nullptr, &_logicalDevice) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create logical device");
     }
 
     vkGetPhysicalDeviceProperties(physicalDevice, &_physicalProps);
+    _allocator = std::make_shared<MemoryAllocator>(_logicalDevice, physicalDevice);
+    _pipelineCache = std::make_shared<PipelineCache>(_logicalDevice, _physicalProps, _PIPELINE_CACHE_FILE, hasCreationFeedback);
+    _shaderModules = std::make_shared<ShaderModuleCache>(_logicalDevice);
 
     _queueFamilyInfo.load_handles(_logicalDevice);
 }
@@ -85,7 +116,12 @@ Device::Device(const Device& other)
     : _logicalDevice(other._logicalDevice), 
     _physicalDevice(other._physicalDevice), 
     _physicalProps(other._physicalProps),
-    _queueFamilyInfo(other._queueFamilyInfo)
+    _enabledFeatures(other._enabledFeatures),
+    _queueFamilyInfo(other._queueFamilyInfo),
+    _extensions(other._extensions),
+    _allocator(other._allocator),
+    _pipelineCache(other._pipelineCache),
+    _shaderModules(other._shaderModules)
 {
 }
 
@@ -103,7 +139,36 @@ Device& Device::operator=(Device other)
 
 Device::~Device()
 {
-    vkDestroyDevice(_logicalDevice, nullptr);
+    // Copies share the logical device, only the last one destroys it
+    if (_allocator != nullptr && _allocator.use_count() == 1)
+    {
+        _shaderModules.reset();
+        _pipelineCache.reset();
+        _allocator.reset();
+        vkDestroyDevice(_logicalDevice, nullptr);
+    }
+}
+
+
+
+
+
+/*
+* PUBLIC CONST METHOD DEFINITIONS
+*/
+
+bool Device::supports_format(VkFormat format, VkFormatFeatureFlags featureFlags, VkImageTiling tilingType) const
+{
+    if (format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && format <= VK_FORMAT_BC7_SRGB_BLOCK && !_enabledFeatures.textureCompressionBC)
+    {
+        return false;
+    }
+
+    VkFormatProperties props;
+    vkGetPhysicalDeviceFormatProperties(_physicalDevice, format, &props);
+
+    VkFormatFeatureFlags available = (tilingType == VK_IMAGE_TILING_LINEAR) ? props.linearTilingFeatures : props.optimalTilingFeatures;
+    return (available & featureFlags) == featureFlags;
 }
 
 
@@ -2,8 +2,12 @@
 
 #include <vulkan/vulkan.h>
 #include <algorithm>
+#include <memory>
 
 #include "QueueFamily.h"
+#include "MemoryAllocator.h"
+#include "PipelineCache.h"
+#include "ShaderModuleCache.h"
 
 /*
 * Class describing physical and logical devices and related queue families
@@ -34,7 +38,12 @@ public:
 		swap(deviceA._logicalDevice, deviceB._logicalDevice);
 		swap(deviceA._physicalDevice, deviceB._physicalDevice);
 		swap(deviceA._physicalProps, deviceB._physicalProps);
+		swap(deviceA._enabledFeatures, deviceB._enabledFeatures);
 		swap(deviceA._queueFamilyInfo, deviceB._queueFamilyInfo);
+		swap(deviceA._extensions, deviceB._extensions);
+		swap(deviceA._allocator, deviceB._allocator);
+		swap(deviceA._pipelineCache, deviceB._pipelineCache);
+		swap(deviceA._shaderModules, deviceB._shaderModules);
 	}
 
 	/*
@@ -91,6 +100,28 @@ public:
 	*/
 	inline VkPhysicalDeviceProperties physical_properties() const { return _physicalProps; }
 
+	/* @brief Returns the allocator that buffers and images get their memory from
+	*/
+	inline MemoryAllocator* allocator() const { return _allocator.get(); }
+
+	/* @brief Returns the pipeline cache that pipelines are created through
+	*/
+	inline PipelineCache* pipeline_cache() const { return _pipelineCache.get(); }
+
+	/* @brief Returns the cache that shader modules are created through
+	*/
+	inline ShaderModuleCache* shader_modules() const { return _shaderModules.get(); }
+
+	/* @brief Returns the features the logical device was created with
+	*/
+	inline const VkPhysicalDeviceFeatures& enabled_features() const { return _enabledFeatures; }
+
+	/* @brief Checks if images of a format can be used for the given features
+	*
+	* Block-compressed formats also need their compression feature to have been enabled, which happens whenever the device supports it
+	*/
+	bool supports_format(VkFormat format, VkFormatFeatureFlags featureFlags, VkImageTiling tilingType = VK_IMAGE_TILING_OPTIMAL) const;
+
 private:
 
 	/*
@@ -109,6 +140,10 @@ private:
 	*/
 	VkPhysicalDeviceProperties _physicalProps;
 
+	/* Features enabled on the logical device
+	*/
+	VkPhysicalDeviceFeatures _enabledFeatures;
+
 	/* Queue family info for device
 	*/
 	QueueFamilyInfo _queueFamilyInfo;
@@ -117,6 +152,28 @@ private:
 	*/
 	std::vector<const char*> _extensions;
 
+	/* Device memory allocator, shared between copies of the device
+	*/
+	std::shared_ptr<MemoryAllocator> _allocator;
+
+	/* Pipeline cache persisted to disk, shared between copies of the device
+	*/
+	std::shared_ptr<PipelineCache> _pipelineCache;
+
+	/* Shader modules deduplicated by content, shared between copies of the device
+	*/
+	std::shared_ptr<ShaderModuleCache> _shaderModules;
+
+
+
+	/*
+	* PRIVATE STATIC MEMBERS
+	*/
+
+	/* File the pipeline cache is loaded from and saved to, relative to the working directory
+	*/
+	static constexpr const char* _PIPELINE_CACHE_FILE = "pipeline_cache.bin";
+
 
 
 	/*
@@ -0,0 +1,100 @@
+#include "FrameRingBuffer.h"
+
+#include <stdexcept>
+
+/*
+* CTORS / ASSIGNMENT DEFINITIONS
+*/
+
+FrameRingBuffer::FrameRingBuffer()
+	: _buffer(),
+	_partitionSize(0),
+	_numPartitions(0),
+	_currentPartition(0),
+	_head(0),
+	_uniformAlignment(1)
+{
+}
+
+FrameRingBuffer::FrameRingBuffer(const Device& device, VkDeviceSize partitionSize, uint32_t numFramesInFlight)
+	: _buffer(),
+	_partitionSize(0),
+	_numPartitions(numFramesInFlight),
+	_currentPartition(0),
+	_head(0),
+	_uniformAlignment(std::max<VkDeviceSize>(device.physical_properties().limits.minUniformBufferOffsetAlignment, 1))
+{
+	if (numFramesInFlight == 0)
+	{
+		throw std::invalid_argument("Ring buffer needs at least one partition");
+	}
+
+	// Keep every partition start aligned so allocations can be aligned relative to the buffer
+	_partitionSize = (partitionSize + _uniformAlignment - 1) / _uniformAlignment * _uniformAlignment;
+	_buffer = Buffer(device, Buffer::Type::DYNAMIC, static_cast<size_t>(_partitionSize * _numPartitions));
+}
+
+FrameRingBuffer::FrameRingBuffer(const FrameRingBuffer& other)
+	: _buffer(other._buffer),
+	_partitionSize(other._partitionSize),
+	_numPartitions(other._numPartitions),
+	_currentPartition(other._currentPartition),
+	_head(other._head),
+	_uniformAlignment(other._uniformAlignment)
+{
+}
+
+FrameRingBuffer::FrameRingBuffer(FrameRingBuffer&& other) noexcept
+	: FrameRingBuffer()
+{
+	swap(*this, other);
+}
+
+FrameRingBuffer& FrameRingBuffer::operator=(FrameRingBuffer other)
+{
+	swap(*this, other);
+	return *this;
+}
+
+FrameRingBuffer::~FrameRingBuffer()
+{
+}
+
+
+
+
+
+/*
+* PUBLIC METHOD DEFINITIONS
+*/
+
+void FrameRingBuffer::begin_frame(CommandPool& commandPool)
+{
+	// The GPU may still be reading this partition until the frame's fence signals
+	commandPool.wait_for_fences();
+
+	_currentPartition = commandPool.get_current_frame_num() % _numPartitions;
+	_head = _partition_start();
+}
+
+FrameRingBuffer::Allocation FrameRingBuffer::allocate(VkDeviceSize size, VkDeviceSize alignment)
+{
+	VkDeviceSize offset = (_head + alignment - 1) / alignment * alignment;
+	if (offset + size > _partition_start() + _partitionSize)
+	{
+		throw std::runtime_error("Frame ring buffer partition is full");
+	}
+
+	void* pBase;
+	_buffer.map_memory(&pBase);
+
+	_head = offset + size;
+	return { _buffer.handle(), offset, size, static_cast<char*>(pBase) + offset };
+}
+
+FrameRingBuffer::Allocation FrameRingBuffer::push_data(const void* data, VkDeviceSize size, VkDeviceSize alignment)
+{
+	auto allocation = allocate(size, alignment);
+	memcpy(allocation.pData, data, static_cast<size_t>(size));
+	return allocation;
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "Device.h"
+#include "Buffer.h"
+#include "CommandPool.h"
+
+/*
+* Class implementing a persistently mapped ring buffer for per-frame data
+*
+* The buffer is split into one partition per frame in flight. A partition is only reused after the
+* in-flight fence of its frame has signaled, so allocations are a bump of the head and need no further synchronization.
+*/
+class FrameRingBuffer
+{
+public:
+
+	/*
+	* PUBLIC STRUCTS
+	*/
+
+	/* A range of the ring buffer handed out for the current frame
+	*/
+	struct Allocation
+	{
+		VkBuffer buffer;
+		VkDeviceSize offset;
+		VkDeviceSize size;
+		void* pData;
+	};
+
+
+
+	/*
+	* PUBLIC FRIEND METHODS
+	*/
+
+	/* @brief Swap implementation for FrameRingBuffer class
+	*/
+	friend void swap(FrameRingBuffer& ringA, FrameRingBuffer& ringB)
+	{
+		using std::swap;
+
+		swap(ringA._buffer, ringB._buffer);
+		swap(ringA._partitionSize, ringB._partitionSize);
+		swap(ringA._numPartitions, ringB._numPartitions);
+		swap(ringA._currentPartition, ringB._currentPartition);
+		swap(ringA._head, ringB._head);
+		swap(ringA._uniformAlignment, ringB._uniformAlignment);
+	}
+
+
+
+	/*
+	* CTORS / ASSIGNMENT
+	*/
+
+	FrameRingBuffer();
+
+	/*
+	* @param device Device that will use the buffer
+	* @param partitionSize Number of bytes available to each frame
+	* @param numFramesInFlight Number of partitions, must match the command pool that fences the frames
+	*/
+	FrameRingBuffer(const Device& device, VkDeviceSize partitionSize, uint32_t numFramesInFlight);
+	FrameRingBuffer(const FrameRingBuffer& other);
+	FrameRingBuffer(FrameRingBuffer&& other) noexcept;
+	FrameRingBuffer& operator=(FrameRingBuffer other);
+	~FrameRingBuffer();
+
+
+
+	/*
+	* PUBLIC METHODS
+	*/
+
+	/* @brief Waits for the in-flight fence of the command pool's current frame, then rewinds that frame's partition
+	*/
+	void begin_frame(CommandPool& commandPool);
+
+	/* @brief Carves an aligned range out of the current frame's partition
+	*
+	* @throws std::runtime_error if the partition is full
+	*/
+	Allocation allocate(VkDeviceSize size, VkDeviceSize alignment);
+
+	/* @brief Allocates a range aligned for use as a dynamic uniform buffer and copies the data into it
+	*/
+	template<typename T>
+	Allocation push_uniform(const T& data)
+	{
+		auto allocation = allocate(sizeof(T), _uniformAlignment);
+		memcpy(allocation.pData, &data, sizeof(T));
+		return allocation;
+	}
+
+	/* @brief Allocates a range for vertex or index data and copies the data into it
+	*/
+	Allocation push_data(const void* data, VkDeviceSize size, VkDeviceSize alignment = 4);
+
+
+
+	/*
+	* PUBLIC CONST METHODS
+	*/
+
+	/* @brief Returns handle to the underlying buffer
+	*/
+	inline VkBuffer handle() const { return _buffer.handle(); }
+
+	/* @brief Returns the number of bytes allocated from the current frame's partition
+	*/
+	inline VkDeviceSize bytes_used() const { return _head - _partition_start(); }
+
+	/* @brief Returns the number of bytes available to each frame
+	*/
+	inline VkDeviceSize partition_size() const { return _partitionSize; }
+
+private:
+
+	/*
+	* PRIVATE MEMBERS
+	*/
+
+	/* Host visible buffer backing every partition
+	*/
+	Buffer _buffer;
+
+	/* Size of each partition
+	*/
+	VkDeviceSize _partitionSize;
+
+	/* Number of partitions
+	*/
+	uint32_t _numPartitions;
+
+	/* Partition used by the current frame
+	*/
+	uint32_t _currentPartition;
+
+	/* Offset of the next free byte
+	*/
+	VkDeviceSize _head;
+
+	/* Minimum alignment for dynamic uniform buffer offsets
+	*/
+	VkDeviceSize _uniformAlignment;
+
+
+
+	/*
+	* PRIVATE CONST METHODS
+	*/
+
+	/* @brief Returns the offset of the current frame's partition
+	*/
+	inline VkDeviceSize _partition_start() const { return _partitionSize * _currentPartition; }
+};
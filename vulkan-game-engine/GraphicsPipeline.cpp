@@ -9,21 +9,33 @@
 GraphicsPipeline::GraphicsPipeline()
 	: VulkanObject(),
 	_layout(VK_NULL_HANDLE),
-	_renderPass(VK_NULL_HANDLE)
+	_renderPass(VK_NULL_HANDLE),
+	_desc()
 {
 }
 
-GraphicsPipeline::GraphicsPipeline(const Device& device, const SwapChain& swapChain, const std::vector<Shader>& shaders, const DescriptorPool& descriptors)
+GraphicsPipeline::GraphicsPipeline(const Device& device, const SwapChain& swapChain, const std::vector<Shader>& shaders, const DescriptorPool& descriptors, VertexFormat vertexFormat)
+	: GraphicsPipeline(device, swapChain.surface_image_format(), VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, shaders, descriptors, vertexFormat)
+{
+}
+
+GraphicsPipeline::GraphicsPipeline(const Device& device, VkFormat colorFormat, VkImageLayout colorFinalLayout, const std::vector<Shader>& shaders, const DescriptorPool& descriptors, VertexFormat vertexFormat)
+	: GraphicsPipeline(device, Desc{ colorFormat, colorFinalLayout, vertexFormat }, shaders, descriptors.descriptor_set_layout())
+{
+}
+
+GraphicsPipeline::GraphicsPipeline(const Device& device, const Desc& desc, const std::vector<Shader>& shaders, VkDescriptorSetLayout setLayout)
 	: VulkanObject(device.handle()),
 	_layout(VK_NULL_HANDLE),
-	_renderPass(VK_NULL_HANDLE)
+	_renderPass(VK_NULL_HANDLE),
+	_desc(desc)
 {
 	// Create render pass
 	std::vector<VkAttachmentDescription> attachments(2);
 	std::vector<VkAttachmentReference> colorAttachmentRefs(1);
 	VkAttachmentReference depthAttachmentRef;
 
-	_configure_color_attachment(&attachments[0], &colorAttachmentRefs[0], swapChain.surface_image_format(), 0);
+	_configure_color_attachment(&attachments[0], &colorAttachmentRefs[0], desc.colorFormat, desc.colorFinalLayout, 0);
 
 	auto depthFormat = Device::select_supported_depth_format(device.get_physical_device(), SwapChain::available_depth_formats(), VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
 	_configure_depth_attachment(&attachments[1], &depthAttachmentRef, depthFormat, 1);
@@ -44,33 +56,46 @@ GraphicsPipeline::GraphicsPipeline(const Device& device, const SwapChain& swapCh
 
 
 	// Create pipeline
+	// Specialization infos point into the per-stage entry and data vectors, which live until the pipeline is created
 	std::vector<VkPipelineShaderStageCreateInfo> shaderStages(shaders.size());
+	std::vector<VkSpecializationInfo> specializations(shaders.size());
+	std::vector<std::vector<VkSpecializationMapEntry>> specEntries(shaders.size());
+	std::vector<std::vector<uint32_t>> specData(shaders.size());
 	for (size_t i = 0; i < shaderStages.size(); ++i)
 	{
-		_configure_shader_stage(&shaderStages[i], shaders[i], "main");
+		auto constants = shaders[i].constants().merged_with(desc.constants);
+		constants.configure_info(&specializations[i], specEntries[i], specData[i]);
+		_configure_shader_stage(&shaderStages[i], shaders[i], "main", constants.empty() ? nullptr : &specializations[i]);
 	}
 
 	VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
-	_configure_vertex_input(&vertexInputInfo, Vertex::getAttributeDescriptions(), Vertex::getBindingDescription());
+	if (desc.vertexFormat == VertexFormat::QUANTIZED)
+	{
+		_configure_vertex_input<QuantizedVertex::Layout>(&vertexInputInfo);
+	}
+	else
+	{
+		_configure_vertex_input<Vertex::Layout>(&vertexInputInfo);
+	}
 
 	VkPipelineInputAssemblyStateCreateInfo pipelineInput{};
-	_configure_pipeline_input_assembly(&pipelineInput);
+	_configure_pipeline_input_assembly(&pipelineInput, desc);
 
 	VkPipelineViewportStateCreateInfo pipelineViewport{};
 	_configure_pipeline_viewport(&pipelineViewport);
 
 	VkPipelineRasterizationStateCreateInfo rasterization{};
-	_configure_pipeline_rasterization(&rasterization);
+	_configure_pipeline_rasterization(&rasterization, desc);
 
 	VkPipelineMultisampleStateCreateInfo multisampling{};
 	_configure_pipeline_multisampling(&multisampling);
 
 	VkPipelineDepthStencilStateCreateInfo depthStencil{};
-	_configure_pipeline_depth_stencil(&depthStencil);
+	_configure_pipeline_depth_stencil(&depthStencil, desc);
 
 	VkPipelineColorBlendAttachmentState colorBlendAttachment{};
 	VkPipelineColorBlendStateCreateInfo colorBlend{};
-	_configure_pipeline_colorblend(&colorBlend, &colorBlendAttachment);
+	_configure_pipeline_colorblend(&colorBlend, &colorBlendAttachment, desc.blendMode);
 
 	VkPipelineDynamicStateCreateInfo dynamicStateInfo;
 	std::vector<VkDynamicState> dynamicStates = {
@@ -80,7 +105,6 @@ GraphicsPipeline::GraphicsPipeline(const Device& device, const SwapChain& swapCh
 	_configure_pipeline_dynamic_state(&dynamicStateInfo, dynamicStates);
 
 	VkPipelineLayoutCreateInfo layoutInfo;
-	auto setLayout = descriptors.descriptor_set_layout();
 	_configure_pipeline_layout(&layoutInfo, &setLayout);
 
 	if (vkCreatePipelineLayout(_deviceHandle, &layoutInfo, nullptr, &_layout) != VK_SUCCESS)
@@ -102,16 +126,14 @@ GraphicsPipeline::GraphicsPipeline(const Device& device, const SwapChain& swapCh
 		&dynamicStateInfo
 	);
 
-	if (vkCreateGraphicsPipelines(_deviceHandle, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &_handle) != VK_SUCCESS)
-	{
-		throw std::runtime_error("Failed to create graphics pipeline");
-	}
+	_handle = device.pipeline_cache()->create_graphics_pipeline(pipelineInfo);
 }
 
 GraphicsPipeline::GraphicsPipeline(const GraphicsPipeline& other)
 	: VulkanObject(other),
 	_layout(other._layout),
-	_renderPass(other._renderPass)
+	_renderPass(other._renderPass),
+	_desc(other._desc)
 {
 }
 GraphicsPipeline::GraphicsPipeline(GraphicsPipeline&& other) noexcept
@@ -139,11 +161,60 @@ GraphicsPipeline::~GraphicsPipeline()
 
 
 
+/*
+* PUBLIC STRUCT DEFINITIONS
+*/
+
+uint64_t GraphicsPipeline::Desc::hash() const
+{
+	// FNV-1a over each field widened to 32 bits, so padding and enum sizes never change the result
+	const uint32_t fields[] = {
+		static_cast<uint32_t>(colorFormat),
+		static_cast<uint32_t>(colorFinalLayout),
+		static_cast<uint32_t>(vertexFormat),
+		static_cast<uint32_t>(topology),
+		static_cast<uint32_t>(polygonMode),
+		static_cast<uint32_t>(cullMode),
+		static_cast<uint32_t>(frontFace),
+		static_cast<uint32_t>(depthTest),
+		static_cast<uint32_t>(depthWrite),
+		static_cast<uint32_t>(depthCompareOp),
+		static_cast<uint32_t>(blendMode)
+	};
+
+	uint64_t hash = 14695981039346656037ull;
+	auto hashWord = [&hash](uint32_t word) {
+		for (uint32_t byte = 0; byte < 4; ++byte)
+		{
+			hash ^= (word >> (byte * 8)) & 0xFF;
+			hash *= 1099511628211ull;
+		}
+	};
+
+	for (uint32_t field : fields)
+	{
+		hashWord(field);
+	}
+
+	// Constants are sorted by ID, so equal sets always hash the same
+	for (const auto& [constantId, value] : constants.values())
+	{
+		hashWord(constantId);
+		hashWord(value);
+	}
+
+	return hash;
+}
+
+
+
+
+
 /*
 * PRIVATE CONST METHODS DEFINITIONS
 */
 
-void GraphicsPipeline::_configure_shader_stage(VkPipelineShaderStageCreateInfo* pCreateInfo, const Shader& shader, const char* name) const
+void GraphicsPipeline::_configure_shader_stage(VkPipelineShaderStageCreateInfo* pCreateInfo, const Shader& shader, const char* name, const VkSpecializationInfo* pSpecialization) const
 {
 	memset(pCreateInfo, 0, sizeof(VkPipelineShaderStageCreateInfo));
 
@@ -166,27 +237,14 @@ void GraphicsPipeline::_configure_shader_stage(VkPipelineShaderStageCreateInfo*
 	pCreateInfo->stage = shaderFlag;
 	pCreateInfo->module = shader.handle();
 	pCreateInfo->pName = name;
+	pCreateInfo->pSpecializationInfo = pSpecialization;
 }
 
-void GraphicsPipeline::_configure_vertex_input(
-	VkPipelineVertexInputStateCreateInfo* pCreateInfo, 
-	const std::array<VkVertexInputAttributeDescription, 3>& attributeDescriptions,
-	VkVertexInputBindingDescription bindingDescription
-) const
-{
-	memset(pCreateInfo, 0, sizeof(VkPipelineVertexInputStateCreateInfo));
-	pCreateInfo->sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-	pCreateInfo->vertexBindingDescriptionCount = 1;
-	pCreateInfo->vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-	pCreateInfo->pVertexBindingDescriptions = &bindingDescription;
-	pCreateInfo->pVertexAttributeDescriptions = attributeDescriptions.data();
-}
-
-void GraphicsPipeline::_configure_pipeline_input_assembly(VkPipelineInputAssemblyStateCreateInfo* pCreateInfo) const
+void GraphicsPipeline::_configure_pipeline_input_assembly(VkPipelineInputAssemblyStateCreateInfo* pCreateInfo, const Desc& desc) const
 {
 	memset(pCreateInfo, 0, sizeof(VkPipelineInputAssemblyStateCreateInfo));
 	pCreateInfo->sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-	pCreateInfo->topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+	pCreateInfo->topology = desc.topology;
 	pCreateInfo->primitiveRestartEnable = VK_FALSE;
 }
 
@@ -198,16 +256,16 @@ void GraphicsPipeline::_configure_pipeline_viewport(VkPipelineViewportStateCreat
 	pCreateInfo->scissorCount = 1;
 }
  
-void GraphicsPipeline::_configure_pipeline_rasterization(VkPipelineRasterizationStateCreateInfo* pCreateInfo) const
+void GraphicsPipeline::_configure_pipeline_rasterization(VkPipelineRasterizationStateCreateInfo* pCreateInfo, const Desc& desc) const
 {
 	memset(pCreateInfo, 0, sizeof(VkPipelineRasterizationStateCreateInfo));
 	pCreateInfo->sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
 	pCreateInfo->depthClampEnable = VK_FALSE;
 	pCreateInfo->rasterizerDiscardEnable = VK_FALSE;
-	pCreateInfo->polygonMode = VK_POLYGON_MODE_FILL;
+	pCreateInfo->polygonMode = desc.polygonMode;
 	pCreateInfo->lineWidth = 1.0f;
-	pCreateInfo->cullMode = VK_CULL_MODE_BACK_BIT;
-	pCreateInfo->frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+	pCreateInfo->cullMode = desc.cullMode;
+	pCreateInfo->frontFace = desc.frontFace;
 	pCreateInfo->depthBiasEnable = VK_FALSE;
 }
 
@@ -219,22 +277,28 @@ void GraphicsPipeline::_configure_pipeline_multisampling(VkPipelineMultisampleSt
 	pCreateInfo->rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
 }
 
-void GraphicsPipeline::_configure_pipeline_depth_stencil(VkPipelineDepthStencilStateCreateInfo* pCreateInfo) const
+void GraphicsPipeline::_configure_pipeline_depth_stencil(VkPipelineDepthStencilStateCreateInfo* pCreateInfo, const Desc& desc) const
 {
 	memset(pCreateInfo, 0, sizeof(VkPipelineDepthStencilStateCreateInfo));
 	pCreateInfo->sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-	pCreateInfo->depthTestEnable = VK_TRUE;
-	pCreateInfo->depthWriteEnable = VK_TRUE;
-	pCreateInfo->depthCompareOp = VK_COMPARE_OP_LESS;
+	pCreateInfo->depthTestEnable = desc.depthTest ? VK_TRUE : VK_FALSE;
+	pCreateInfo->depthWriteEnable = desc.depthWrite ? VK_TRUE : VK_FALSE;
+	pCreateInfo->depthCompareOp = desc.depthCompareOp;
 	pCreateInfo->depthBoundsTestEnable = VK_FALSE;
 	pCreateInfo->stencilTestEnable = VK_FALSE;
 }
 
-void GraphicsPipeline::_configure_pipeline_colorblend(VkPipelineColorBlendStateCreateInfo* pStateInfo, VkPipelineColorBlendAttachmentState* pAttachInfo) const
+void GraphicsPipeline::_configure_pipeline_colorblend(VkPipelineColorBlendStateCreateInfo* pStateInfo, VkPipelineColorBlendAttachmentState* pAttachInfo, BlendMode blendMode) const
 {
 	memset(pAttachInfo, 0, sizeof(VkPipelineColorBlendAttachmentState));
 	pAttachInfo->colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-	pAttachInfo->blendEnable = VK_FALSE;
+	pAttachInfo->blendEnable = (blendMode != BlendMode::NONE) ? VK_TRUE : VK_FALSE;
+	pAttachInfo->srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+	pAttachInfo->dstColorBlendFactor = (blendMode == BlendMode::ADDITIVE) ? VK_BLEND_FACTOR_ONE : VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+	pAttachInfo->colorBlendOp = VK_BLEND_OP_ADD;
+	pAttachInfo->srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+	pAttachInfo->dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+	pAttachInfo->alphaBlendOp = VK_BLEND_OP_ADD;
 
 	memset(pStateInfo, 0, sizeof(VkPipelineColorBlendStateCreateInfo));
 	pStateInfo->sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
@@ -265,7 +329,7 @@ void GraphicsPipeline::_configure_pipeline_layout(VkPipelineLayoutCreateInfo* pC
 	pCreateInfo->pushConstantRangeCount = 0;
 }
 
-void GraphicsPipeline::_configure_color_attachment(VkAttachmentDescription* pCreateInfo, VkAttachmentReference* pRefInfo, VkFormat format, uint32_t index) const
+void GraphicsPipeline::_configure_color_attachment(VkAttachmentDescription* pCreateInfo, VkAttachmentReference* pRefInfo, VkFormat format, VkImageLayout finalLayout, uint32_t index) const
 {
 	memset(pCreateInfo, 0, sizeof(VkAttachmentDescription));
 	pCreateInfo->format = format;
@@ -275,7 +339,7 @@ void GraphicsPipeline::_configure_color_attachment(VkAttachmentDescription* pCre
 	pCreateInfo->stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 	pCreateInfo->stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 	pCreateInfo->initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-	pCreateInfo->finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+	pCreateInfo->finalLayout = finalLayout;
 
 	memset(pRefInfo, 0, sizeof(VkAttachmentReference));
 	pRefInfo->attachment = index;
@@ -3,12 +3,16 @@
 #include <vulkan/vulkan.h>
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <vector>
 
 #include "VulkanObject.h"
 #include "Shader.h"
 #include "SwapChain.h"
 #include "DescriptorPool.h"
+#include "QuantizedVertex.h"
+#include "SpecializationConstants.h"
 
 /*
 * Class implementing Vulkan graphics pipeline
@@ -17,6 +21,64 @@ class GraphicsPipeline : public VulkanObject<VkPipeline>
 {
 public:
 
+	/*
+	* PUBLIC ENUMS
+	*/
+
+	/* How fragments are combined with the color already in the attachment
+	*/
+	enum class BlendMode
+	{
+		NONE,
+
+		/* Source over destination by source alpha
+		*/
+		ALPHA,
+
+		/* Source color added to the destination, scaled by source alpha
+		*/
+		ADDITIVE
+	};
+
+
+
+	/*
+	* PUBLIC STRUCTS
+	*/
+
+	/* Fixed-function state and target of a pipeline. Two pipelines with equal descriptions are interchangeable
+	*/
+	struct Desc
+	{
+		/* Format of the color attachment, pipelines only share a render pass when this matches
+		*/
+		VkFormat colorFormat = VK_FORMAT_UNDEFINED;
+		VkImageLayout colorFinalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+		/* Layout of the vertex buffers, the vertex shader must match it
+		*/
+		VertexFormat vertexFormat = VertexFormat::FULL;
+
+		VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+		VkPolygonMode polygonMode = VK_POLYGON_MODE_FILL;
+		VkCullModeFlags cullMode = VK_CULL_MODE_BACK_BIT;
+		VkFrontFace frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+		bool depthTest = true;
+		bool depthWrite = true;
+		VkCompareOp depthCompareOp = VK_COMPARE_OP_LESS;
+		BlendMode blendMode = BlendMode::NONE;
+
+		/* Specialization constants applied to every stage, replacing the shaders' own values with the same ID
+		*/
+		SpecializationConstants constants;
+
+		/* @brief Returns a hash of every field that is the same across runs and platforms
+		*/
+		uint64_t hash() const;
+
+		bool operator==(const Desc& other) const = default;
+	};
+
 
 
 	/*
@@ -32,6 +94,7 @@ public:
 		swap(pipelineA._layout, pipelineB._layout);
 		swap(pipelineA._handle, pipelineB._handle);
 		swap(pipelineA._renderPass, pipelineB._renderPass);
+		swap(pipelineA._desc, pipelineB._desc);
 		swap(pipelineA._deviceHandle, pipelineB._deviceHandle);
 	}
 
@@ -46,8 +109,24 @@ public:
 	* @param device Device being used
 	* @param swapChain Swap chain being used with this pipeline
 	* @param shaders List of shaders to be used
+	* @param vertexFormat Layout of the vertex buffers drawn with this pipeline, the vertex shader must match it
+	*/
+	GraphicsPipeline(const Device& device, const SwapChain& swapChain, const std::vector<Shader>& shaders, const DescriptorPool& descriptors, VertexFormat vertexFormat = VertexFormat::FULL);
+	/*
+	* @param device Device being used
+	* @param colorFormat Format of the color attachment being rendered to
+	* @param colorFinalLayout Layout the color attachment is transitioned to at the end of the render pass
+	* @param shaders List of shaders to be used
+	* @param vertexFormat Layout of the vertex buffers drawn with this pipeline, the vertex shader must match it
+	*/
+	GraphicsPipeline(const Device& device, VkFormat colorFormat, VkImageLayout colorFinalLayout, const std::vector<Shader>& shaders, const DescriptorPool& descriptors, VertexFormat vertexFormat = VertexFormat::FULL);
+	/*
+	* @param device Device being used
+	* @param desc State and target of the pipeline
+	* @param shaders List of shaders to be used, they can be destroyed once the pipeline exists
+	* @param setLayout Layout of the single descriptor set bound with this pipeline
 	*/
-	GraphicsPipeline(const Device& device, const SwapChain& swapChain, const std::vector<Shader>& shaders, const DescriptorPool& descriptors);
+	GraphicsPipeline(const Device& device, const Desc& desc, const std::vector<Shader>& shaders, VkDescriptorSetLayout setLayout);
 	GraphicsPipeline(const GraphicsPipeline& other);
 	GraphicsPipeline(GraphicsPipeline&& other) noexcept;
 	GraphicsPipeline& operator=(GraphicsPipeline other);
@@ -67,6 +146,10 @@ public:
 	*/
 	inline VkRenderPass render_pass() const { return _renderPass; }
 
+	/* @brief Returns the description the pipeline was created from
+	*/
+	inline const Desc& desc() const { return _desc; }
+
 private:
 
 	/*
@@ -94,6 +177,10 @@ private:
 	*/
 	VkRenderPass _renderPass;
 
+	/* Description the pipeline was created from
+	*/
+	Desc _desc;
+
 
 
 	/*
@@ -105,20 +192,28 @@ private:
 	* @param[out] pCreateInfo The struct to fill
 	* @param shader Shader information
 	* @param name The stage name
+	* @param pSpecialization Specialization constants of the stage, or nullptr for none
 	*/
-	void _configure_shader_stage(VkPipelineShaderStageCreateInfo* pCreateInfo, const Shader& shader, const char* name) const;
+	void _configure_shader_stage(VkPipelineShaderStageCreateInfo* pCreateInfo, const Shader& shader, const char* name, const VkSpecializationInfo* pSpecialization) const;
 
 	/* @brief Fills struct with info necessary for creating the vertex input state
+	*
+	* @tparam Layout VertexLayout of the vertex buffer. Its descriptions are static, so the struct never points at temporaries
 	*/
-	void _configure_vertex_input(
-		VkPipelineVertexInputStateCreateInfo* pCreateInfo,
-		const std::array<VkVertexInputAttributeDescription, 3>& attributeDescriptions,
-		VkVertexInputBindingDescription bindingDescription
-	) const;
+	template<typename Layout>
+	void _configure_vertex_input(VkPipelineVertexInputStateCreateInfo* pCreateInfo) const
+	{
+		memset(pCreateInfo, 0, sizeof(VkPipelineVertexInputStateCreateInfo));
+		pCreateInfo->sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+		pCreateInfo->vertexBindingDescriptionCount = 1;
+		pCreateInfo->vertexAttributeDescriptionCount = Layout::ATTRIBUTE_COUNT;
+		pCreateInfo->pVertexBindingDescriptions = &Layout::BINDING;
+		pCreateInfo->pVertexAttributeDescriptions = Layout::ATTRIBUTES.data();
+	}
 
 	/* @brief Fills struct with info necessary for creating the input assembly state
 	*/
-	void _configure_pipeline_input_assembly(VkPipelineInputAssemblyStateCreateInfo* pCreateInfo) const;
+	void _configure_pipeline_input_assembly(VkPipelineInputAssemblyStateCreateInfo* pCreateInfo, const Desc& desc) const;
 
 	/* @brief Fills struct with info necessary for creating the viewport state
 	*/
@@ -126,7 +221,7 @@ private:
 
 	/* @brief Fills struct with info necessary for creating the rasterization state
 	*/
-	void _configure_pipeline_rasterization(VkPipelineRasterizationStateCreateInfo* pCreateInfo) const;
+	void _configure_pipeline_rasterization(VkPipelineRasterizationStateCreateInfo* pCreateInfo, const Desc& desc) const;
 
 	/* @brief Fills struct with info necessary for creating the multisampling state
 	*/
@@ -134,11 +229,11 @@ private:
 
 	/* @brief Fills struct with info necessary for creating the depth stencil state
 	*/
-	void _configure_pipeline_depth_stencil(VkPipelineDepthStencilStateCreateInfo* pCreateInfo) const;
+	void _configure_pipeline_depth_stencil(VkPipelineDepthStencilStateCreateInfo* pCreateInfo, const Desc& desc) const;
 
 	/* @brief Fills struct with info necessary for creating the colorblend state
 	*/
-	void _configure_pipeline_colorblend(VkPipelineColorBlendStateCreateInfo* pStateInfo, VkPipelineColorBlendAttachmentState* pAttachInfo) const;
+	void _configure_pipeline_colorblend(VkPipelineColorBlendStateCreateInfo* pStateInfo, VkPipelineColorBlendAttachmentState* pAttachInfo, BlendMode blendMode) const;
 
 	/* @brief Fills struct with info necessary for creating the dynamic states
 	*/
@@ -150,7 +245,7 @@ private:
 
 	/* @brief Fills struct with info necessary for creating a color attachment
 	*/
-	void _configure_color_attachment(VkAttachmentDescription* pCreateInfo, VkAttachmentReference* pRefInfo, VkFormat format, uint32_t index) const;
+	void _configure_color_attachment(VkAttachmentDescription* pCreateInfo, VkAttachmentReference* pRefInfo, VkFormat format, VkImageLayout finalLayout, uint32_t index) const;
 
 	/* @brief Fills struct with info necessary for creating a depth attachment
 	*/
@@ -2,7 +2,8 @@
 
 Image::Image()
 	: VulkanObject(),
-	_imageMemory(VK_NULL_HANDLE),
+	_allocation({}),
+	_pAllocator(nullptr),
 	_physicalDeviceHandle(VK_NULL_HANDLE),
 	_imageView(VK_NULL_HANDLE),
 	_props({})
@@ -11,7 +12,8 @@ Image::Image()
 
 Image::Image(const Device& device, ImageProperties properties)
 	: VulkanObject(device.handle()),
-	_imageMemory(VK_NULL_HANDLE),
+	_allocation({}),
+	_pAllocator(device.allocator()),
 	_physicalDeviceHandle(device.get_physical_device()),
 	_imageView(VK_NULL_HANDLE),
 	_props(properties)
@@ -24,17 +26,12 @@ Image::Image(const Device& device, ImageProperties properties)
 		throw std::runtime_error("Failed to create image handle");
 	}
 
-	VkMemoryAllocateInfo allocInfo{};
 	VkMemoryRequirements memRequirements;
 	vkGetImageMemoryRequirements(_deviceHandle, _handle, &memRequirements);
 
-	_configure_alloc(&allocInfo, memRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-	if (vkAllocateMemory(_deviceHandle, &allocInfo, nullptr, &_imageMemory) != VK_SUCCESS)
-	{
-		throw std::runtime_error("Failed to allocate image memory");
-	}
-
-	vkBindImageMemory(_deviceHandle, _handle, _imageMemory, 0);
+	bool isLinear = (_props.tiling == VK_IMAGE_TILING_LINEAR);
+	_allocation = _pAllocator->allocate(memRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, isLinear);
+	vkBindImageMemory(_deviceHandle, _handle, _allocation.memory, _allocation.offset);
 
 	VkImageViewCreateInfo imgViewInfo{};
 	_configure_image_view(&imgViewInfo);
@@ -45,15 +42,6 @@ Image::Image(const Device& device, ImageProperties properties)
 	}
 }
 
-Image::Image(const Image& other)
-	: VulkanObject(other),
-	_imageMemory(other._imageMemory),
-	_physicalDeviceHandle(other._physicalDeviceHandle),
-	_imageView(other._imageView),
-	_props(other._props)
-{
-}
-
 Image::Image(Image&& other) noexcept
 	: Image()
 {
@@ -72,11 +60,147 @@ Image::~Image()
 	{
 		vkDestroyImageView(_deviceHandle, _imageView, nullptr);
 		vkDestroyImage(_deviceHandle, _handle, nullptr);
-		vkFreeMemory(_deviceHandle, _imageMemory, nullptr);
+		_pAllocator->free(_allocation);
 
 		_handle = VK_NULL_HANDLE;
 		_imageView = VK_NULL_HANDLE;
+		_allocation = {};
+	}
+}
+
+void Image::record_layout_transition(VkCommandBuffer cmdBuffer, VkImageLayout oldLayout, VkImageLayout newLayout) const
+{
+	VkImageMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.oldLayout = oldLayout;
+	barrier.newLayout = newLayout;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = _handle;
+	barrier.subresourceRange.aspectMask = _props.aspect;
+	barrier.subresourceRange.baseMipLevel = 0;
+	barrier.subresourceRange.levelCount = _props.mipLevels;
+	barrier.subresourceRange.baseArrayLayer = 0;
+	barrier.subresourceRange.layerCount = 1;
+
+	VkPipelineStageFlags sourceStage;
+	VkPipelineStageFlags destinationStage;
+
+	if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+	{
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+		sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+		destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+	}
+	else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+	{
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+		sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	}
+	else
+	{
+		throw std::invalid_argument("Image layout transition is unsupported");
+	}
+
+	vkCmdPipelineBarrier(
+		cmdBuffer,
+		sourceStage, destinationStage,
+		0,
+		0, nullptr,
+		0, nullptr,
+		1, &barrier
+	);
+}
+
+void Image::record_copy_from_buffer(VkCommandBuffer cmdBuffer, VkBuffer srcBuffer, uint32_t mipLevel, VkDeviceSize bufferOffset) const
+{
+	VkBufferImageCopy region{};
+	region.bufferOffset = bufferOffset;
+	region.bufferRowLength = 0;
+	region.bufferImageHeight = 0;
+	region.imageSubresource.aspectMask = _props.aspect;
+	region.imageSubresource.mipLevel = mipLevel;
+	region.imageSubresource.baseArrayLayer = 0;
+	region.imageSubresource.layerCount = 1;
+	region.imageOffset = { 0, 0, 0 };
+	region.imageExtent = {
+		std::max(1u, _props.width >> mipLevel),
+		std::max(1u, _props.height >> mipLevel),
+		1
+	};
+
+	vkCmdCopyBufferToImage(cmdBuffer, srcBuffer, _handle, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+}
+
+void Image::record_generate_mipmaps(VkCommandBuffer cmdBuffer) const
+{
+	int32_t levelWidth = static_cast<int32_t>(_props.width);
+	int32_t levelHeight = static_cast<int32_t>(_props.height);
+
+	for (uint32_t level = 1; level < _props.mipLevels; ++level)
+	{
+		// The previous level has been written, by the upload or the last blit, and is now read from
+		_record_level_barrier(cmdBuffer, level - 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+		int32_t nextWidth = std::max(1, levelWidth / 2);
+		int32_t nextHeight = std::max(1, levelHeight / 2);
+
+		VkImageBlit blit{};
+		blit.srcOffsets[0] = { 0, 0, 0 };
+		blit.srcOffsets[1] = { levelWidth, levelHeight, 1 };
+		blit.srcSubresource.aspectMask = _props.aspect;
+		blit.srcSubresource.mipLevel = level - 1;
+		blit.srcSubresource.baseArrayLayer = 0;
+		blit.srcSubresource.layerCount = 1;
+		blit.dstOffsets[0] = { 0, 0, 0 };
+		blit.dstOffsets[1] = { nextWidth, nextHeight, 1 };
+		blit.dstSubresource.aspectMask = _props.aspect;
+		blit.dstSubresource.mipLevel = level;
+		blit.dstSubresource.baseArrayLayer = 0;
+		blit.dstSubresource.layerCount = 1;
+
+		vkCmdBlitImage(cmdBuffer,
+			_handle, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			_handle, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			1, &blit,
+			VK_FILTER_LINEAR);
+
+		_record_level_barrier(cmdBuffer, level - 1, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+		levelWidth = nextWidth;
+		levelHeight = nextHeight;
+	}
+
+	// The last level was only ever written to
+	_record_level_barrier(cmdBuffer, _props.mipLevels - 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+		VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+}
+
+uint32_t Image::full_mip_chain_length(uint32_t width, uint32_t height)
+{
+	uint32_t levels = 1;
+	for (uint32_t size = std::max(width, height); size > 1; size >>= 1)
+	{
+		levels++;
 	}
+	return levels;
+}
+
+bool Image::supports_linear_blit() const
+{
+	VkFormatProperties formatProps;
+	vkGetPhysicalDeviceFormatProperties(_physicalDeviceHandle, _props.format, &formatProps);
+
+	VkFormatFeatureFlags features = (_props.tiling == VK_IMAGE_TILING_LINEAR) ? formatProps.linearTilingFeatures : formatProps.optimalTilingFeatures;
+	VkFormatFeatureFlags required = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+	return (features & required) == required;
 }
 
 void Image::_configure_image(VkImageCreateInfo* pCreateInfo) const
@@ -87,7 +211,7 @@ void Image::_configure_image(VkImageCreateInfo* pCreateInfo) const
 	pCreateInfo->extent.width = _props.width;
 	pCreateInfo->extent.height = _props.height;
 	pCreateInfo->extent.depth = 1;
-	pCreateInfo->mipLevels = 1;
+	pCreateInfo->mipLevels = _props.mipLevels;
 	pCreateInfo->arrayLayers = 1;
 	pCreateInfo->format = _props.format;
 	pCreateInfo->tiling = _props.tiling;
@@ -97,14 +221,6 @@ void Image::_configure_image(VkImageCreateInfo* pCreateInfo) const
 	pCreateInfo->sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 }
 
-void Image::_configure_alloc(VkMemoryAllocateInfo* pAllocInfo, VkMemoryRequirements requirements, VkMemoryPropertyFlags properties) const
-{
-	memset(pAllocInfo, 0, sizeof(VkMemoryAllocateInfo));
-	pAllocInfo->sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-	pAllocInfo->allocationSize = requirements.size;
-	pAllocInfo->memoryTypeIndex = Device::find_memory_type(_physicalDeviceHandle, requirements.memoryTypeBits, properties);
-}
-
 void Image::_configure_image_view(VkImageViewCreateInfo* pCreateInfo) const
 {
 	memset(pCreateInfo, 0, sizeof(VkImageViewCreateInfo));
@@ -112,9 +228,30 @@ void Image::_configure_image_view(VkImageViewCreateInfo* pCreateInfo) const
 	pCreateInfo->image = _handle;
 	pCreateInfo->viewType = VK_IMAGE_VIEW_TYPE_2D;
 	pCreateInfo->format = _props.format;
+	pCreateInfo->components = _props.components;
 	pCreateInfo->subresourceRange.aspectMask = _props.aspect;
 	pCreateInfo->subresourceRange.baseMipLevel = 0;
-	pCreateInfo->subresourceRange.levelCount = 1;
+	pCreateInfo->subresourceRange.levelCount = _props.mipLevels;
 	pCreateInfo->subresourceRange.baseArrayLayer = 0;
 	pCreateInfo->subresourceRange.layerCount = 1;
+}
+
+void Image::_record_level_barrier(VkCommandBuffer cmdBuffer, uint32_t mipLevel, VkImageLayout oldLayout, VkImageLayout newLayout, VkAccessFlags srcAccess, VkAccessFlags dstAccess, VkPipelineStageFlags dstStage) const
+{
+	VkImageMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.oldLayout = oldLayout;
+	barrier.newLayout = newLayout;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = _handle;
+	barrier.subresourceRange.aspectMask = _props.aspect;
+	barrier.subresourceRange.baseMipLevel = mipLevel;
+	barrier.subresourceRange.levelCount = 1;
+	barrier.subresourceRange.baseArrayLayer = 0;
+	barrier.subresourceRange.layerCount = 1;
+	barrier.srcAccessMask = srcAccess;
+	barrier.dstAccessMask = dstAccess;
+
+	vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
 }
\ No newline at end of file
@@ -17,6 +17,14 @@ public:
 		VkImageTiling tiling;
 		VkImageUsageFlags usage;
 		VkImageAspectFlags aspect;
+
+		/* Number of mip levels, level 0 being the full resolution image
+		*/
+		uint32_t mipLevels = 1;
+
+		/* Swizzle applied by the image view, identity by default. Lets images with fewer channels read like RGBA in shaders
+		*/
+		VkComponentMapping components = {};
 	};
 
 	friend void swap(Image& imgA, Image& imgB)
@@ -25,7 +33,8 @@ public:
 
 		swap(imgA._handle, imgB._handle);
 		swap(imgA._deviceHandle, imgB._deviceHandle);
-		swap(imgA._imageMemory, imgB._imageMemory);
+		swap(imgA._allocation, imgB._allocation);
+		swap(imgA._pAllocator, imgB._pAllocator);
 		swap(imgA._physicalDeviceHandle, imgB._physicalDeviceHandle);
 		swap(imgA._imageView, imgB._imageView);
 		swap(imgA._props, imgB._props);
@@ -33,7 +42,9 @@ public:
 
 	Image();
 	Image(const Device& device, ImageProperties properties);
-	Image(const Image& other);
+	/* Copies would free the same image and allocation twice
+	*/
+	Image(const Image&) = delete;
 	Image(Image&& other) noexcept;
 	Image& operator=(Image other);
 	virtual ~Image();
@@ -42,15 +53,42 @@ public:
 	inline ImageProperties properties() const { return _props; }
 	inline uint32_t width() const { return _props.width; }
 	inline uint32_t height() const { return _props.height; }
+	inline uint32_t mip_levels() const { return _props.mipLevels; }
+
+	/* @brief Returns the number of levels in a full mip chain down to 1x1
+	*/
+	static uint32_t full_mip_chain_length(uint32_t width, uint32_t height);
+
+	/* @brief Checks if the device can blit this image's format with linear filtering, which mip generation needs
+	*/
+	bool supports_linear_blit() const;
+
+	/* @brief Records a barrier moving every mip level from one layout to another
+	*/
+	void record_layout_transition(VkCommandBuffer cmdBuffer, VkImageLayout oldLayout, VkImageLayout newLayout) const;
+
+	/* @brief Records a copy from a buffer into one mip level
+	*
+	* @param mipLevel Level to copy into, the extent is that level's size
+	* @param bufferOffset Offset of the level's texels in the buffer
+	*/
+	void record_copy_from_buffer(VkCommandBuffer cmdBuffer, VkBuffer srcBuffer, uint32_t mipLevel = 0, VkDeviceSize bufferOffset = 0) const;
+
+	/* @brief Records a blit cascade filling every mip level from level 0
+	*
+	* Every level must be in TRANSFER_DST_OPTIMAL layout with level 0 holding the image. All levels end up in SHADER_READ_ONLY_OPTIMAL
+	*/
+	void record_generate_mipmaps(VkCommandBuffer cmdBuffer) const;
 
 protected:
-	VkDeviceMemory _imageMemory;
+	MemoryAllocator::Allocation _allocation;
+	MemoryAllocator* _pAllocator;
 	VkPhysicalDevice _physicalDeviceHandle;
 	VkImageView _imageView;
 	ImageProperties _props;
 
 	void _configure_image(VkImageCreateInfo* pCreateInfo) const;
-	void _configure_alloc(VkMemoryAllocateInfo* pAllocInfo, VkMemoryRequirements requirements, VkMemoryPropertyFlags properties) const;
 	void _configure_image_view(VkImageViewCreateInfo* pCreateInfo) const;
+	void _record_level_barrier(VkCommandBuffer cmdBuffer, uint32_t mipLevel, VkImageLayout oldLayout, VkImageLayout newLayout, VkAccessFlags srcAccess, VkAccessFlags dstAccess, VkPipelineStageFlags dstStage) const;
 };
 
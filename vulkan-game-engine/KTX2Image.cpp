@@ -0,0 +1,343 @@
+#include "KTX2Image.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "BCEncoder.h"
+#include "Image.h"
+
+/* @brief Reads a little-endian value of type T from unaligned file memory
+*/
+template<typename T>
+static T read_value(const char* pData, size_t offset)
+{
+	T value;
+	memcpy(&value, pData + offset, sizeof(T));
+	return value;
+}
+
+/* @brief Appends the bytes of a value to a byte buffer
+*/
+template<typename T>
+static void append_value(std::vector<uint8_t>& bytes, T value)
+{
+	const uint8_t* pValue = reinterpret_cast<const uint8_t*>(&value);
+	bytes.insert(bytes.end(), pValue, pValue + sizeof(T));
+}
+
+/*
+* STATIC METHOD DEFINITIONS
+*/
+
+void KTX2Image::write(const std::string& filepath, VkFormat format, uint32_t width, uint32_t height, const std::vector<std::vector<uint8_t>>& levels)
+{
+	if (!is_supported_format(format))
+	{
+		throw std::invalid_argument("KTX2 files can only be written with BC1, BC3, BC5 or BC7 formats");
+	}
+
+	if (levels.empty())
+	{
+		throw std::invalid_argument("KTX2 file needs at least one mip level");
+	}
+
+	auto descriptor = _build_format_descriptor(format);
+	uint32_t levelCount = static_cast<uint32_t>(levels.size());
+	uint32_t dfdOffset = static_cast<uint32_t>(_HEADER_SIZE + levelCount * 3 * sizeof(uint64_t));
+	uint32_t dfdLength = static_cast<uint32_t>(descriptor.size() * sizeof(uint32_t));
+
+	// Payloads are stored smallest level first, each aligned to its block size
+	uint64_t alignment = BCEncoder::block_size(format);
+	std::vector<Level> levelIndex(levelCount);
+	uint64_t offset = dfdOffset + dfdLength;
+	for (uint32_t i = levelCount; i-- > 0;)
+	{
+		offset = (offset + alignment - 1) / alignment * alignment;
+		levelIndex[i] = { offset, levels[i].size() };
+		offset += levels[i].size();
+	}
+
+	std::vector<uint8_t> header;
+	header.insert(header.end(), std::begin(_IDENTIFIER), std::end(_IDENTIFIER));
+	append_value<uint32_t>(header, format);
+	append_value<uint32_t>(header, 1);				// typeSize, 1 for block-compressed formats
+	append_value<uint32_t>(header, width);
+	append_value<uint32_t>(header, height);
+	append_value<uint32_t>(header, 0);				// pixelDepth
+	append_value<uint32_t>(header, 0);				// layerCount
+	append_value<uint32_t>(header, 1);				// faceCount
+	append_value<uint32_t>(header, levelCount);
+	append_value<uint32_t>(header, 0);				// supercompressionScheme
+	append_value<uint32_t>(header, dfdOffset);
+	append_value<uint32_t>(header, dfdLength);
+	append_value<uint32_t>(header, 0);				// kvdByteOffset
+	append_value<uint32_t>(header, 0);				// kvdByteLength
+	append_value<uint64_t>(header, 0);				// sgdByteOffset
+	append_value<uint64_t>(header, 0);				// sgdByteLength
+
+	for (const auto& level : levelIndex)
+	{
+		append_value<uint64_t>(header, level.byteOffset);
+		append_value<uint64_t>(header, level.byteLength);
+		append_value<uint64_t>(header, level.byteLength);
+	}
+
+	for (uint32_t word : descriptor)
+	{
+		append_value<uint32_t>(header, word);
+	}
+
+	std::ofstream file(filepath, std::ios::binary);
+	if (!file)
+	{
+		throw std::runtime_error("Failed to open " + filepath + " for writing");
+	}
+
+	file.write(reinterpret_cast<const char*>(header.data()), header.size());
+	uint64_t written = header.size();
+	for (uint32_t i = levelCount; i-- > 0;)
+	{
+		static const char padding[16] = {};
+		file.write(padding, static_cast<std::streamsize>(levelIndex[i].byteOffset - written));
+		file.write(reinterpret_cast<const char*>(levels[i].data()), levels[i].size());
+		written = levelIndex[i].byteOffset + levels[i].size();
+	}
+
+	if (!file)
+	{
+		throw std::runtime_error("Failed to write " + filepath);
+	}
+}
+
+bool KTX2Image::is_supported_format(VkFormat format)
+{
+	switch (format)
+	{
+	case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+	case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+	case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+	case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+	case VK_FORMAT_BC3_UNORM_BLOCK:
+	case VK_FORMAT_BC3_SRGB_BLOCK:
+	case VK_FORMAT_BC5_UNORM_BLOCK:
+	case VK_FORMAT_BC5_SNORM_BLOCK:
+	case VK_FORMAT_BC7_UNORM_BLOCK:
+	case VK_FORMAT_BC7_SRGB_BLOCK:
+		return true;
+	default:
+		return false;
+	}
+}
+
+
+
+
+
+/*
+* CTORS / ASSIGNMENT DEFINITIONS
+*/
+
+KTX2Image::KTX2Image()
+	: _file(),
+	_format(VK_FORMAT_UNDEFINED),
+	_width(0),
+	_height(0),
+	_levels({})
+{
+}
+
+KTX2Image::KTX2Image(const std::string& filepath)
+	: KTX2Image()
+{
+	_file = MappedFile(filepath);
+	const char* pData = _file.data();
+	size_t fileSize = _file.size();
+
+	if (fileSize < _HEADER_SIZE || memcmp(pData, _IDENTIFIER, sizeof(_IDENTIFIER)) != 0)
+	{
+		throw std::runtime_error(filepath + " is not a KTX2 file");
+	}
+
+	_format = static_cast<VkFormat>(read_value<uint32_t>(pData, 12));
+	_width = read_value<uint32_t>(pData, 20);
+	_height = read_value<uint32_t>(pData, 24);
+	uint32_t pixelDepth = read_value<uint32_t>(pData, 28);
+	uint32_t layerCount = read_value<uint32_t>(pData, 32);
+	uint32_t faceCount = read_value<uint32_t>(pData, 36);
+	uint32_t levelCount = std::max(1u, read_value<uint32_t>(pData, 40));
+	uint32_t supercompression = read_value<uint32_t>(pData, 44);
+
+	if (_format == VK_FORMAT_UNDEFINED || supercompression != 0)
+	{
+		throw std::runtime_error(filepath + " uses Basis Universal or supercompression, which is not supported");
+	}
+
+	if (_width == 0 || _height == 0 || pixelDepth > 1 || layerCount > 1 || faceCount != 1)
+	{
+		throw std::runtime_error(filepath + " is not a single 2D texture");
+	}
+
+	if (BCEncoder::block_size(_format) == 0)
+	{
+		throw std::runtime_error(filepath + " uses a format that isn't BC1, BC3, BC5 or BC7");
+	}
+
+	if (levelCount > Image::full_mip_chain_length(_width, _height))
+	{
+		throw std::runtime_error(filepath + " has more mip levels than its dimensions allow");
+	}
+
+	if (fileSize < _HEADER_SIZE + levelCount * 3 * sizeof(uint64_t))
+	{
+		throw std::runtime_error(filepath + " has a truncated level index");
+	}
+
+	_levels.reserve(levelCount);
+	for (uint32_t i = 0; i < levelCount; ++i)
+	{
+		size_t entryOffset = _HEADER_SIZE + i * 3 * sizeof(uint64_t);
+		Level level = { read_value<uint64_t>(pData, entryOffset), read_value<uint64_t>(pData, entryOffset + sizeof(uint64_t)) };
+		if (level.byteLength == 0 || level.byteOffset > fileSize || level.byteLength > fileSize - level.byteOffset)
+		{
+			throw std::runtime_error(filepath + " has a mip level outside of the file");
+		}
+
+		// The copy into the image reads exactly this many bytes, whatever the file claims
+		size_t expectedLength = BCEncoder::encoded_size(_format, std::max(1u, _width >> i), std::max(1u, _height >> i));
+		if (level.byteLength != expectedLength)
+		{
+			throw std::runtime_error(filepath + " has a mip level whose size doesn't match its format and dimensions");
+		}
+		_levels.push_back(level);
+	}
+}
+
+KTX2Image::KTX2Image(KTX2Image&& other) noexcept
+	: KTX2Image()
+{
+	swap(*this, other);
+}
+
+KTX2Image& KTX2Image::operator=(KTX2Image other)
+{
+	swap(*this, other);
+	return *this;
+}
+
+KTX2Image::~KTX2Image()
+{
+}
+
+
+
+
+
+/*
+* PUBLIC CONST METHOD DEFINITIONS
+*/
+
+size_t KTX2Image::size_in_bytes() const
+{
+	size_t total = 0;
+	for (const auto& level : _levels)
+	{
+		total += static_cast<size_t>(level.byteLength);
+	}
+	return total;
+}
+
+
+
+
+
+/*
+* PRIVATE STATIC METHOD DEFINITIONS
+*/
+
+std::vector<uint32_t> KTX2Image::_build_format_descriptor(VkFormat format)
+{
+	// Values from the Khronos Data Format specification
+	constexpr uint32_t MODEL_BC1A = 128;
+	constexpr uint32_t MODEL_BC3 = 130;
+	constexpr uint32_t MODEL_BC5 = 132;
+	constexpr uint32_t MODEL_BC7 = 134;
+	constexpr uint32_t PRIMARIES_BT709 = 1;
+	constexpr uint32_t TRANSFER_LINEAR = 1;
+	constexpr uint32_t TRANSFER_SRGB = 2;
+	constexpr uint32_t CHANNEL_LINEAR = 0x10;
+	constexpr uint32_t CHANNEL_SIGNED = 0x40;
+
+	struct Sample
+	{
+		uint32_t bitOffset;
+		uint32_t channel;
+	};
+
+	uint32_t model = 0;
+	bool isSrgb = false;
+	bool isSigned = false;
+	std::vector<Sample> samples;
+	switch (format)
+	{
+	case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+	case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+		isSrgb = true;
+		[[fallthrough]];
+	case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+	case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+		model = MODEL_BC1A;
+		samples = { { 0, (format == VK_FORMAT_BC1_RGBA_UNORM_BLOCK || format == VK_FORMAT_BC1_RGBA_SRGB_BLOCK) ? 1u : 0u } };
+		break;
+	case VK_FORMAT_BC3_SRGB_BLOCK:
+		isSrgb = true;
+		[[fallthrough]];
+	case VK_FORMAT_BC3_UNORM_BLOCK:
+		model = MODEL_BC3;
+		samples = { { 0, 15 }, { 64, 0 } };
+		break;
+	case VK_FORMAT_BC5_SNORM_BLOCK:
+		isSigned = true;
+		[[fallthrough]];
+	case VK_FORMAT_BC5_UNORM_BLOCK:
+		model = MODEL_BC5;
+		samples = { { 0, 0 }, { 64, 1 } };
+		break;
+	case VK_FORMAT_BC7_SRGB_BLOCK:
+		isSrgb = true;
+		[[fallthrough]];
+	case VK_FORMAT_BC7_UNORM_BLOCK:
+		model = MODEL_BC7;
+		samples = { { 0, 0 } };
+		break;
+	default:
+		throw std::invalid_argument("No data format descriptor for this format");
+	}
+
+	uint32_t bytesPerBlock = static_cast<uint32_t>(BCEncoder::block_size(format));
+	uint32_t bitsPerSample = bytesPerBlock * 8 / static_cast<uint32_t>(samples.size());
+	uint32_t blockSize = static_cast<uint32_t>(24 + 16 * samples.size());
+
+	std::vector<uint32_t> words;
+	words.push_back(4 + blockSize);												// dfdTotalSize
+	words.push_back(0);															// vendorId and descriptorType, both Khronos basic
+	words.push_back(2 | (blockSize << 16));										// versionNumber and descriptorBlockSize
+	words.push_back(model | (PRIMARIES_BT709 << 8) | ((isSrgb ? TRANSFER_SRGB : TRANSFER_LINEAR) << 16));
+	words.push_back(3 | (3 << 8));												// 4x4 texel blocks, stored minus one
+	words.push_back(bytesPerBlock);												// bytesPlane0
+	words.push_back(0);															// bytesPlane4 to 7
+
+	for (const auto& sample : samples)
+	{
+		// Alpha stays linear in sRGB formats
+		uint32_t qualifiers = (isSrgb && sample.channel == 15) ? CHANNEL_LINEAR : 0;
+		qualifiers |= isSigned ? CHANNEL_SIGNED : 0;
+
+		words.push_back(sample.bitOffset | ((bitsPerSample - 1) << 16) | ((sample.channel | qualifiers) << 24));
+		words.push_back(0);														// samplePosition
+		words.push_back(isSigned ? 0x80000000u : 0);							// sampleLower
+		words.push_back(isSigned ? 0x7FFFFFFFu : UINT32_MAX);					// sampleUpper
+	}
+
+	return words;
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+
+/*
+* Class that reads KTX2 texture containers
+*
+* The file is mapped rather than read, and each mip level is handed out as a pointer into the mapping, so
+* pre-compressed payloads reach the staging buffer with a single copy. Only 2D textures without
+* supercompression are supported, which is what the offline encoder writes.
+*/
+class KTX2Image
+{
+public:
+
+	/*
+	* PUBLIC FRIEND METHODS
+	*/
+
+	/* @brief Swap implementation for KTX2Image class
+	*/
+	friend void swap(KTX2Image& imgA, KTX2Image& imgB)
+	{
+		using std::swap;
+
+		swap(imgA._file, imgB._file);
+		swap(imgA._format, imgB._format);
+		swap(imgA._width, imgB._width);
+		swap(imgA._height, imgB._height);
+		swap(imgA._levels, imgB._levels);
+	}
+
+
+
+	/*
+	* PUBLIC STRUCTS
+	*/
+
+	/* Location of one mip level's payload in the file
+	*/
+	struct Level
+	{
+		uint64_t byteOffset;
+		uint64_t byteLength;
+	};
+
+
+
+	/*
+	* PUBLIC STATIC METHODS
+	*/
+
+	/* @brief Writes a 2D texture to a KTX2 file
+	*
+	* @param format Block-compressed format of the payloads, see `is_supported_format`
+	* @param levels Payload of every mip level, level 0 first
+	* @throws std::invalid_argument if the format isn't supported
+	* @throws std::runtime_error if the file can't be written
+	*/
+	static void write(const std::string& filepath, VkFormat format, uint32_t width, uint32_t height, const std::vector<std::vector<uint8_t>>& levels);
+
+	/* @brief Checks if a format can be written. These are the BC1, BC3, BC5 and BC7 formats
+	*/
+	static bool is_supported_format(VkFormat format);
+
+
+
+	/*
+	* DELETED METHODS
+	*/
+
+	KTX2Image(const KTX2Image&) = delete;
+
+
+
+	/*
+	* CTORS / ASSIGNMENT
+	*/
+
+	KTX2Image();
+
+	/*
+	* @throws std::runtime_error if the file can't be mapped, isn't a KTX2 file, uses a feature that isn't supported or
+	* has a mip level whose size doesn't match its format and dimensions
+	*/
+	KTX2Image(const std::string& filepath);
+	KTX2Image(KTX2Image&& other) noexcept;
+	KTX2Image& operator=(KTX2Image other);
+	~KTX2Image();
+
+
+
+	/*
+	* PUBLIC CONST METHODS
+	*/
+
+	inline VkFormat format() const { return _format; }
+	inline uint32_t width() const { return _width; }
+	inline uint32_t height() const { return _height; }
+	inline uint32_t level_count() const { return static_cast<uint32_t>(_levels.size()); }
+
+	/* @brief Returns a pointer to a mip level's payload inside the mapped file
+	*/
+	inline const uint8_t* level_data(uint32_t level) const { return reinterpret_cast<const uint8_t*>(_file.data()) + _levels[level].byteOffset; }
+
+	/* @brief Returns the size of a mip level's payload in bytes
+	*/
+	inline size_t level_size(uint32_t level) const { return static_cast<size_t>(_levels[level].byteLength); }
+
+	/* @brief Returns the size of every payload together in bytes
+	*/
+	size_t size_in_bytes() const;
+
+private:
+
+	/*
+	* PRIVATE STATIC MEMBERS
+	*/
+
+	/* Bytes every KTX2 file starts with
+	*/
+	static constexpr uint8_t _IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+	/* Size of the fixed header and index that precede the level index
+	*/
+	static constexpr size_t _HEADER_SIZE = 80;
+
+
+
+	/*
+	* PRIVATE MEMBERS
+	*/
+
+	/* Mapped file the payloads point into
+	*/
+	MappedFile _file;
+
+	VkFormat _format;
+	uint32_t _width;
+	uint32_t _height;
+
+	/* Payload locations, level 0 first
+	*/
+	std::vector<Level> _levels;
+
+
+
+	/*
+	* PRIVATE STATIC METHODS
+	*/
+
+	/* @brief Builds the data format descriptor the spec requires for a block-compressed format
+	*/
+	static std::vector<uint32_t> _build_format_descriptor(VkFormat format);
+};
@@ -0,0 +1,118 @@
+#include "LoadTimeline.h"
+
+#include <algorithm>
+#include <iomanip>
+
+/*
+* CTORS
+*/
+
+LoadTimeline::LoadTimeline()
+	: _origin(Clock::now()),
+	_events({}),
+	_threadIndices({})
+{
+}
+
+LoadTimeline::Scope::Scope(LoadTimeline& timeline, std::string phase, std::string name)
+	: _timeline(timeline),
+	_phase(std::move(phase)),
+	_name(std::move(name)),
+	_start(Clock::now())
+{
+}
+
+LoadTimeline::Scope::~Scope()
+{
+	_timeline.record(_phase, _name, _start, Clock::now());
+}
+
+
+
+
+
+/*
+* PUBLIC METHOD DEFINITIONS
+*/
+
+void LoadTimeline::reset()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_origin = Clock::now();
+	_events.clear();
+	_threadIndices.clear();
+}
+
+void LoadTimeline::record(const std::string& phase, const std::string& name, Clock::time_point start, Clock::time_point end)
+{
+	using Milliseconds = std::chrono::duration<double, std::milli>;
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto threadIndex = _threadIndices.emplace(std::this_thread::get_id(), static_cast<uint32_t>(_threadIndices.size())).first->second;
+	_events.push_back({ phase, name, threadIndex, Milliseconds(start - _origin).count(), Milliseconds(end - start).count() });
+}
+
+
+
+
+
+/*
+* PUBLIC CONST METHOD DEFINITIONS
+*/
+
+std::vector<LoadTimeline::Event> LoadTimeline::events() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _events;
+}
+
+void LoadTimeline::print(std::ostream& out) const
+{
+	auto sorted = events();
+	std::stable_sort(sorted.begin(), sorted.end(), [](const Event& a, const Event& b) { return a.startMs < b.startMs; });
+
+	// Phases are listed in the order they started
+	std::vector<std::string> phases;
+	for (const auto& event : sorted)
+	{
+		if (std::find(phases.begin(), phases.end(), event.phase) == phases.end())
+		{
+			phases.push_back(event.phase);
+		}
+	}
+
+	double totalEnd = 0.0;
+	for (const auto& event : sorted)
+	{
+		totalEnd = std::max(totalEnd, event.startMs + event.durationMs);
+	}
+
+	out << std::fixed << std::setprecision(2);
+	out << "Startup timeline (" << totalEnd << " ms)" << std::endl;
+	for (const auto& phase : phases)
+	{
+		double phaseStart = totalEnd;
+		double phaseEnd = 0.0;
+		double busyMs = 0.0;
+		for (const auto& event : sorted)
+		{
+			if (event.phase == phase)
+			{
+				phaseStart = std::min(phaseStart, event.startMs);
+				phaseEnd = std::max(phaseEnd, event.startMs + event.durationMs);
+				busyMs += event.durationMs;
+			}
+		}
+
+		out << "  " << phase << ": " << phaseEnd - phaseStart << " ms wall, " << busyMs << " ms busy, starts at " << phaseStart << " ms" << std::endl;
+		for (const auto& event : sorted)
+		{
+			if (event.phase == phase)
+			{
+				out << "    [thread " << event.threadIndex << "] " << event.name << ": " << event.durationMs << " ms at " << event.startMs << " ms" << std::endl;
+			}
+		}
+	}
+
+	out << std::defaultfloat;
+}
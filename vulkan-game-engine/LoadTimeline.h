@@ -0,0 +1,135 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/*
+* Class that records how long each startup step took and on which thread
+*
+* Steps are grouped into phases. A phase's duration is the wall time from its first step starting to its last
+* step ending, so phases whose steps ran in parallel show up shorter than the sum of their steps.
+*/
+class LoadTimeline
+{
+public:
+
+	/*
+	* TYPEDEFS
+	*/
+
+	using Clock = std::chrono::steady_clock;
+
+
+
+	/*
+	* PUBLIC STRUCTS
+	*/
+
+	/* A single timed step
+	*/
+	struct Event
+	{
+		std::string phase;
+		std::string name;
+
+		/* Threads are numbered in the order they first recorded a step
+		*/
+		uint32_t threadIndex;
+
+		/* Start and duration in milliseconds, measured from when the timeline was reset
+		*/
+		double startMs;
+		double durationMs;
+	};
+
+	/* Records a step from its construction to its destruction
+	*/
+	class Scope
+	{
+	public:
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+		Scope(LoadTimeline& timeline, std::string phase, std::string name);
+		~Scope();
+
+	private:
+		LoadTimeline& _timeline;
+		std::string _phase;
+		std::string _name;
+		Clock::time_point _start;
+	};
+
+
+
+	/*
+	* DELETED METHODS
+	*/
+
+	LoadTimeline(const LoadTimeline&) = delete;
+	LoadTimeline& operator=(const LoadTimeline&) = delete;
+
+
+
+	/*
+	* CTORS
+	*/
+
+	LoadTimeline();
+
+
+
+	/*
+	* PUBLIC METHODS
+	*/
+
+	/* @brief Drops every recorded step and restarts the clock
+	*/
+	void reset();
+
+	/* @brief Records a step that ran between two points in time. Safe to call from any thread
+	*/
+	void record(const std::string& phase, const std::string& name, Clock::time_point start, Clock::time_point end);
+
+
+
+	/*
+	* PUBLIC CONST METHODS
+	*/
+
+	/* @brief Returns a copy of the recorded steps in the order they finished
+	*/
+	std::vector<Event> events() const;
+
+	/* @brief Prints every phase with its wall time followed by its steps
+	*/
+	void print(std::ostream& out) const;
+
+private:
+
+	/*
+	* PRIVATE MEMBERS
+	*/
+
+	/* Time the timeline was last reset
+	*/
+	Clock::time_point _origin;
+
+	/* Recorded steps
+	*/
+	std::vector<Event> _events;
+
+	/* Index given to each thread that recorded a step
+	*/
+	std::unordered_map<std::thread::id, uint32_t> _threadIndices;
+
+	/* Guards the steps and thread indices
+	*/
+	mutable std::mutex _mutex;
+};
@@ -0,0 +1,145 @@
+#include "MappedFile.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static constexpr intptr_t INVALID_FILE_HANDLE = -1;
+
+/*
+* CTORS / ASSIGNMENT DEFINITIONS
+*/
+
+MappedFile::MappedFile()
+	: _pData(nullptr),
+	_size(0),
+	_fileHandle(INVALID_FILE_HANDLE),
+	_mappingHandle(INVALID_FILE_HANDLE)
+{
+}
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& filepath)
+	: MappedFile()
+{
+	HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		throw std::runtime_error("Failed to open file " + filepath);
+	}
+	_fileHandle = reinterpret_cast<intptr_t>(file);
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize))
+	{
+		throw std::runtime_error("Failed to get size of file " + filepath);
+	}
+
+	_size = static_cast<size_t>(fileSize.QuadPart);
+	if (_size == 0)
+	{
+		return;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		throw std::runtime_error("Failed to map file " + filepath);
+	}
+	_mappingHandle = reinterpret_cast<intptr_t>(mapping);
+
+	_pData = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (_pData == nullptr)
+	{
+		throw std::runtime_error("Failed to map view of file " + filepath);
+	}
+}
+
+MappedFile::~MappedFile()
+{
+	if (_pData != nullptr)
+	{
+		UnmapViewOfFile(_pData);
+	}
+
+	if (_mappingHandle != INVALID_FILE_HANDLE)
+	{
+		CloseHandle(reinterpret_cast<HANDLE>(_mappingHandle));
+	}
+
+	if (_fileHandle != INVALID_FILE_HANDLE)
+	{
+		CloseHandle(reinterpret_cast<HANDLE>(_fileHandle));
+	}
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& filepath)
+	: MappedFile()
+{
+	int fd = open(filepath.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		throw std::runtime_error("Failed to open file " + filepath);
+	}
+	_fileHandle = fd;
+
+	struct stat fileStats;
+	if (fstat(fd, &fileStats) != 0)
+	{
+		throw std::runtime_error("Failed to get size of file " + filepath);
+	}
+
+	_size = static_cast<size_t>(fileStats.st_size);
+	if (_size == 0)
+	{
+		return;
+	}
+
+	void* pView = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (pView == MAP_FAILED)
+	{
+		throw std::runtime_error("Failed to map file " + filepath);
+	}
+
+	_pData = static_cast<const char*>(pView);
+	madvise(pView, _size, MADV_SEQUENTIAL);
+}
+
+MappedFile::~MappedFile()
+{
+	if (_pData != nullptr)
+	{
+		munmap(const_cast<char*>(_pData), _size);
+	}
+
+	if (_fileHandle != INVALID_FILE_HANDLE)
+	{
+		close(static_cast<int>(_fileHandle));
+	}
+}
+
+#endif
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+	: MappedFile()
+{
+	swap(*this, other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile other)
+{
+	swap(*this, other);
+	return *this;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+/*
+* Class that maps a whole file into memory for reading
+*/
+class MappedFile
+{
+public:
+
+	/*
+	* PUBLIC FRIEND METHODS
+	*/
+
+	/* @brief Swap implementation for MappedFile class
+	*/
+	friend void swap(MappedFile& fileA, MappedFile& fileB)
+	{
+		using std::swap;
+
+		swap(fileA._pData, fileB._pData);
+		swap(fileA._size, fileB._size);
+		swap(fileA._fileHandle, fileB._fileHandle);
+		swap(fileA._mappingHandle, fileB._mappingHandle);
+	}
+
+
+
+	/*
+	* DELETED METHODS
+	*/
+
+	MappedFile(const MappedFile&) = delete;
+
+
+
+	/*
+	* CTORS / ASSIGNMENT
+	*/
+
+	MappedFile();
+
+	/*
+	* @param filepath Path of the file to map
+	*
+	* @throws std::runtime_error if the file can't be opened or mapped
+	*/
+	MappedFile(const std::string& filepath);
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile other);
+	~MappedFile();
+
+
+
+	/*
+	* PUBLIC CONST METHODS
+	*/
+
+	/* @brief Returns pointer to the file contents, or nullptr for an empty file
+	*/
+	inline const char* data() const { return _pData; }
+
+	/* @brief Returns the file size in bytes
+	*/
+	inline size_t size() const { return _size; }
+
+private:
+
+	/*
+	* PRIVATE MEMBERS
+	*/
+
+	/* Start of the mapped view
+	*/
+	const char* _pData;
+
+	/* Size of the mapped view
+	*/
+	size_t _size;
+
+	/* OS handle to the open file. A HANDLE on Windows, a file descriptor elsewhere
+	*/
+	intptr_t _fileHandle;
+
+	/* OS handle to the file mapping. Only used on Windows
+	*/
+	intptr_t _mappingHandle;
+};
@@ -0,0 +1,391 @@
+#include "MemoryAllocator.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+/*
+* CTORS
+*/
+
+MemoryAllocator::MemoryAllocator(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkDeviceSize blockSize)
+	: _deviceHandle(logicalDevice),
+	_memProps({}),
+	_blockSize(blockSize),
+	_maxOrder(0),
+	_pools()
+{
+	if (_blockSize < MIN_ALLOCATION_SIZE || (_blockSize & (_blockSize - 1)) != 0)
+	{
+		throw std::invalid_argument("Memory block size must be a power of two of at least MIN_ALLOCATION_SIZE");
+	}
+
+	while (_order_size(_maxOrder) < _blockSize)
+	{
+		_maxOrder++;
+	}
+
+	vkGetPhysicalDeviceMemoryProperties(physicalDevice, &_memProps);
+}
+
+MemoryAllocator::~MemoryAllocator()
+{
+	for (auto& [key, pool] : _pools)
+	{
+		for (auto& block : pool.blocks)
+		{
+			if (block->pMappedData != nullptr)
+			{
+				vkUnmapMemory(_deviceHandle, block->memory);
+			}
+			vkFreeMemory(_deviceHandle, block->memory, nullptr);
+		}
+
+		for (auto& [memory, dedicated] : pool.dedicated)
+		{
+			if (dedicated.pMappedData != nullptr)
+			{
+				vkUnmapMemory(_deviceHandle, memory);
+			}
+			vkFreeMemory(_deviceHandle, memory, nullptr);
+		}
+	}
+}
+
+
+
+
+
+/*
+* PUBLIC METHOD DEFINITIONS
+*/
+
+MemoryAllocator::Allocation MemoryAllocator::allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags memPropFlags, bool isLinear)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	uint32_t memoryTypeIndex = _find_memory_type(requirements.memoryTypeBits, memPropFlags);
+	auto& pool = _pools[_pool_key(memoryTypeIndex, isLinear)];
+
+	// Anything larger than half a block would waste most of a block to rounding
+	VkDeviceSize alignedSize = std::max(requirements.size, requirements.alignment);
+	if (alignedSize > _blockSize / 2)
+	{
+		return _allocate_dedicated(pool, requirements, memoryTypeIndex, isLinear);
+	}
+
+	uint32_t order = _order_for(requirements.size, requirements.alignment);
+	VkDeviceSize offset = 0;
+
+	_Block* pBlock = nullptr;
+	for (auto& block : pool.blocks)
+	{
+		if (_allocate_from_block(*block, order, requirements.size, &offset))
+		{
+			pBlock = block.get();
+			break;
+		}
+	}
+
+	if (pBlock == nullptr)
+	{
+		auto newBlock = _create_block(memoryTypeIndex);
+		if (newBlock == nullptr)
+		{
+			// Heap can't fit another block, the resource may still fit on its own
+			return _allocate_dedicated(pool, requirements, memoryTypeIndex, isLinear);
+		}
+
+		_allocate_from_block(*newBlock, order, requirements.size, &offset);
+		pBlock = newBlock.get();
+		pool.blocks.push_back(std::move(newBlock));
+	}
+
+	Allocation allocation{};
+	allocation.memory = pBlock->memory;
+	allocation.offset = offset;
+	allocation.size = requirements.size;
+	allocation.pMappedData = (pBlock->pMappedData != nullptr) ? static_cast<char*>(pBlock->pMappedData) + offset : nullptr;
+	allocation.memoryTypeIndex = memoryTypeIndex;
+	allocation.isLinear = isLinear;
+	allocation.isDedicated = false;
+	return allocation;
+}
+
+void MemoryAllocator::free(const Allocation& allocation)
+{
+	if (allocation.memory == VK_NULL_HANDLE)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	auto poolSearch = _pools.find(_pool_key(allocation.memoryTypeIndex, allocation.isLinear));
+	if (poolSearch == _pools.end())
+	{
+		throw std::invalid_argument("Allocation doesn't belong to this allocator");
+	}
+	auto& pool = poolSearch->second;
+
+	if (allocation.isDedicated)
+	{
+		auto search = pool.dedicated.find(allocation.memory);
+		if (search == pool.dedicated.end())
+		{
+			throw std::invalid_argument("Dedicated allocation was already freed");
+		}
+
+		if (search->second.pMappedData != nullptr)
+		{
+			vkUnmapMemory(_deviceHandle, allocation.memory);
+		}
+		vkFreeMemory(_deviceHandle, allocation.memory, nullptr);
+		pool.dedicated.erase(search);
+		return;
+	}
+
+	auto blockSearch = std::find_if(pool.blocks.begin(), pool.blocks.end(), [&](const std::unique_ptr<_Block>& block) { return block->memory == allocation.memory; });
+	if (blockSearch == pool.blocks.end())
+	{
+		throw std::invalid_argument("Allocation's memory block was already released");
+	}
+
+	auto& block = **blockSearch;
+	_free_from_block(block, allocation.offset);
+
+	// Release empty blocks, but keep one around so alloc/free cycles don't hit the driver
+	bool blockIsEmpty = block.liveNodes.empty();
+	if (blockIsEmpty && pool.blocks.size() > 1)
+	{
+		if (block.pMappedData != nullptr)
+		{
+			vkUnmapMemory(_deviceHandle, block.memory);
+		}
+		vkFreeMemory(_deviceHandle, block.memory, nullptr);
+		pool.blocks.erase(blockSearch);
+	}
+}
+
+
+
+
+
+/*
+* PUBLIC CONST METHOD DEFINITIONS
+*/
+
+std::vector<MemoryAllocator::HeapStats> MemoryAllocator::heap_stats() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	std::unordered_map<uint32_t, HeapStats> statsByHeap;
+	std::unordered_map<uint32_t, VkDeviceSize> largestFreeByHeap;
+
+	for (const auto& [key, pool] : _pools)
+	{
+		uint32_t memoryTypeIndex = key >> 1;
+		uint32_t heapIndex = _memProps.memoryTypes[memoryTypeIndex].heapIndex;
+
+		auto& stats = statsByHeap[heapIndex];
+		stats.heapIndex = heapIndex;
+		stats.heapSize = _memProps.memoryHeaps[heapIndex].size;
+		auto& largestFree = largestFreeByHeap[heapIndex];
+
+		for (const auto& block : pool.blocks)
+		{
+			stats.blockCount++;
+			stats.reservedBytes += _blockSize;
+			stats.allocationCount += static_cast<uint32_t>(block->liveNodes.size());
+
+			for (const auto& [offset, node] : block->liveNodes)
+			{
+				stats.usedBytes += node.requestedSize;
+			}
+
+			for (uint32_t order = 0; order <= _maxOrder; ++order)
+			{
+				const auto& freeList = block->freeLists[order];
+				stats.freeBytes += freeList.size() * _order_size(order);
+				if (!freeList.empty())
+				{
+					largestFree = std::max(largestFree, _order_size(order));
+				}
+			}
+		}
+
+		for (const auto& [memory, dedicated] : pool.dedicated)
+		{
+			stats.dedicatedCount++;
+			stats.allocationCount++;
+			stats.reservedBytes += dedicated.size;
+			stats.usedBytes += dedicated.size;
+		}
+	}
+
+	std::vector<HeapStats> result;
+	for (auto& [heapIndex, stats] : statsByHeap)
+	{
+		// Free memory that can't be handed out as part of the largest free range
+		stats.fragmentedBytes = stats.freeBytes - largestFreeByHeap[heapIndex];
+		result.push_back(stats);
+	}
+
+	std::sort(result.begin(), result.end(), [](const HeapStats& a, const HeapStats& b) { return a.heapIndex < b.heapIndex; });
+	return result;
+}
+
+
+
+
+
+/*
+* PRIVATE METHOD DEFINITIONS
+*/
+
+std::unique_ptr<MemoryAllocator::_Block> MemoryAllocator::_create_block(uint32_t memoryTypeIndex)
+{
+	VkMemoryAllocateInfo allocInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocInfo.allocationSize = _blockSize;
+	allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+	auto block = std::make_unique<_Block>();
+	block->memory = VK_NULL_HANDLE;
+	block->pMappedData = nullptr;
+
+	if (vkAllocateMemory(_deviceHandle, &allocInfo, nullptr, &block->memory) != VK_SUCCESS)
+	{
+		return nullptr;
+	}
+
+	if (_is_host_visible(memoryTypeIndex))
+	{
+		vkMapMemory(_deviceHandle, block->memory, 0, VK_WHOLE_SIZE, 0, &block->pMappedData);
+	}
+
+	block->freeLists.resize(_maxOrder + 1);
+	block->freeLists[_maxOrder].insert(0);
+	return block;
+}
+
+MemoryAllocator::Allocation MemoryAllocator::_allocate_dedicated(_Pool& pool, const VkMemoryRequirements& requirements, uint32_t memoryTypeIndex, bool isLinear)
+{
+	VkMemoryAllocateInfo allocInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocInfo.allocationSize = requirements.size;
+	allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+	Allocation allocation{};
+	if (vkAllocateMemory(_deviceHandle, &allocInfo, nullptr, &allocation.memory) != VK_SUCCESS)
+	{
+		throw std::runtime_error("Failed to allocate device memory");
+	}
+
+	if (_is_host_visible(memoryTypeIndex))
+	{
+		vkMapMemory(_deviceHandle, allocation.memory, 0, VK_WHOLE_SIZE, 0, &allocation.pMappedData);
+	}
+
+	allocation.offset = 0;
+	allocation.size = requirements.size;
+	allocation.memoryTypeIndex = memoryTypeIndex;
+	allocation.isLinear = isLinear;
+	allocation.isDedicated = true;
+
+	pool.dedicated[allocation.memory] = { requirements.size, allocation.pMappedData };
+	return allocation;
+}
+
+bool MemoryAllocator::_allocate_from_block(_Block& block, uint32_t order, VkDeviceSize requestedSize, VkDeviceSize* pOffset)
+{
+	// Find the smallest free node that fits
+	uint32_t freeOrder = order;
+	while (freeOrder <= _maxOrder && block.freeLists[freeOrder].empty())
+	{
+		freeOrder++;
+	}
+
+	if (freeOrder > _maxOrder)
+	{
+		return false;
+	}
+
+	auto& freeList = block.freeLists[freeOrder];
+	VkDeviceSize offset = *freeList.begin();
+	freeList.erase(freeList.begin());
+
+	// Split it down to the requested order, keeping the upper halves free
+	while (freeOrder > order)
+	{
+		freeOrder--;
+		block.freeLists[freeOrder].insert(offset + _order_size(freeOrder));
+	}
+
+	block.liveNodes[offset] = { order, requestedSize };
+	*pOffset = offset;
+	return true;
+}
+
+void MemoryAllocator::_free_from_block(_Block& block, VkDeviceSize offset)
+{
+	// A stale free would otherwise take the node away from whoever was handed this offset next
+	auto search = block.liveNodes.find(offset);
+	if (search == block.liveNodes.end())
+	{
+		throw std::invalid_argument("Allocation was already freed");
+	}
+
+	uint32_t order = search->second.order;
+	block.liveNodes.erase(search);
+
+	// Merge with the buddy for as long as it is free
+	while (order < _maxOrder)
+	{
+		VkDeviceSize buddy = offset ^ _order_size(order);
+		if (block.freeLists[order].erase(buddy) == 0)
+		{
+			break;
+		}
+
+		offset = std::min(offset, buddy);
+		order++;
+	}
+
+	block.freeLists[order].insert(offset);
+}
+
+
+
+
+
+/*
+* PRIVATE CONST METHOD DEFINITIONS
+*/
+
+uint32_t MemoryAllocator::_find_memory_type(uint32_t typeMask, VkMemoryPropertyFlags memPropFlags) const
+{
+	for (uint32_t i = 0; i < _memProps.memoryTypeCount; i++)
+	{
+		if ((typeMask & (1 << i)) &&
+			(_memProps.memoryTypes[i].propertyFlags & memPropFlags) == memPropFlags)
+		{
+			return i;
+		}
+	}
+
+	throw std::runtime_error("Failed to find memory type for allocation");
+}
+
+uint32_t MemoryAllocator::_order_for(VkDeviceSize size, VkDeviceSize alignment) const
+{
+	// Nodes are aligned to their own size, so a node at least as large as the alignment is always aligned
+	VkDeviceSize nodeSize = std::max(size, alignment);
+
+	uint32_t order = 0;
+	while (_order_size(order) < nodeSize)
+	{
+		order++;
+	}
+
+	return order;
+}
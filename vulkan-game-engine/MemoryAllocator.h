@@ -0,0 +1,248 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+/*
+* Class that sub-allocates device memory out of large blocks, one set of blocks per memory type
+*
+* Each block is split with a buddy allocator, so alignment comes for free as long as it is a power of two.
+* Buffers and optimal tiling images are kept in separate blocks to avoid bufferImageGranularity conflicts.
+* Host visible blocks stay mapped for their whole lifetime.
+*/
+class MemoryAllocator
+{
+public:
+
+	/*
+	* PUBLIC STATIC CONSTANTS
+	*/
+
+	/* Default size of every memory block
+	*/
+	static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = 64ull * 1024 * 1024;
+
+	/* Smallest size handed out by a block, every allocation is rounded up to a power of two of at least this size
+	*/
+	static constexpr VkDeviceSize MIN_ALLOCATION_SIZE = 256;
+
+
+
+	/*
+	* PUBLIC STRUCTS
+	*/
+
+	/* Describes a range of device memory handed out by the allocator
+	*/
+	struct Allocation
+	{
+		VkDeviceMemory memory;
+		VkDeviceSize offset;
+		VkDeviceSize size;
+		void* pMappedData;
+		uint32_t memoryTypeIndex;
+		bool isLinear;
+		bool isDedicated;
+	};
+
+	/* Memory usage of a single heap
+	*/
+	struct HeapStats
+	{
+		uint32_t heapIndex;
+		VkDeviceSize heapSize;
+		uint32_t blockCount;
+		uint32_t dedicatedCount;
+		uint32_t allocationCount;
+		VkDeviceSize reservedBytes;
+		VkDeviceSize usedBytes;
+		VkDeviceSize freeBytes;
+		VkDeviceSize fragmentedBytes;
+	};
+
+
+
+	/*
+	* DELETED METHODS
+	*/
+
+	MemoryAllocator(const MemoryAllocator&) = delete;
+	MemoryAllocator& operator=(const MemoryAllocator&) = delete;
+
+
+
+	/*
+	* CTORS
+	*/
+
+	/*
+	* @param logicalDevice Device that memory is allocated from
+	* @param physicalDevice Physical device used to look up memory types
+	* @param blockSize Size of each memory block, must be a power of two
+	*/
+	MemoryAllocator(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkDeviceSize blockSize = DEFAULT_BLOCK_SIZE);
+	~MemoryAllocator();
+
+
+
+	/*
+	* PUBLIC METHODS
+	*/
+
+	/* @brief Allocates memory meeting the given requirements
+	*
+	* @param requirements Size, alignment and memory type mask of the resource
+	* @param memPropFlags Memory properties the memory type must have
+	* @param isLinear `true` for buffers and linear images, `false` for optimal tiling images
+	*
+	* @throws std::runtime_error if no memory type matches or the device is out of memory
+	*/
+	Allocation allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags memPropFlags, bool isLinear);
+
+	/* @brief Returns an allocation to its block. An empty allocation is ignored
+	*
+	* @throws std::invalid_argument if the allocation isn't live, for example because it was already freed
+	*/
+	void free(const Allocation& allocation);
+
+
+
+	/*
+	* PUBLIC CONST METHODS
+	*/
+
+	/* @brief Returns usage statistics for every heap that has memory allocated from it
+	*/
+	std::vector<HeapStats> heap_stats() const;
+
+private:
+
+	/*
+	* PRIVATE STRUCTS
+	*/
+
+	/* A live allocation inside a block
+	*/
+	struct _Node
+	{
+		uint32_t order;
+		VkDeviceSize requestedSize;
+	};
+
+	/* A single vkAllocateMemory call split into buddy nodes
+	*/
+	struct _Block
+	{
+		VkDeviceMemory memory;
+		void* pMappedData;
+		std::vector<std::set<VkDeviceSize>> freeLists;
+		std::unordered_map<VkDeviceSize, _Node> liveNodes;
+	};
+
+	/* A resource that got its own vkAllocateMemory call
+	*/
+	struct _Dedicated
+	{
+		VkDeviceSize size;
+		void* pMappedData;
+	};
+
+	/* All memory of a single memory type and resource kind
+	*/
+	struct _Pool
+	{
+		std::vector<std::unique_ptr<_Block>> blocks;
+		std::unordered_map<VkDeviceMemory, _Dedicated> dedicated;
+	};
+
+
+
+	/*
+	* PRIVATE MEMBERS
+	*/
+
+	/* Handle to logical device
+	*/
+	VkDevice _deviceHandle;
+
+	/* Memory types and heaps of the physical device
+	*/
+	VkPhysicalDeviceMemoryProperties _memProps;
+
+	/* Size of each block
+	*/
+	VkDeviceSize _blockSize;
+
+	/* Highest buddy order, a node of this order spans a whole block
+	*/
+	uint32_t _maxOrder;
+
+	/* Pools keyed by memory type and resource kind
+	*/
+	std::unordered_map<uint32_t, _Pool> _pools;
+
+	/* Guards every pool
+	*/
+	mutable std::mutex _mutex;
+
+
+
+	/*
+	* PRIVATE METHODS
+	*/
+
+	/* @brief Allocates and maps a new block for the given memory type. Returns nullptr if the device is out of memory
+	*/
+	std::unique_ptr<_Block> _create_block(uint32_t memoryTypeIndex);
+
+	/* @brief Gives a resource its own device memory
+	*/
+	Allocation _allocate_dedicated(_Pool& pool, const VkMemoryRequirements& requirements, uint32_t memoryTypeIndex, bool isLinear);
+
+	/* @brief Tries to carve a node of the given order out of a block. Returns `false` if the block is full
+	*/
+	bool _allocate_from_block(_Block& block, uint32_t order, VkDeviceSize requestedSize, VkDeviceSize* pOffset);
+
+	/* @brief Returns a node to a block, merging it with free buddies
+	*
+	* @throws std::invalid_argument if no live node starts at the offset
+	*/
+	void _free_from_block(_Block& block, VkDeviceSize offset);
+
+
+
+	/*
+	* PRIVATE CONST METHODS
+	*/
+
+	/* @brief Finds a memory type index that matches the mask and flags
+	*/
+	uint32_t _find_memory_type(uint32_t typeMask, VkMemoryPropertyFlags memPropFlags) const;
+
+	/* @brief Returns the smallest buddy order that fits the given size and alignment
+	*/
+	uint32_t _order_for(VkDeviceSize size, VkDeviceSize alignment) const;
+
+	/* @brief Returns the size of a node of the given order
+	*/
+	inline VkDeviceSize _order_size(uint32_t order) const { return MIN_ALLOCATION_SIZE << order; }
+
+	/* @brief Checks if the memory type is host visible and should be mapped
+	*/
+	inline bool _is_host_visible(uint32_t memoryTypeIndex) const { return (_memProps.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0; }
+
+
+
+	/*
+	* PRIVATE STATIC METHODS
+	*/
+
+	/* @brief Combines memory type index and resource kind into a pool key
+	*/
+	static inline uint32_t _pool_key(uint32_t memoryTypeIndex, bool isLinear) { return (memoryTypeIndex << 1) | (isLinear ? 1u : 0u); }
+};
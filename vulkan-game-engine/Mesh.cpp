@@ -1,6 +1,9 @@
 #include "Mesh.h"
 
+#include "MeshKernels.h"
+
 #include <algorithm>
+#include <cmath>
 
 /*
 * CTOR / ASSIGNMENT DEFINITIONS
@@ -8,44 +11,59 @@
 
 Mesh::Mesh()
 	: _vertices({}),
-	_indices({})
+	_indices({}),
+	_lods()
 {
 }
 
 Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t> indices)
 	: _vertices(vertices),
-	_indices(indices)
+	_indices(indices),
+	_lods()
+{
+}
+
+Mesh::Mesh(std::vector<Vertex>&& vertices, std::vector<uint32_t>&& indices)
+	: _vertices(std::move(vertices)),
+	_indices(std::move(indices)),
+	_lods()
 {
 }
 
 void Mesh::scale(float scalar)
 {
-	for (auto& vert : _vertices)
-	{
-		vert.scale(scalar);
-	}
+	MeshKernels::scale_positions(_vertices.data(), _vertices.size(), scalar);
+	_scale_lod_errors(std::abs(scalar));
 }
 
 void Mesh::rotate_x(float degrees)
 {
-	for (auto& vert : _vertices)
-	{
-		vert.rotate_x(degrees);
-	}
+	MeshKernels::rotate_positions(_vertices.data(), _vertices.size(), degrees, glm::vec3(1, 0, 0));
 }
 
 void Mesh::rotate_y(float degrees)
 {
-	for (auto& vert : _vertices)
-	{
-		vert.rotate_y(degrees);
-	}
+	MeshKernels::rotate_positions(_vertices.data(), _vertices.size(), degrees, glm::vec3(0, 1, 0));
 }
 
 void Mesh::rotate_z(float degrees)
 {
-	for (auto& vert : _vertices)
+	MeshKernels::rotate_positions(_vertices.data(), _vertices.size(), degrees, glm::vec3(0, 0, 1));
+}
+
+void Mesh::transform(const glm::mat4& matrix)
+{
+	MeshKernels::transform_positions(_vertices.data(), _vertices.size(), matrix);
+
+	// Errors are distances, the largest axis scale bounds how much they can grow
+	float maxScale = std::max({ glm::length(glm::vec3(matrix[0])), glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2])) });
+	_scale_lod_errors(maxScale);
+}
+
+void Mesh::_scale_lod_errors(float factor)
+{
+	for (auto& lod : _lods)
 	{
-		vert.rotate_z(degrees);
+		lod.error *= factor;
 	}
 }
\ No newline at end of file
@@ -11,6 +11,25 @@ class Mesh
 {
 public:
 
+	/*
+	* PUBLIC STRUCTS
+	*/
+
+	/* A simplified version of the mesh that indexes the same vertices
+	*/
+	struct Lod
+	{
+		/* Triangle list into the full vertex array
+		*/
+		std::vector<uint32_t> indices;
+
+		/* Upper bound on the distance, in mesh units, the simplified surface deviates from the full one
+		*/
+		float error;
+	};
+
+
+
 	/*
 	* CTORS / ASSIGNMENT
 	*/
@@ -23,12 +42,26 @@ public:
 	*/
 	Mesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t> indices);
 
+	/*
+	* @param vertices List of vertices, taken over without copying
+	* @param indices List of vertex indexes, taken over without copying
+	*/
+	Mesh(std::vector<Vertex>&& vertices, std::vector<uint32_t>&& indices);
+
 
 	void scale(float scalar);
 	void rotate_x(float degrees);
 	void rotate_y(float degrees);
 	void rotate_z(float degrees);
 
+	/* @brief Applies an affine transform to every vertex position
+	*/
+	void transform(const glm::mat4& matrix);
+
+	/* @brief Replaces the LOD chain, ordered from most to least detailed
+	*/
+	inline void set_lods(std::vector<Lod> lods) { _lods = std::move(lods); }
+
 
 
 	/*
@@ -51,6 +84,10 @@ public:
 	*/
 	inline size_t size_of_indices() const { return sizeof(_indices[0]) * _indices.size(); }
 
+	/* @brief Returns the simplified versions of the mesh, not counting the full index list itself
+	*/
+	inline const std::vector<Lod>& lods() const { return _lods; }
+
 	/* @brief Returns pointer to vertex data
 	*/
 	inline const Vertex* vertex_data() const { return _vertices.data(); }
@@ -66,5 +103,10 @@ private:
 	*/
 	std::vector<Vertex> _vertices;
 	std::vector<uint32_t> _indices;
+	std::vector<Lod> _lods;
+
+	/* @brief Keeps LOD errors in mesh units after the vertices were scaled
+	*/
+	void _scale_lod_errors(float factor);
 };
 
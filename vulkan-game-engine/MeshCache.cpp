@@ -0,0 +1,217 @@
+#include "MeshCache.h"
+
+#include "MeshKernels.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable<Vertex>::value, "Mesh caches store vertices as raw bytes");
+
+/*
+* CTORS / ASSIGNMENT DEFINITIONS
+*/
+
+MeshCache::MeshCache()
+	: _file(),
+	_pHeader(nullptr),
+	_pLods(nullptr)
+{
+}
+
+MeshCache::MeshCache(const std::string& cachePath)
+	: _file(cachePath),
+	_pHeader(nullptr),
+	_pLods(nullptr)
+{
+	if (_file.size() < sizeof(_Header))
+	{
+		throw std::runtime_error("Mesh cache " + cachePath + " is truncated");
+	}
+
+	_pHeader = reinterpret_cast<const _Header*>(_file.data());
+	if (_pHeader->magic != _MAGIC || _pHeader->version != VERSION || _pHeader->vertexSize != sizeof(Vertex))
+	{
+		throw std::runtime_error("Mesh cache " + cachePath + " was written by another version");
+	}
+
+	uint64_t lodTableOffset = sizeof(_Header) + _pHeader->vertexCount * sizeof(Vertex) + _pHeader->indexCount * sizeof(uint32_t);
+	uint64_t expectedSize = lodTableOffset + _pHeader->lodCount * sizeof(_LodEntry);
+	if (_file.size() < expectedSize)
+	{
+		throw std::runtime_error("Mesh cache " + cachePath + " is truncated");
+	}
+
+	_pLods = reinterpret_cast<const _LodEntry*>(_file.data() + lodTableOffset);
+	for (uint32_t i = 0; i < _pHeader->lodCount; ++i)
+	{
+		expectedSize += _pLods[i].indexCount * sizeof(uint32_t);
+	}
+
+	if (_file.size() != expectedSize)
+	{
+		throw std::runtime_error("Mesh cache " + cachePath + " is truncated");
+	}
+}
+
+MeshCache::MeshCache(MeshCache&& other) noexcept
+	: MeshCache()
+{
+	swap(*this, other);
+}
+
+MeshCache& MeshCache::operator=(MeshCache other)
+{
+	swap(*this, other);
+	return *this;
+}
+
+
+
+
+
+/*
+* PUBLIC STATIC METHOD DEFINITIONS
+*/
+
+std::string MeshCache::path_for(const std::string& sourcePath)
+{
+	return sourcePath + FILE_EXTENSION;
+}
+
+void MeshCache::write(const std::string& cachePath, const std::string& sourcePath, const Mesh& mesh)
+{
+	const auto& vertices = mesh.vertices();
+	const auto& indices = mesh.indices();
+
+	_Header header{};
+	header.magic = _MAGIC;
+	header.version = VERSION;
+	header.vertexSize = sizeof(Vertex);
+	header.vertexCount = vertices.size();
+	header.indexCount = indices.size();
+	header.lodCount = static_cast<uint32_t>(mesh.lods().size());
+	header.sourceSize = std::filesystem::file_size(sourcePath);
+	header.sourceWriteTime = _write_time(sourcePath);
+	header.sourceHash = _hash_file(sourcePath);
+
+	glm::vec3 boundsMin;
+	glm::vec3 boundsMax;
+	MeshKernels::compute_bounds(vertices.data(), vertices.size(), boundsMin, boundsMax);
+
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		header.boundsMin[axis] = boundsMin[axis];
+		header.boundsMax[axis] = boundsMax[axis];
+	}
+
+	// Written under a temporary name so an interrupted write never leaves a truncated cache behind
+	std::string tempPath = cachePath + ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(vertices.data()), mesh.size_of_vertices());
+		file.write(reinterpret_cast<const char*>(indices.data()), mesh.size_of_indices());
+
+		for (const auto& lod : mesh.lods())
+		{
+			_LodEntry entry{ static_cast<uint32_t>(lod.indices.size()), lod.error };
+			file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+		}
+
+		for (const auto& lod : mesh.lods())
+		{
+			file.write(reinterpret_cast<const char*>(lod.indices.data()), sizeof(uint32_t) * lod.indices.size());
+		}
+
+		if (!file)
+		{
+			throw std::runtime_error("Failed to write mesh cache " + tempPath);
+		}
+	}
+
+	std::filesystem::rename(tempPath, cachePath);
+}
+
+
+
+
+
+/*
+* PUBLIC CONST METHOD DEFINITIONS
+*/
+
+bool MeshCache::matches_source(const std::string& sourcePath) const
+{
+	std::error_code error;
+	uint64_t sourceSize = std::filesystem::file_size(sourcePath, error);
+	if (error || sourceSize != _pHeader->sourceSize || _write_time(sourcePath) != _pHeader->sourceWriteTime)
+	{
+		return false;
+	}
+
+	return _hash_file(sourcePath) == _pHeader->sourceHash;
+}
+
+Mesh MeshCache::to_mesh() const
+{
+	std::vector<Vertex> vertices(vertex_data(), vertex_data() + vertex_count());
+	std::vector<uint32_t> indices(index_data(), index_data() + index_count());
+
+	std::vector<Mesh::Lod> lods(lod_count());
+	auto pLodIndices = reinterpret_cast<const uint32_t*>(_pLods + lod_count());
+	for (size_t i = 0; i < lods.size(); ++i)
+	{
+		lods[i].indices.assign(pLodIndices, pLodIndices + _pLods[i].indexCount);
+		lods[i].error = _pLods[i].error;
+		pLodIndices += _pLods[i].indexCount;
+	}
+
+	Mesh mesh(std::move(vertices), std::move(indices));
+	mesh.set_lods(std::move(lods));
+	return mesh;
+}
+
+
+
+
+
+/*
+* PRIVATE STATIC METHOD DEFINITIONS
+*/
+
+uint64_t MeshCache::_hash_file(const std::string& filepath)
+{
+	static constexpr uint64_t PRIME = 0x100000001B3ull;
+
+	MappedFile file(filepath);
+	const char* pData = file.data();
+	size_t size = file.size();
+	uint64_t hash = 0xCBF29CE484222325ull ^ size;
+
+	// FNV style mixing over whole words, the tail is folded in byte by byte
+	size_t numWords = size / sizeof(uint64_t);
+	for (size_t i = 0; i < numWords; ++i)
+	{
+		uint64_t word;
+		memcpy(&word, pData + i * sizeof(uint64_t), sizeof(word));
+		hash = (hash ^ word) * PRIME;
+		hash ^= hash >> 29;
+	}
+
+	for (size_t i = numWords * sizeof(uint64_t); i < size; ++i)
+	{
+		hash = (hash ^ static_cast<uint8_t>(pData[i])) * PRIME;
+	}
+
+	return hash;
+}
+
+int64_t MeshCache::_write_time(const std::string& filepath)
+{
+	std::error_code error;
+	auto writeTime = std::filesystem::last_write_time(filepath, error);
+	return error ? 0 : static_cast<int64_t>(writeTime.time_since_epoch().count());
+}
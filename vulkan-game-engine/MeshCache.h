@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "MappedFile.h"
+#include "Mesh.h"
+
+/*
+* Class for a binary mesh file holding the final vertex and index arrays of an imported model
+*
+* Cache files live next to the model they were imported from and remember that file's size, write time and hash.
+* Loading one maps it into memory and reads the arrays in place, without any parsing.
+*/
+class MeshCache
+{
+public:
+
+	/*
+	* PUBLIC STATIC CONSTANTS
+	*/
+
+	/* Extension appended to the source path to name its cache file
+	*/
+	static constexpr const char* FILE_EXTENSION = ".meshcache";
+
+	/* Bumped whenever the file layout, the Vertex layout or the import passes change
+	*/
+	static constexpr uint32_t VERSION = 4;
+
+
+
+	/*
+	* PUBLIC FRIEND METHODS
+	*/
+
+	/* @brief Swap implementation for MeshCache class
+	*/
+	friend void swap(MeshCache& cacheA, MeshCache& cacheB)
+	{
+		using std::swap;
+
+		swap(cacheA._file, cacheB._file);
+		swap(cacheA._pHeader, cacheB._pHeader);
+		swap(cacheA._pLods, cacheB._pLods);
+	}
+
+
+
+	/*
+	* DELETED METHODS
+	*/
+
+	MeshCache(const MeshCache&) = delete;
+
+
+
+	/*
+	* CTORS / ASSIGNMENT
+	*/
+
+	MeshCache();
+
+	/*
+	* @param cachePath Path of the cache file to map
+	*
+	* @throws std::runtime_error if the file can't be mapped, is from another version or is truncated
+	*/
+	MeshCache(const std::string& cachePath);
+	MeshCache(MeshCache&& other) noexcept;
+	MeshCache& operator=(MeshCache other);
+
+
+
+	/*
+	* PUBLIC STATIC METHODS
+	*/
+
+	/* @brief Returns the path of the cache file belonging to a source file
+	*/
+	static std::string path_for(const std::string& sourcePath);
+
+	/* @brief Writes a mesh along with the size, write time and hash of the file it was imported from
+	*
+	* @throws std::runtime_error if the source can't be read or the cache can't be written
+	*/
+	static void write(const std::string& cachePath, const std::string& sourcePath, const Mesh& mesh);
+
+
+
+	/*
+	* PUBLIC CONST METHODS
+	*/
+
+	/* @brief Checks that the source file is unchanged since the cache was written. The hash is only computed if size and time match
+	*/
+	bool matches_source(const std::string& sourcePath) const;
+
+	/* @brief Copies the mapped arrays, LODs included, into a mesh
+	*/
+	Mesh to_mesh() const;
+
+	inline const Vertex* vertex_data() const { return reinterpret_cast<const Vertex*>(_file.data() + sizeof(_Header)); }
+	inline const uint32_t* index_data() const { return reinterpret_cast<const uint32_t*>(vertex_data() + _pHeader->vertexCount); }
+	inline size_t vertex_count() const { return static_cast<size_t>(_pHeader->vertexCount); }
+	inline size_t index_count() const { return static_cast<size_t>(_pHeader->indexCount); }
+	inline size_t lod_count() const { return static_cast<size_t>(_pHeader->lodCount); }
+	inline glm::vec3 bounds_min() const { return glm::vec3(_pHeader->boundsMin[0], _pHeader->boundsMin[1], _pHeader->boundsMin[2]); }
+	inline glm::vec3 bounds_max() const { return glm::vec3(_pHeader->boundsMax[0], _pHeader->boundsMax[1], _pHeader->boundsMax[2]); }
+
+private:
+
+	/*
+	* PRIVATE STRUCTS
+	*/
+
+	/* Layout of the start of the file. The vertex array follows directly, then the index array,
+	* then one _LodEntry per LOD and finally the index arrays of every LOD back to back
+	*/
+	struct _Header
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t vertexSize;
+		uint32_t lodCount;
+		uint64_t vertexCount;
+		uint64_t indexCount;
+		uint64_t sourceSize;
+		int64_t sourceWriteTime;
+		uint64_t sourceHash;
+		float boundsMin[3];
+		float boundsMax[3];
+	};
+
+	/* Size and error of a single LOD
+	*/
+	struct _LodEntry
+	{
+		uint32_t indexCount;
+		float error;
+	};
+
+
+
+	/*
+	* PRIVATE STATIC CONSTANTS
+	*/
+
+	static constexpr uint32_t _MAGIC = 0x4D455348; // "MESH"
+
+
+
+	/*
+	* PRIVATE MEMBERS
+	*/
+
+	/* Mapped cache file
+	*/
+	MappedFile _file;
+
+	/* Header at the start of the mapped file
+	*/
+	const _Header* _pHeader;
+
+	/* LOD table following the full index array
+	*/
+	const _LodEntry* _pLods;
+
+
+
+	/*
+	* PRIVATE STATIC METHODS
+	*/
+
+	/* @brief Hashes a whole file, eight bytes at a time
+	*/
+	static uint64_t _hash_file(const std::string& filepath);
+
+	/* @brief Returns the last write time of a file as a tick count
+	*/
+	static int64_t _write_time(const std::string& filepath);
+};
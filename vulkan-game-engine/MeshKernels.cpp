@@ -0,0 +1,173 @@
+#include "MeshKernels.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define MESH_KERNELS_AVX2
+#elif defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define MESH_KERNELS_SSE2
+#endif
+
+/*
+* The SIMD kernels read a position as four floats, the fourth being the first color channel, and write back only
+* the first three. That relies on the position being followed by more vertex data.
+*/
+static_assert(sizeof(Vertex) >= 4 * sizeof(float), "Vertex must have room for a four float position load");
+
+/* @brief Returns a pointer to the position of a vertex
+*/
+static inline float* position_ptr(Vertex* pVertex)
+{
+	return const_cast<float*>(&pVertex->position()[0]);
+}
+
+static inline const float* position_ptr(const Vertex* pVertex)
+{
+	return &pVertex->position()[0];
+}
+
+/* @brief Applies the affine part of a matrix to a single position
+*/
+static inline void transform_scalar(float* pPos, const glm::mat4& matrix)
+{
+	glm::vec3 pos(pPos[0], pPos[1], pPos[2]);
+	glm::vec3 result = glm::vec3(matrix[0]) * pos.x + glm::vec3(matrix[1]) * pos.y + glm::vec3(matrix[2]) * pos.z + glm::vec3(matrix[3]);
+	memcpy(pPos, &result[0], sizeof(float) * 3);
+}
+
+
+
+
+
+/*
+* PUBLIC STATIC METHOD DEFINITIONS
+*/
+
+const char* MeshKernels::instruction_set()
+{
+#if defined(MESH_KERNELS_AVX2)
+	return "AVX2";
+#elif defined(MESH_KERNELS_SSE2)
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
+
+void MeshKernels::transform_positions(Vertex* pVertices, size_t count, const glm::mat4& matrix)
+{
+	size_t i = 0;
+
+#if defined(MESH_KERNELS_AVX2)
+	// Two vertices per register, one in each 128-bit lane
+	__m256 col0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&matrix[0][0]));
+	__m256 col1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&matrix[1][0]));
+	__m256 col2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&matrix[2][0]));
+	__m256 col3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&matrix[3][0]));
+
+	for (; i + 2 <= count; i += 2)
+	{
+		float* pPosA = position_ptr(pVertices + i);
+		float* pPosB = position_ptr(pVertices + i + 1);
+		__m256 pos = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(pPosA)), _mm_loadu_ps(pPosB), 1);
+
+		// Separate multiply and add, FMA is a separate extension that AVX2 builds don't always enable
+		__m256 result = _mm256_add_ps(_mm256_mul_ps(col0, _mm256_permute_ps(pos, _MM_SHUFFLE(0, 0, 0, 0))), col3);
+		result = _mm256_add_ps(_mm256_mul_ps(col1, _mm256_permute_ps(pos, _MM_SHUFFLE(1, 1, 1, 1))), result);
+		result = _mm256_add_ps(_mm256_mul_ps(col2, _mm256_permute_ps(pos, _MM_SHUFFLE(2, 2, 2, 2))), result);
+
+		// Keep the fourth float of each lane, it belongs to the color
+		result = _mm256_blend_ps(result, pos, 0x88);
+		_mm_storeu_ps(pPosA, _mm256_castps256_ps128(result));
+		_mm_storeu_ps(pPosB, _mm256_extractf128_ps(result, 1));
+	}
+#elif defined(MESH_KERNELS_SSE2)
+	__m128 col0 = _mm_loadu_ps(&matrix[0][0]);
+	__m128 col1 = _mm_loadu_ps(&matrix[1][0]);
+	__m128 col2 = _mm_loadu_ps(&matrix[2][0]);
+	__m128 col3 = _mm_loadu_ps(&matrix[3][0]);
+	__m128 xyzMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+
+	for (; i < count; ++i)
+	{
+		float* pPos = position_ptr(pVertices + i);
+		__m128 pos = _mm_loadu_ps(pPos);
+
+		__m128 result = _mm_add_ps(_mm_mul_ps(col0, _mm_shuffle_ps(pos, pos, _MM_SHUFFLE(0, 0, 0, 0))), col3);
+		result = _mm_add_ps(_mm_mul_ps(col1, _mm_shuffle_ps(pos, pos, _MM_SHUFFLE(1, 1, 1, 1))), result);
+		result = _mm_add_ps(_mm_mul_ps(col2, _mm_shuffle_ps(pos, pos, _MM_SHUFFLE(2, 2, 2, 2))), result);
+
+		// Keep the fourth float, it belongs to the color
+		result = _mm_or_ps(_mm_and_ps(xyzMask, result), _mm_andnot_ps(xyzMask, pos));
+		_mm_storeu_ps(pPos, result);
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		transform_scalar(position_ptr(pVertices + i), matrix);
+	}
+}
+
+void MeshKernels::scale_positions(Vertex* pVertices, size_t count, float scalar)
+{
+	transform_positions(pVertices, count, glm::scale(glm::mat4(1.0f), glm::vec3(scalar)));
+}
+
+void MeshKernels::rotate_positions(Vertex* pVertices, size_t count, float degrees, const glm::vec3& axis)
+{
+	transform_positions(pVertices, count, glm::rotate(glm::mat4(1.0f), glm::radians(degrees), axis));
+}
+
+void MeshKernels::compute_bounds(const Vertex* pVertices, size_t count, glm::vec3& boundsMin, glm::vec3& boundsMax)
+{
+	if (count == 0)
+	{
+		boundsMin = glm::vec3(0.0f);
+		boundsMax = glm::vec3(0.0f);
+		return;
+	}
+
+	const float* pFirst = position_ptr(pVertices);
+	boundsMin = glm::vec3(pFirst[0], pFirst[1], pFirst[2]);
+	boundsMax = boundsMin;
+	size_t i = 1;
+
+#if defined(MESH_KERNELS_AVX2) || defined(MESH_KERNELS_SSE2)
+	// The fourth lane picks up color values and is simply discarded
+	__m128 lowest = _mm_loadu_ps(pFirst);
+	__m128 highest = lowest;
+	__m128 lowestB = lowest;
+	__m128 highestB = lowest;
+
+	// Two independent accumulators hide the latency of min/max
+	for (; i + 2 <= count; i += 2)
+	{
+		__m128 posA = _mm_loadu_ps(position_ptr(pVertices + i));
+		__m128 posB = _mm_loadu_ps(position_ptr(pVertices + i + 1));
+		lowest = _mm_min_ps(lowest, posA);
+		highest = _mm_max_ps(highest, posA);
+		lowestB = _mm_min_ps(lowestB, posB);
+		highestB = _mm_max_ps(highestB, posB);
+	}
+
+	float lows[4];
+	float highs[4];
+	_mm_storeu_ps(lows, _mm_min_ps(lowest, lowestB));
+	_mm_storeu_ps(highs, _mm_max_ps(highest, highestB));
+	boundsMin = glm::vec3(lows[0], lows[1], lows[2]);
+	boundsMax = glm::vec3(highs[0], highs[1], highs[2]);
+#endif
+
+	for (; i < count; ++i)
+	{
+		const float* pPos = position_ptr(pVertices + i);
+		glm::vec3 pos(pPos[0], pPos[1], pPos[2]);
+		boundsMin = glm::min(boundsMin, pos);
+		boundsMax = glm::max(boundsMax, pos);
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+
+#include "Vertex.h"
+
+/*
+* Class of batch kernels that process the positions of a whole vertex array at once
+*
+* Each operation builds its matrix once and then streams over the vertices with the widest instruction set the
+* build targets: AVX2 when compiled with it, SSE2 on any x86-64 build and plain scalar code elsewhere.
+*/
+class MeshKernels
+{
+public:
+
+	/*
+	* PUBLIC STATIC METHODS
+	*/
+
+	/* @brief Returns the name of the instruction set the kernels were compiled for
+	*/
+	static const char* instruction_set();
+
+	/* @brief Transforms every position by an affine matrix, leaving the other vertex attributes untouched
+	*
+	* @param pVertices Vertices to transform in place
+	* @param count Number of vertices
+	* @param matrix Affine transform. The bottom row is ignored
+	*/
+	static void transform_positions(Vertex* pVertices, size_t count, const glm::mat4& matrix);
+
+	/* @brief Multiplies every position by a scalar
+	*/
+	static void scale_positions(Vertex* pVertices, size_t count, float scalar);
+
+	/* @brief Rotates every position around one of the coordinate axes
+	*
+	* @param axis Unit axis of rotation
+	*/
+	static void rotate_positions(Vertex* pVertices, size_t count, float degrees, const glm::vec3& axis);
+
+	/* @brief Computes the axis aligned bounds of the positions. Empty arrays give zero bounds
+	*/
+	static void compute_bounds(const Vertex* pVertices, size_t count, glm::vec3& boundsMin, glm::vec3& boundsMax);
+};
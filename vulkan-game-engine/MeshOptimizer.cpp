@@ -0,0 +1,286 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <numeric>
+
+/*
+* PUBLIC STATIC METHOD DEFINITIONS
+*/
+
+Mesh MeshOptimizer::optimize(const Mesh& mesh, Report* pReport)
+{
+	std::vector<Vertex> vertices = mesh.vertices();
+	std::vector<uint32_t> indices = mesh.indices();
+	std::vector<uint32_t> clusters;
+
+	CacheStats before = analyze_vertex_cache(indices, vertices.size());
+
+	optimize_vertex_cache(indices, vertices.size(), &clusters);
+	optimize_overdraw(indices, vertices, clusters);
+	optimize_vertex_fetch(vertices, indices);
+
+	if (pReport != nullptr)
+	{
+		pReport->before = before;
+		pReport->after = analyze_vertex_cache(indices, vertices.size());
+		pReport->clusterCount = clusters.size();
+	}
+
+	return Mesh(std::move(vertices), std::move(indices));
+}
+
+void MeshOptimizer::optimize_vertex_cache(std::vector<uint32_t>& indices, size_t vertexCount, std::vector<uint32_t>* pClusters)
+{
+	size_t numTriangles = indices.size() / 3;
+	if (pClusters != nullptr)
+	{
+		pClusters->clear();
+	}
+
+	if (numTriangles == 0)
+	{
+		return;
+	}
+
+	// Triangles adjacent to each vertex, stored as one flat array with per-vertex offsets
+	std::vector<uint32_t> liveTriangles(vertexCount, 0);
+	for (size_t i = 0; i < numTriangles * 3; ++i)
+	{
+		liveTriangles[indices[i]]++;
+	}
+
+	std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+	for (size_t v = 0; v < vertexCount; ++v)
+	{
+		adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveTriangles[v];
+	}
+
+	std::vector<uint32_t> adjacency(adjacencyOffsets.back());
+	std::vector<uint32_t> fillOffsets(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+	for (size_t t = 0; t < numTriangles; ++t)
+	{
+		for (size_t c = 0; c < 3; ++c)
+		{
+			adjacency[fillOffsets[indices[3 * t + c]]++] = static_cast<uint32_t>(t);
+		}
+	}
+
+	std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+	std::vector<bool> isEmitted(numTriangles, false);
+	std::vector<uint32_t> deadEnds;
+	std::vector<uint32_t> candidates;
+	std::vector<uint32_t> output;
+	output.reserve(numTriangles * 3);
+
+	uint32_t timestamp = CACHE_SIZE + 1;
+	size_t scanCursor = 0;
+	int64_t fanningVertex = indices[0];
+	bool isNewCluster = true;
+
+	while (fanningVertex >= 0)
+	{
+		if (isNewCluster && pClusters != nullptr)
+		{
+			pClusters->push_back(static_cast<uint32_t>(output.size()));
+		}
+
+		// Emit every remaining triangle around the fanning vertex
+		candidates.clear();
+		for (uint32_t a = adjacencyOffsets[fanningVertex]; a < adjacencyOffsets[fanningVertex + 1]; ++a)
+		{
+			uint32_t triangle = adjacency[a];
+			if (isEmitted[triangle])
+			{
+				continue;
+			}
+
+			for (size_t c = 0; c < 3; ++c)
+			{
+				uint32_t vertex = indices[3 * triangle + c];
+				output.push_back(vertex);
+				deadEnds.push_back(vertex);
+				candidates.push_back(vertex);
+				liveTriangles[vertex]--;
+
+				if (timestamp - cacheTimestamps[vertex] > CACHE_SIZE)
+				{
+					cacheTimestamps[vertex] = timestamp++;
+				}
+			}
+
+			isEmitted[triangle] = true;
+		}
+
+		// Prefer the candidate that stays in cache the longest while its remaining triangles are emitted
+		fanningVertex = -1;
+		int64_t bestPriority = -1;
+		for (uint32_t vertex : candidates)
+		{
+			if (liveTriangles[vertex] == 0)
+			{
+				continue;
+			}
+
+			int64_t priority = 0;
+			if (timestamp - cacheTimestamps[vertex] + 2 * liveTriangles[vertex] <= CACHE_SIZE)
+			{
+				priority = timestamp - cacheTimestamps[vertex];
+			}
+
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				fanningVertex = vertex;
+			}
+		}
+
+		isNewCluster = false;
+		if (fanningVertex >= 0)
+		{
+			continue;
+		}
+
+		// Dead end. Fall back to recently used vertices, then to a linear scan. Either way the cache is cold, which starts a new cluster
+		isNewCluster = true;
+		while (!deadEnds.empty() && fanningVertex < 0)
+		{
+			uint32_t vertex = deadEnds.back();
+			deadEnds.pop_back();
+			if (liveTriangles[vertex] > 0)
+			{
+				fanningVertex = vertex;
+			}
+		}
+
+		while (fanningVertex < 0 && scanCursor < vertexCount)
+		{
+			if (liveTriangles[scanCursor] > 0)
+			{
+				fanningVertex = static_cast<int64_t>(scanCursor);
+			}
+			scanCursor++;
+		}
+	}
+
+	std::copy(output.begin(), output.end(), indices.begin());
+}
+
+void MeshOptimizer::optimize_overdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& clusters)
+{
+	if (clusters.size() < 2)
+	{
+		return;
+	}
+
+	size_t numIndices = indices.size() / 3 * 3;
+
+	glm::vec3 meshCenter(0.0f);
+	for (const auto& vertex : vertices)
+	{
+		meshCenter += vertex.position();
+	}
+	meshCenter /= static_cast<float>(std::max<size_t>(1, vertices.size()));
+
+	// Clusters whose area weighted center lies along their average normal are on the outside and occlude the rest
+	std::vector<float> sortKeys(clusters.size());
+	for (size_t c = 0; c < clusters.size(); ++c)
+	{
+		size_t begin = clusters[c];
+		size_t end = (c + 1 < clusters.size()) ? clusters[c + 1] : numIndices;
+
+		glm::vec3 center(0.0f);
+		glm::vec3 normal(0.0f);
+		float totalArea = 0.0f;
+
+		for (size_t i = begin; i < end; i += 3)
+		{
+			const glm::vec3& p0 = vertices[indices[i + 0]].position();
+			const glm::vec3& p1 = vertices[indices[i + 1]].position();
+			const glm::vec3& p2 = vertices[indices[i + 2]].position();
+
+			glm::vec3 areaNormal = glm::cross(p1 - p0, p2 - p0);
+			float area = glm::length(areaNormal);
+
+			center += (p0 + p1 + p2) * (area / 3.0f);
+			normal += areaNormal;
+			totalArea += area;
+		}
+
+		center = (totalArea > 0.0f) ? center / totalArea : meshCenter;
+		float normalLength = glm::length(normal);
+		sortKeys[c] = (normalLength > 0.0f) ? glm::dot(center - meshCenter, normal / normalLength) : 0.0f;
+	}
+
+	std::vector<uint32_t> order(clusters.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+	std::vector<uint32_t> sorted;
+	sorted.reserve(indices.size());
+	for (uint32_t c : order)
+	{
+		size_t begin = clusters[c];
+		size_t end = (c + 1 < clusters.size()) ? clusters[c + 1] : numIndices;
+		sorted.insert(sorted.end(), indices.begin() + begin, indices.begin() + end);
+	}
+
+	std::copy(sorted.begin(), sorted.end(), indices.begin());
+}
+
+void MeshOptimizer::optimize_vertex_fetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+{
+	static constexpr uint32_t UNASSIGNED = ~0u;
+
+	std::vector<uint32_t> remap(vertices.size(), UNASSIGNED);
+	std::vector<Vertex> reordered;
+	reordered.reserve(vertices.size());
+
+	for (auto& index : indices)
+	{
+		if (remap[index] == UNASSIGNED)
+		{
+			remap[index] = static_cast<uint32_t>(reordered.size());
+			reordered.push_back(vertices[index]);
+		}
+
+		index = remap[index];
+	}
+
+	vertices = std::move(reordered);
+}
+
+MeshOptimizer::CacheStats MeshOptimizer::analyze_vertex_cache(const std::vector<uint32_t>& indices, size_t vertexCount)
+{
+	CacheStats stats{};
+	size_t numTriangles = indices.size() / 3;
+	if (numTriangles == 0)
+	{
+		return stats;
+	}
+
+	// A vertex is cached if fewer than CACHE_SIZE misses happened since it was loaded
+	std::vector<uint32_t> loadTimes(vertexCount, 0);
+	std::vector<bool> isReferenced(vertexCount, false);
+	uint32_t misses = 0;
+	size_t numReferenced = 0;
+
+	for (size_t i = 0; i < numTriangles * 3; ++i)
+	{
+		uint32_t vertex = indices[i];
+		if (!isReferenced[vertex])
+		{
+			isReferenced[vertex] = true;
+			numReferenced++;
+		}
+
+		if (loadTimes[vertex] == 0 || misses + 1 - loadTimes[vertex] > CACHE_SIZE)
+		{
+			misses++;
+			loadTimes[vertex] = misses;
+		}
+	}
+
+	stats.acmr = static_cast<double>(misses) / numTriangles;
+	stats.atvr = static_cast<double>(misses) / numReferenced;
+	return stats;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Mesh.h"
+
+/*
+* Class of offline passes that reorder an imported mesh for the GPU vertex stage
+*
+* Triangles are reordered for the post-transform vertex cache with Tipsify, the resulting clusters are sorted to
+* draw outward facing geometry first, and finally vertices are reordered by first use so fetches stream linearly.
+*/
+class MeshOptimizer
+{
+public:
+
+	/*
+	* PUBLIC STATIC CONSTANTS
+	*/
+
+	/* Cache size the passes optimize and analyze for. Matches the FIFO size of common desktop GPUs
+	*/
+	static constexpr uint32_t CACHE_SIZE = 16;
+
+
+
+	/*
+	* PUBLIC STRUCTS
+	*/
+
+	/* Result of simulating a FIFO post-transform cache
+	*/
+	struct CacheStats
+	{
+		/* Average cache misses per triangle. 0.5 is the ideal for large regular meshes, 3 the worst case
+		*/
+		double acmr;
+
+		/* Average cache misses per referenced vertex. 1 is the ideal
+		*/
+		double atvr;
+	};
+
+	/* Cache statistics before and after optimizing
+	*/
+	struct Report
+	{
+		CacheStats before;
+		CacheStats after;
+		size_t clusterCount;
+	};
+
+
+
+	/*
+	* PUBLIC STATIC METHODS
+	*/
+
+	/* @brief Runs every pass on a copy of the mesh
+	*
+	* @param pReport If not null, receives the cache statistics before and after
+	*/
+	static Mesh optimize(const Mesh& mesh, Report* pReport = nullptr);
+
+	/* @brief Reorders triangles for the vertex cache
+	*
+	* @param pClusters If not null, receives the first index of every cluster the reordering broke the mesh into
+	*/
+	static void optimize_vertex_cache(std::vector<uint32_t>& indices, size_t vertexCount, std::vector<uint32_t>* pClusters = nullptr);
+
+	/* @brief Sorts clusters of triangles so the ones facing away from the mesh center are drawn first, keeping each cluster intact
+	*
+	* @param clusters First index of every cluster, as produced by optimize_vertex_cache
+	*/
+	static void optimize_overdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& clusters);
+
+	/* @brief Reorders vertices by first use in the index buffer and remaps the indices. Unreferenced vertices are dropped
+	*/
+	static void optimize_vertex_fetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+	/* @brief Simulates a FIFO cache of CACHE_SIZE entries over the index buffer
+	*/
+	static CacheStats analyze_vertex_cache(const std::vector<uint32_t>& indices, size_t vertexCount);
+};
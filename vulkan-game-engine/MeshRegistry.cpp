@@ -0,0 +1,127 @@
+#include "MeshRegistry.h"
+
+#include <stdexcept>
+
+#include "MeshKernels.h"
+
+/*
+* CTORS
+*/
+
+MeshRegistry::MeshRegistry(const Device& device)
+	: _device(device),
+	_entries({})
+{
+}
+
+MeshRegistry::~MeshRegistry()
+{
+}
+
+
+
+
+
+/*
+* PUBLIC METHOD DEFINITIONS
+*/
+
+MeshRegistry::Handle MeshRegistry::add(const Mesh& mesh, UploadBatch& uploads, VertexFormat vertexFormat)
+{
+	if (mesh.vertices().empty() || mesh.indices().empty())
+	{
+		throw std::invalid_argument("Can't register an empty mesh");
+	}
+
+	_Entry entry{};
+	entry.drawInfo.vertexFormat = vertexFormat;
+	entry.drawInfo.decode = QuantizedVertex::identity_decode();
+
+	if (vertexFormat == VertexFormat::QUANTIZED)
+	{
+		entry.vertexBuffer = _create_vertex_buffer(QuantizedVertex::quantize(mesh.vertices(), entry.drawInfo.decode), uploads);
+	}
+	else
+	{
+		entry.vertexBuffer = _create_vertex_buffer(mesh.vertices(), uploads);
+	}
+
+	// Every detail level shares one index buffer, the coarser levels follow the full mesh
+	std::vector<uint32_t> indices(mesh.indices());
+	entry.drawInfo.lods[0] = { 0, static_cast<uint32_t>(indices.size()), 0.0f };
+	entry.drawInfo.lodCount = 1;
+
+	for (const auto& lod : mesh.lods())
+	{
+		if (entry.drawInfo.lodCount == MAX_LODS || lod.indices.empty())
+		{
+			break;
+		}
+
+		entry.drawInfo.lods[entry.drawInfo.lodCount++] = { static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(lod.indices.size()), lod.error };
+		indices.insert(indices.end(), lod.indices.begin(), lod.indices.end());
+	}
+
+	// Meshes that fit 16-bit indices upload half the index data and read it faster
+	bool useShortIndices = mesh.vertices().size() < _SHORT_INDEX_VERTEX_LIMIT;
+	if (useShortIndices)
+	{
+		std::vector<uint16_t> shortIndices(indices.begin(), indices.end());
+		VkDeviceSize indexBytes = sizeof(uint16_t) * shortIndices.size();
+		entry.indexBuffer = Buffer(_device, Buffer::Type::INDEX, indexBytes);
+		uploads.upload_buffer(entry.indexBuffer, shortIndices.data(), indexBytes);
+	}
+	else
+	{
+		VkDeviceSize indexBytes = sizeof(uint32_t) * indices.size();
+		entry.indexBuffer = Buffer(_device, Buffer::Type::INDEX, indexBytes);
+		uploads.upload_buffer(entry.indexBuffer, indices.data(), indexBytes);
+	}
+
+	// LOD selection needs the mesh's extent, the box center and farthest corner give a cheap enclosing sphere
+	glm::vec3 boundsMin, boundsMax;
+	MeshKernels::compute_bounds(mesh.vertices().data(), mesh.vertices().size(), boundsMin, boundsMax);
+	glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+	entry.drawInfo.boundingSphere = glm::vec4(center, glm::length(boundsMax - center));
+
+	// Meshlet ranges index the full detail level, which starts the index buffer
+	auto meshlets = MeshletBuilder::build(mesh);
+	VkDeviceSize meshletBytes = sizeof(MeshletBuilder::Meshlet) * meshlets.size();
+	entry.meshletBuffer = Buffer(_device, Buffer::Type::STORAGE, meshletBytes);
+	uploads.upload_buffer(entry.meshletBuffer, meshlets.data(), meshletBytes);
+	entry.drawInfo.meshletBuffer = entry.meshletBuffer.handle();
+	entry.drawInfo.meshletCount = static_cast<uint32_t>(meshlets.size());
+
+	entry.drawInfo.vertexBuffer = entry.vertexBuffer.handle();
+	entry.drawInfo.indexBuffer = entry.indexBuffer.handle();
+	entry.drawInfo.vertexBufferOffset = 0;
+	entry.drawInfo.indexBufferOffset = 0;
+	entry.drawInfo.indexType = useShortIndices ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+	entry.drawInfo.indexCount = entry.drawInfo.lods[0].indexCount;
+	entry.drawInfo.firstIndex = 0;
+	entry.drawInfo.vertexOffset = 0;
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_entries.push_back(std::move(entry));
+	return static_cast<Handle>(_entries.size() - 1);
+}
+
+
+
+
+
+/*
+* PUBLIC CONST METHOD DEFINITIONS
+*/
+
+MeshRegistry::DrawInfo MeshRegistry::draw_info(Handle handle) const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _entries.at(handle).drawInfo;
+}
+
+size_t MeshRegistry::size() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _entries.size();
+}
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <mutex>
+#include <vector>
+
+#include "Device.h"
+#include "Buffer.h"
+#include "Mesh.h"
+#include "MeshletBuilder.h"
+#include "QuantizedVertex.h"
+#include "UploadBatch.h"
+
+/*
+* Class that owns the GPU buffers of every mesh asset
+*
+* Each mesh is uploaded once and referenced by handle, so any number of renderers can draw it
+* without their own copy of the vertex and index data. Meshes are immutable once added.
+*/
+class MeshRegistry
+{
+public:
+
+	/*
+	* TYPEDEFS
+	*/
+
+	using Handle = uint32_t;
+
+
+
+	/*
+	* PUBLIC STATIC CONSTANTS
+	*/
+
+	static constexpr Handle INVALID_HANDLE = UINT32_MAX;
+
+	/* Most detail levels a draw info can hold, the full mesh included
+	*/
+	static constexpr uint32_t MAX_LODS = 8;
+
+
+
+	/*
+	* PUBLIC STRUCTS
+	*/
+
+	/* Index range of one detail level inside the mesh's index buffer
+	*/
+	struct LodRange
+	{
+		uint32_t firstIndex;
+		uint32_t indexCount;
+
+		/* Geometric error of the level in mesh units
+		*/
+		float error;
+	};
+
+	/* Everything needed to bind and draw a mesh, cached so the draw path never touches the mesh itself
+	*/
+	struct DrawInfo
+	{
+		VkBuffer vertexBuffer;
+		VkBuffer indexBuffer;
+		VkDeviceSize vertexBufferOffset;
+		VkDeviceSize indexBufferOffset;
+		VkIndexType indexType;
+		uint32_t indexCount;
+		uint32_t firstIndex;
+		int32_t vertexOffset;
+		VertexFormat vertexFormat;
+		QuantizedVertex::Decode decode;
+
+		/* Detail levels from finest to coarsest. The first one is the full mesh
+		*/
+		std::array<LodRange, MAX_LODS> lods;
+		uint32_t lodCount;
+
+		/* Center and radius of a sphere enclosing the mesh, in mesh units
+		*/
+		glm::vec4 boundingSphere;
+
+		/* Storage buffer of MeshletBuilder::Meshlet entries covering the full detail level, read by the cull pass
+		*/
+		VkBuffer meshletBuffer;
+		uint32_t meshletCount;
+	};
+
+
+
+	/*
+	* DELETED METHODS
+	*/
+
+	MeshRegistry(const MeshRegistry&) = delete;
+	MeshRegistry& operator=(const MeshRegistry&) = delete;
+
+
+
+	/*
+	* CTORS
+	*/
+
+	/*
+	* @param device Device that owns the mesh buffers
+	*/
+	MeshRegistry(const Device& device);
+	~MeshRegistry();
+
+
+
+	/*
+	* PUBLIC METHODS
+	*/
+
+	/* @brief Creates GPU buffers for a mesh and records their upload
+	*
+	* The mesh's LOD index lists are appended after its own indices in the same buffer. Levels beyond MAX_LODS are dropped.
+	* The full detail level is also split into meshlets whose bounds are uploaded to a storage buffer
+	*
+	* @param mesh Mesh to register, its data is copied into staging memory immediately
+	* @param uploads Batch the upload is recorded into. The mesh can't be drawn until the batch has completed
+	* @param vertexFormat Layout the vertices are stored in on the GPU. Quantized meshes carry their decode transforms in the draw info
+	* @returns Handle used to look the mesh up
+	*/
+	Handle add(const Mesh& mesh, UploadBatch& uploads, VertexFormat vertexFormat = VertexFormat::FULL);
+
+
+
+	/*
+	* PUBLIC CONST METHODS
+	*/
+
+	/* @brief Returns the cached draw parameters of a mesh
+	*
+	* @throws std::out_of_range if the handle is invalid
+	*/
+	DrawInfo draw_info(Handle handle) const;
+
+	/* @brief Returns the number of registered meshes
+	*/
+	size_t size() const;
+
+private:
+
+	/*
+	* PRIVATE STRUCTS
+	*/
+
+	/* GPU data of a single mesh
+	*/
+	struct _Entry
+	{
+		Buffer vertexBuffer;
+		Buffer indexBuffer;
+		Buffer meshletBuffer;
+		DrawInfo drawInfo;
+	};
+
+
+
+	/*
+	* PRIVATE STATIC CONSTANTS
+	*/
+
+	/* Meshes with fewer vertices than this are drawn with 16-bit indices
+	*/
+	static constexpr size_t _SHORT_INDEX_VERTEX_LIMIT = 1 << 16;
+
+
+
+	/*
+	* PRIVATE MEMBERS
+	*/
+
+	/* Device that owns the mesh buffers
+	*/
+	Device _device;
+
+	/* Registered meshes, indexed by handle
+	*/
+	std::vector<_Entry> _entries;
+
+	/* Guards the entry list
+	*/
+	mutable std::mutex _mutex;
+
+
+
+	/*
+	* PRIVATE METHODS
+	*/
+
+	/* @brief Creates a vertex buffer sized by the vertex type's layout and records its upload
+	*/
+	template<typename V>
+	Buffer _create_vertex_buffer(const std::vector<V>& vertices, UploadBatch& uploads)
+	{
+		VkDeviceSize vertexBytes = static_cast<VkDeviceSize>(V::Layout::STRIDE) * vertices.size();
+		Buffer vertexBuffer(_device, Buffer::Type::VERTEX, vertexBytes);
+		uploads.upload_buffer(vertexBuffer, vertices.data(), vertexBytes);
+		return vertexBuffer;
+	}
+};
@@ -0,0 +1,344 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+/* @brief Packs an undirected edge into a single key
+*/
+static inline uint64_t edge_key(uint32_t a, uint32_t b)
+{
+	return (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+}
+
+/*
+* PUBLIC STATIC METHOD DEFINITIONS
+*/
+
+std::vector<Mesh::Lod> MeshSimplifier::build_lod_chain(const Mesh& mesh)
+{
+	std::vector<Mesh::Lod> lods;
+	const std::vector<uint32_t>* pSource = &mesh.indices();
+	float error = 0.0f;
+
+	while (lods.size() < MAX_LODS)
+	{
+		size_t sourceCount = pSource->size();
+		size_t targetCount = static_cast<size_t>(sourceCount / 3 * LOD_REDUCTION) * 3;
+		if (targetCount < 3)
+		{
+			break;
+		}
+
+		// Levels simplify the previous level, so each error only measures distance to the parent. Summing them
+		// bounds the distance to the original mesh from above
+		float levelError = 0.0f;
+		auto indices = simplify(mesh.vertices(), *pSource, targetCount, levelError);
+
+		// A level that barely shrank costs memory without saving any work
+		if (indices.empty() || indices.size() > sourceCount * 9 / 10)
+		{
+			break;
+		}
+
+		error += levelError;
+		lods.push_back({ std::move(indices), error });
+		pSource = &lods.back().indices;
+	}
+
+	return lods;
+}
+
+std::vector<uint32_t> MeshSimplifier::simplify(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, size_t targetIndexCount, float& error)
+{
+	std::vector<uint32_t> result(indices.begin(), indices.begin() + indices.size() / 3 * 3);
+	std::vector<bool> isLocked = _find_locked_vertices(vertices, result);
+	double maxCost = 0.0;
+
+	std::vector<_Quadric> quadrics;
+	std::vector<uint32_t> adjacencyOffsets;
+	std::vector<uint32_t> adjacency;
+	std::vector<_Collapse> collapses;
+	std::vector<uint32_t> remap(vertices.size());
+	std::vector<bool> isTouched;
+
+	while (result.size() > targetIndexCount)
+	{
+		size_t numTriangles = result.size() / 3;
+
+		quadrics.assign(vertices.size(), _Quadric{});
+		_accumulate_quadrics(vertices, result, quadrics);
+
+		// Triangles around each vertex, stored flat with per-vertex offsets
+		adjacencyOffsets.assign(vertices.size() + 1, 0);
+		for (uint32_t index : result)
+		{
+			adjacencyOffsets[index + 1]++;
+		}
+		for (size_t v = 0; v < vertices.size(); ++v)
+		{
+			adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+		}
+
+		adjacency.resize(result.size());
+		std::vector<uint32_t> fillOffsets(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+		for (size_t i = 0; i < result.size(); ++i)
+		{
+			adjacency[fillOffsets[result[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+
+		// Every edge can collapse either way, onto the endpoint that keeps the surface closest
+		collapses.clear();
+		for (size_t t = 0; t < numTriangles; ++t)
+		{
+			for (size_t e = 0; e < 3; ++e)
+			{
+				uint32_t a = result[3 * t + e];
+				uint32_t b = result[3 * t + (e + 1) % 3];
+
+				for (auto [from, to] : { std::pair<uint32_t, uint32_t>{ a, b }, std::pair<uint32_t, uint32_t>{ b, a } })
+				{
+					if (isLocked[from])
+					{
+						continue;
+					}
+
+					_Quadric combined = quadrics[from];
+					const _Quadric& other = quadrics[to];
+					combined.a2 += other.a2; combined.ab += other.ab; combined.ac += other.ac; combined.ad += other.ad;
+					combined.b2 += other.b2; combined.bc += other.bc; combined.bd += other.bd;
+					combined.c2 += other.c2; combined.cd += other.cd;
+					combined.d2 += other.d2;
+					combined.weight += other.weight;
+
+					double cost = _evaluate(combined, vertices[to].position());
+					collapses.push_back({ from, to, combined.weight > 0.0 ? cost / combined.weight : 0.0 });
+				}
+			}
+		}
+
+		std::sort(collapses.begin(), collapses.end(), [](const _Collapse& a, const _Collapse& b) { return a.cost < b.cost; });
+
+		// Collapse the cheapest edges whose neighborhoods don't overlap, so each flip test sees final positions
+		for (size_t v = 0; v < vertices.size(); ++v)
+		{
+			remap[v] = static_cast<uint32_t>(v);
+		}
+		isTouched.assign(vertices.size(), false);
+
+		size_t trianglesToRemove = (result.size() - targetIndexCount) / 3;
+		size_t trianglesRemoved = 0;
+		size_t numCollapsed = 0;
+
+		for (const auto& collapse : collapses)
+		{
+			if (trianglesRemoved >= trianglesToRemove)
+			{
+				break;
+			}
+
+			if (isTouched[collapse.from] || isTouched[collapse.to])
+			{
+				continue;
+			}
+
+			if (_flips_triangles(vertices, result, adjacencyOffsets, adjacency, collapse.from, collapse.to))
+			{
+				continue;
+			}
+
+			for (uint32_t a = adjacencyOffsets[collapse.from]; a < adjacencyOffsets[collapse.from + 1]; ++a)
+			{
+				uint32_t triangle = adjacency[a];
+				bool hasTarget = false;
+				for (size_t c = 0; c < 3; ++c)
+				{
+					isTouched[result[3 * triangle + c]] = true;
+					hasTarget |= result[3 * triangle + c] == collapse.to;
+				}
+				trianglesRemoved += hasTarget ? 1 : 0;
+			}
+
+			remap[collapse.from] = collapse.to;
+			maxCost = std::max(maxCost, collapse.cost);
+			numCollapsed++;
+		}
+
+		if (numCollapsed == 0)
+		{
+			break;
+		}
+
+		// Apply the collapses and drop the triangles they made degenerate
+		size_t writeIndex = 0;
+		for (size_t t = 0; t < numTriangles; ++t)
+		{
+			uint32_t a = remap[result[3 * t + 0]];
+			uint32_t b = remap[result[3 * t + 1]];
+			uint32_t c = remap[result[3 * t + 2]];
+			if (a == b || b == c || c == a)
+			{
+				continue;
+			}
+
+			result[writeIndex++] = a;
+			result[writeIndex++] = b;
+			result[writeIndex++] = c;
+		}
+		result.resize(writeIndex);
+	}
+
+	error = static_cast<float>(std::sqrt(maxCost));
+	return result;
+}
+
+
+
+
+
+/*
+* PRIVATE STATIC METHOD DEFINITIONS
+*/
+
+std::vector<bool> MeshSimplifier::_find_locked_vertices(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+{
+	std::vector<bool> isLocked(vertices.size(), false);
+
+	// Vertices that share a position differ in another attribute. Moving one would tear the seam open
+	struct PositionHash
+	{
+		size_t operator()(const glm::vec3& position) const
+		{
+			uint32_t bits[3];
+			memcpy(bits, &position, sizeof(bits));
+			return (static_cast<size_t>(bits[0]) * 73856093u) ^ (static_cast<size_t>(bits[1]) * 19349663u) ^ (static_cast<size_t>(bits[2]) * 83492791u);
+		}
+	};
+
+	std::unordered_map<glm::vec3, uint32_t, PositionHash> firstAtPosition;
+	firstAtPosition.reserve(vertices.size());
+	std::vector<uint32_t> welded(vertices.size());
+
+	for (size_t v = 0; v < vertices.size(); ++v)
+	{
+		auto [it, isNew] = firstAtPosition.emplace(vertices[v].position(), static_cast<uint32_t>(v));
+		welded[v] = it->second;
+		if (!isNew)
+		{
+			isLocked[v] = true;
+			isLocked[it->second] = true;
+		}
+	}
+
+	// Edges used by a single triangle, once seams are welded, are open borders
+	std::unordered_map<uint64_t, uint32_t> edgeUses;
+	edgeUses.reserve(indices.size());
+	for (size_t t = 0; t < indices.size() / 3; ++t)
+	{
+		for (size_t e = 0; e < 3; ++e)
+		{
+			edgeUses[edge_key(welded[indices[3 * t + e]], welded[indices[3 * t + (e + 1) % 3]])]++;
+		}
+	}
+
+	for (size_t t = 0; t < indices.size() / 3; ++t)
+	{
+		for (size_t e = 0; e < 3; ++e)
+		{
+			uint32_t a = indices[3 * t + e];
+			uint32_t b = indices[3 * t + (e + 1) % 3];
+			if (edgeUses[edge_key(welded[a], welded[b])] == 1)
+			{
+				isLocked[a] = true;
+				isLocked[b] = true;
+			}
+		}
+	}
+
+	return isLocked;
+}
+
+void MeshSimplifier::_accumulate_quadrics(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, std::vector<_Quadric>& quadrics)
+{
+	for (size_t t = 0; t < indices.size() / 3; ++t)
+	{
+		glm::dvec3 p0 = vertices[indices[3 * t + 0]].position();
+		glm::dvec3 p1 = vertices[indices[3 * t + 1]].position();
+		glm::dvec3 p2 = vertices[indices[3 * t + 2]].position();
+
+		glm::dvec3 normal = glm::cross(p1 - p0, p2 - p0);
+		double doubleArea = glm::length(normal);
+		if (doubleArea <= 0.0)
+		{
+			continue;
+		}
+
+		normal /= doubleArea;
+		double d = -glm::dot(normal, p0);
+		double w = doubleArea * 0.5;
+
+		_Quadric plane{
+			normal.x * normal.x * w, normal.x * normal.y * w, normal.x * normal.z * w, normal.x * d * w,
+			normal.y * normal.y * w, normal.y * normal.z * w, normal.y * d * w,
+			normal.z * normal.z * w, normal.z * d * w,
+			d * d * w,
+			w
+		};
+
+		for (size_t c = 0; c < 3; ++c)
+		{
+			_Quadric& q = quadrics[indices[3 * t + c]];
+			q.a2 += plane.a2; q.ab += plane.ab; q.ac += plane.ac; q.ad += plane.ad;
+			q.b2 += plane.b2; q.bc += plane.bc; q.bd += plane.bd;
+			q.c2 += plane.c2; q.cd += plane.cd;
+			q.d2 += plane.d2;
+			q.weight += plane.weight;
+		}
+	}
+}
+
+double MeshSimplifier::_evaluate(const _Quadric& q, const glm::vec3& point)
+{
+	double x = point.x;
+	double y = point.y;
+	double z = point.z;
+
+	double result = q.a2 * x * x + q.b2 * y * y + q.c2 * z * z + q.d2
+		+ 2.0 * (q.ab * x * y + q.ac * x * z + q.bc * y * z)
+		+ 2.0 * (q.ad * x + q.bd * y + q.cd * z);
+
+	return std::max(result, 0.0);
+}
+
+bool MeshSimplifier::_flips_triangles(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+	const std::vector<uint32_t>& adjacencyOffsets, const std::vector<uint32_t>& adjacency, uint32_t from, uint32_t to)
+{
+	const glm::vec3& target = vertices[to].position();
+
+	for (uint32_t a = adjacencyOffsets[from]; a < adjacencyOffsets[from + 1]; ++a)
+	{
+		const uint32_t* pTriangle = &indices[3 * adjacency[a]];
+		if (pTriangle[0] == to || pTriangle[1] == to || pTriangle[2] == to)
+		{
+			continue;
+		}
+
+		glm::vec3 before[3];
+		glm::vec3 after[3];
+		for (size_t c = 0; c < 3; ++c)
+		{
+			before[c] = vertices[pTriangle[c]].position();
+			after[c] = (pTriangle[c] == from) ? target : before[c];
+		}
+
+		glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+		glm::vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+		if (glm::dot(normalBefore, normalAfter) <= 0.0f)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Mesh.h"
+
+/*
+* Class implementing quadric error metric simplification for LOD generation
+*
+* Edges are collapsed onto one of their existing endpoints, so every level indexes the original vertex
+* buffer. Vertices on open borders and on attribute seams are locked to keep outlines and UVs intact.
+*/
+class MeshSimplifier
+{
+public:
+
+	/*
+	* PUBLIC STATIC CONSTANTS
+	*/
+
+	/* Most simplified levels generated below the full mesh
+	*/
+	static constexpr uint32_t MAX_LODS = 7;
+
+	/* Each level aims for this fraction of the triangles of the level above it
+	*/
+	static constexpr float LOD_REDUCTION = 0.5f;
+
+
+
+	/*
+	* PUBLIC STATIC METHODS
+	*/
+
+	/* @brief Generates progressively simpler LODs until MAX_LODS is reached or simplification stalls
+	*/
+	static std::vector<Mesh::Lod> build_lod_chain(const Mesh& mesh);
+
+	/* @brief Collapses edges until the index count is at most `targetIndexCount` or nothing more can be collapsed
+	*
+	* @param vertices Vertices the indices refer to
+	* @param indices Triangle list to simplify
+	* @param targetIndexCount Index count to aim for
+	* @param[out] error Largest distance, in mesh units, any collapse moved the surface
+	* @returns The simplified triangle list
+	*/
+	static std::vector<uint32_t> simplify(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, size_t targetIndexCount, float& error);
+
+private:
+
+	/*
+	* PRIVATE STRUCTS
+	*/
+
+	/* Symmetric 4x4 quadric, accumulated from area weighted triangle planes
+	*/
+	struct _Quadric
+	{
+		double a2, ab, ac, ad;
+		double b2, bc, bd;
+		double c2, cd;
+		double d2;
+		double weight;
+	};
+
+	/* A candidate collapse of one vertex onto another
+	*/
+	struct _Collapse
+	{
+		uint32_t from;
+		uint32_t to;
+		double cost;
+	};
+
+
+
+	/*
+	* PRIVATE STATIC METHODS
+	*/
+
+	/* @brief Locks vertices that share their position with another vertex or lie on an open border
+	*/
+	static std::vector<bool> _find_locked_vertices(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
+
+	/* @brief Adds the plane of a triangle to the quadrics of its corners
+	*/
+	static void _accumulate_quadrics(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, std::vector<_Quadric>& quadrics);
+
+	/* @brief Returns the weighted squared distance of a point to the planes of a quadric
+	*/
+	static double _evaluate(const _Quadric& quadric, const glm::vec3& point);
+
+	/* @brief Checks that moving a vertex doesn't turn any of its remaining triangles over
+	*/
+	static bool _flips_triangles(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+		const std::vector<uint32_t>& adjacencyOffsets, const std::vector<uint32_t>& adjacency, uint32_t from, uint32_t to);
+};
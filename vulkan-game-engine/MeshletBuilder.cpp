@@ -0,0 +1,141 @@
+#include "MeshletBuilder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/*
+* PUBLIC STATIC METHOD DEFINITIONS
+*/
+
+std::vector<MeshletBuilder::Meshlet> MeshletBuilder::build(const Mesh& mesh)
+{
+	const auto& indices = mesh.indices();
+	std::vector<Meshlet> meshlets;
+	meshlets.reserve(indices.size() / (3 * MAX_TRIANGLES / 2) + 1);
+
+	// Marks the vertices already in the current meshlet without clearing anything between meshlets
+	std::vector<uint32_t> vertexStamps(mesh.vertices().size(), UINT32_MAX);
+	uint32_t stamp = 0;
+
+	Meshlet current{};
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+	{
+		uint32_t newVertices = 0;
+		for (size_t k = 0; k < 3; ++k)
+		{
+			newVertices += (vertexStamps[indices[i + k]] != stamp) ? 1 : 0;
+		}
+
+		// Degenerate triangles can repeat a vertex, counting it twice only ever closes a meshlet early
+		if (current.vertexCount + newVertices > MAX_VERTICES || current.indexCount / 3 == MAX_TRIANGLES)
+		{
+			_compute_bounds(current, mesh);
+			meshlets.push_back(current);
+
+			current = Meshlet{};
+			current.firstIndex = static_cast<uint32_t>(i);
+			stamp++;
+		}
+
+		for (size_t k = 0; k < 3; ++k)
+		{
+			if (vertexStamps[indices[i + k]] != stamp)
+			{
+				vertexStamps[indices[i + k]] = stamp;
+				current.vertexCount++;
+			}
+		}
+		current.indexCount += 3;
+	}
+
+	if (current.indexCount > 0)
+	{
+		_compute_bounds(current, mesh);
+		meshlets.push_back(current);
+	}
+
+	return meshlets;
+}
+
+bool MeshletBuilder::is_backfacing(const Meshlet& meshlet, const glm::vec3& cameraPosition)
+{
+	glm::vec3 center(meshlet.sphere);
+	glm::vec3 axis(meshlet.cone);
+	glm::vec3 toCenter = center - cameraPosition;
+
+	return glm::dot(toCenter, axis) >= meshlet.cone.w * glm::length(toCenter) + meshlet.sphere.w;
+}
+
+
+
+
+
+/*
+* PRIVATE STATIC METHOD DEFINITIONS
+*/
+
+void MeshletBuilder::_compute_bounds(Meshlet& meshlet, const Mesh& mesh)
+{
+	const auto& vertices = mesh.vertices();
+	const uint32_t* pIndices = mesh.index_data() + meshlet.firstIndex;
+
+	glm::vec3 boundsMin(std::numeric_limits<float>::max());
+	glm::vec3 boundsMax(std::numeric_limits<float>::lowest());
+	for (uint32_t i = 0; i < meshlet.indexCount; ++i)
+	{
+		const auto& position = vertices[pIndices[i]].position();
+		boundsMin = glm::min(boundsMin, position);
+		boundsMax = glm::max(boundsMax, position);
+	}
+
+	glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+	float radius = 0.0f;
+	for (uint32_t i = 0; i < meshlet.indexCount; ++i)
+	{
+		radius = std::max(radius, glm::length(vertices[pIndices[i]].position() - center));
+	}
+	meshlet.sphere = glm::vec4(center, radius);
+
+	// The cone axis is the average unit normal, its spread is the widest angle any triangle normal makes with it
+	std::vector<glm::vec3> normals;
+	normals.reserve(meshlet.indexCount / 3);
+	glm::vec3 normalSum(0.0f);
+	for (uint32_t i = 0; i < meshlet.indexCount; i += 3)
+	{
+		const auto& p0 = vertices[pIndices[i]].position();
+		const auto& p1 = vertices[pIndices[i + 1]].position();
+		const auto& p2 = vertices[pIndices[i + 2]].position();
+
+		glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+		float length = glm::length(normal);
+		if (length > 0.0f)
+		{
+			normals.push_back(normal / length);
+			normalSum += normals.back();
+		}
+	}
+
+	float axisLength = glm::length(normalSum);
+	if (normals.empty() || axisLength == 0.0f)
+	{
+		meshlet.cone = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+		return;
+	}
+
+	glm::vec3 axis = normalSum / axisLength;
+	float minDot = 1.0f;
+	for (const auto& normal : normals)
+	{
+		minDot = std::min(minDot, glm::dot(normal, axis));
+	}
+
+	if (minDot <= _MIN_CONE_SPREAD)
+	{
+		meshlet.cone = glm::vec4(axis, 1.0f);
+		return;
+	}
+
+	// Sine of the spread angle, the cull test widens the cone by it so every triangle in it faces away
+	meshlet.cone = glm::vec4(axis, std::sqrt(1.0f - minDot * minDot));
+}
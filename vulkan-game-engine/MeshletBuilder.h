@@ -0,0 +1,101 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "Mesh.h"
+
+/*
+* Class that splits a mesh's index buffer into small clusters of triangles with culling bounds
+*
+* Meshlets are built by scanning the index buffer in order, so each one is a contiguous index range and the
+* triangle order the vertex cache optimizer chose is kept. Every meshlet carries a bounding sphere for frustum
+* culling and a normal cone for backface culling, laid out so a compute pass can read them as a storage buffer.
+*/
+class MeshletBuilder
+{
+public:
+
+	/*
+	* PUBLIC STATIC CONSTANTS
+	*/
+
+	/* Most unique vertices a meshlet may reference
+	*/
+	static constexpr uint32_t MAX_VERTICES = 64;
+
+	/* Most triangles a meshlet may hold
+	*/
+	static constexpr uint32_t MAX_TRIANGLES = 124;
+
+
+
+	/*
+	* PUBLIC STRUCTS
+	*/
+
+	/* A cluster of triangles and its culling bounds. Matches the std430 layout of the cull shader's meshlet buffer
+	*/
+	struct Meshlet
+	{
+		/* Center in xyz and radius in w of a sphere enclosing the meshlet, in mesh units
+		*/
+		glm::vec4 sphere;
+
+		/* Average triangle normal in xyz, and in w the cutoff for the cone test. A cutoff of 1 disables backface culling
+		*/
+		glm::vec4 cone;
+
+		/* Range of the meshlet's triangles in the mesh's index buffer
+		*/
+		uint32_t firstIndex;
+		uint32_t indexCount;
+
+		/* Number of unique vertices the triangles reference
+		*/
+		uint32_t vertexCount;
+		uint32_t padding;
+	};
+
+	static_assert(sizeof(Meshlet) == 48, "Meshlet must match the std430 layout of the cull shader");
+
+
+
+	/*
+	* PUBLIC STATIC METHODS
+	*/
+
+	/* @brief Splits the mesh's index buffer into meshlets of at most MAX_VERTICES vertices and MAX_TRIANGLES triangles
+	*
+	* LOD index lists are not clustered, they are small enough to draw whole
+	*/
+	static std::vector<Meshlet> build(const Mesh& mesh);
+
+	/* @brief Checks if every triangle of a meshlet faces away from a camera, using the same test as the cull shader
+	*
+	* @param cameraPosition Camera position in mesh space
+	*/
+	static bool is_backfacing(const Meshlet& meshlet, const glm::vec3& cameraPosition);
+
+private:
+
+	/*
+	* PRIVATE STATIC CONSTANTS
+	*/
+
+	/* Cones whose normals spread further than this from the axis, as a cosine, are too wide to ever cull
+	*/
+	static constexpr float _MIN_CONE_SPREAD = 0.1f;
+
+
+
+	/*
+	* PRIVATE STATIC METHODS
+	*/
+
+	/* @brief Fills in the bounding sphere and normal cone of a meshlet from its triangles
+	*/
+	static void _compute_bounds(Meshlet& meshlet, const Mesh& mesh);
+};
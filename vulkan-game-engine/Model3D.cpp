@@ -1,6 +1,78 @@
 #include "Model3D.h"
 
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+
+Model3D::Model3D()
+	: _mesh(),
+	_pTexture(nullptr),
+	_transform(1.0f)
+{
+}
+
 void Model3D::from_obj(const std::string& objFilepath)
 {
-	_mesh = ObjFile(objFilepath).get_mesh();
-}
\ No newline at end of file
+	std::string cachePath = MeshCache::path_for(objFilepath);
+
+	// A missing, outdated or unreadable cache just means the OBJ gets imported again
+	try
+	{
+		MeshCache cache(cachePath);
+		if (cache.matches_source(objFilepath))
+		{
+			_mesh = cache.to_mesh();
+			return;
+		}
+	}
+	catch (const std::runtime_error&)
+	{
+	}
+
+	_mesh = MeshOptimizer::optimize(ObjFile(objFilepath).get_mesh());
+
+	// LODs share the optimized vertex order, each gets its own triangle order for the vertex cache
+	auto lods = MeshSimplifier::build_lod_chain(_mesh);
+	for (auto& lod : lods)
+	{
+		MeshOptimizer::optimize_vertex_cache(lod.indices, _mesh.vertices().size());
+	}
+	_mesh.set_lods(std::move(lods));
+
+	try
+	{
+		MeshCache::write(cachePath, objFilepath, _mesh);
+	}
+	catch (const std::exception&)
+	{
+		// Failing to cache only costs the next start an import
+	}
+}
+
+void Model3D::scale(float scalar)
+{
+	_transform = glm::scale(glm::mat4(1.0f), glm::vec3(scalar)) * _transform;
+}
+
+void Model3D::rotate_x(float degrees)
+{
+	_transform = glm::rotate(glm::mat4(1.0f), glm::radians(degrees), glm::vec3(1, 0, 0)) * _transform;
+}
+
+void Model3D::rotate_y(float degrees)
+{
+	_transform = glm::rotate(glm::mat4(1.0f), glm::radians(degrees), glm::vec3(0, 1, 0)) * _transform;
+}
+
+void Model3D::rotate_z(float degrees)
+{
+	_transform = glm::rotate(glm::mat4(1.0f), glm::radians(degrees), glm::vec3(0, 0, 1)) * _transform;
+}
+
+void Model3D::bake()
+{
+	_mesh.transform(_transform);
+	_transform = glm::mat4(1.0f);
+}
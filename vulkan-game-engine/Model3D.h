@@ -8,18 +8,37 @@ class Model3D
 {
 public:
 
+	Model3D();
+
 	void from_obj(const std::string& objFilepath);
-	inline void set_texture(const Texture& texture) { _texture = texture; }
-	inline const Texture& get_texture() const { return _texture; }
+	/* @brief Points the model at a texture it doesn't own. The texture has to outlive the model and stay where it is
+	*/
+	inline void set_texture(const Texture& texture) { _pTexture = &texture; }
+	inline const Texture& get_texture() const { return *_pTexture; }
+
+	/* @brief Returns the mesh as imported. The local transform isn't applied until `bake()` is called
+	*/
 	inline const Mesh& get_mesh() const { return _mesh; }
 
-	inline void scale(float scalar) { _mesh.scale(scalar); }
-	inline void rotate_x(float degrees) { _mesh.rotate_x(degrees); }
-	inline void rotate_y(float degrees) { _mesh.rotate_y(degrees); }
-	inline void rotate_z(float degrees) { _mesh.rotate_z(degrees); }
+	/* @brief Returns the local transform composed from every scale and rotation so far
+	*/
+	inline const glm::mat4& transform() const { return _transform; }
+	inline void set_transform(const glm::mat4& transform) { _transform = transform; }
+
+	/* Each call composes onto the local transform, applied after the previous ones. No vertex is touched
+	*/
+	void scale(float scalar);
+	void rotate_x(float degrees);
+	void rotate_y(float degrees);
+	void rotate_z(float degrees);
+
+	/* @brief Applies the local transform to the mesh vertices and resets it to identity
+	*/
+	void bake();
 
 private:
 	Mesh _mesh;
-	Texture _texture;
+	const Texture* _pTexture;
+	glm::mat4 _transform;
 };
 
@@ -1,9 +1,11 @@
-#define TINYOBJLOADER_IMPLEMENTATION
-
 #include "ObjFile.h"
 
+#define TINYOBJLOADER_IMPLEMENTATION
+#include <tinyobj/tiny_obj_loader.h>
+
+#include <algorithm>
+#include <chrono>
 #include <stdexcept>
-#include <unordered_map>
 
 ObjFile::ObjFile()
 {
@@ -17,48 +19,169 @@ ObjFile::ObjFile(const std::string& filepath)
 
 void ObjFile::read(const std::string& filepath)
 {
+	_data = ObjParser::parse_file(filepath);
+}
+
+void ObjFile::read_tinyobj(const std::string& filepath)
+{
+	tinyobj::attrib_t attrib;
+	std::vector<tinyobj::shape_t> shapes;
+	std::vector<tinyobj::material_t> materials;
 	std::string error;
 
-	if (!tinyobj::LoadObj(&_attrib, &_shapes, &_materials, &error, filepath.c_str()))
+	if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &error, filepath.c_str()))
 	{
 		throw std::runtime_error(error);
 	}
+
+	_data = ObjParser::Result();
+	_data.positions = std::move(attrib.vertices);
+	_data.texcoords = std::move(attrib.texcoords);
+	_data.normals = std::move(attrib.normals);
+
+	for (const auto& shape : shapes)
+	{
+		for (const auto& index : shape.mesh.indices)
+		{
+			_data.indices.push_back({ index.vertex_index, index.texcoord_index, index.normal_index });
+		}
+	}
 }
 
-Mesh ObjFile::get_mesh() const
+Mesh ObjFile::get_mesh(DedupStats* pStats) const
 {
-    std::vector<Vertex> vertices;
+    auto start = std::chrono::steady_clock::now();
+
     std::vector<uint32_t> indices;
-    std::unordered_map<Vertex, uint32_t> uniqueVertices{};
+    std::vector<uint32_t> uniqueCorners;
+    bool useSort = _data.indices.size() > SORT_DEDUP_THRESHOLD;
+
+    if (useSort)
+    {
+        _dedup_sorted(indices, uniqueCorners);
+    }
+    else
+    {
+        _dedup_hashed(indices, uniqueCorners);
+    }
+
+    std::vector<Vertex> vertices;
+    vertices.reserve(uniqueCorners.size());
 
-    for (const auto& shape : _shapes) 
+    for (uint32_t corner : uniqueCorners)
     {
-        for (const auto& index : shape.mesh.indices) 
+        const auto& index = _data.indices[corner];
+
+        std::array<float, 3> pos = {
+            _data.positions[3 * index.vertex + 0],
+            _data.positions[3 * index.vertex + 1],
+            _data.positions[3 * index.vertex + 2]
+        };
+
+        std::array<float, 3> color = { 1.0f, 1.0f, 1.0f };
+
+        // Corners without texture coordinates map to the origin of the texture
+        std::array<float, 2> texCoords = { 0.0f, 1.0f };
+        if (index.texcoord >= 0)
         {
-            std::array<float, 3> pos = {
-                _attrib.vertices[3 * index.vertex_index + 0],
-                _attrib.vertices[3 * index.vertex_index + 1],
-                _attrib.vertices[3 * index.vertex_index + 2]
+            texCoords = {
+                _data.texcoords[2 * index.texcoord + 0],
+                1.0f - _data.texcoords[2 * index.texcoord + 1]
             };
+        }
 
-            std::array<float, 3> color = { 1.0f, 1.0f, 1.0f };
+        vertices.emplace_back(pos, color, texCoords);
+    }
 
-            std::array<float, 2> texCoords = {
-                _attrib.texcoords[2 * index.texcoord_index + 0],
-                1.0f - _attrib.texcoords[2 * index.texcoord_index + 1]
-            };
+    if (pStats != nullptr)
+    {
+        pStats->cornerCount = _data.indices.size();
+        pStats->uniqueVertexCount = vertices.size();
+        pStats->usedSort = useSort;
+        pStats->milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    return Mesh(std::move(vertices), std::move(indices));
+}
 
-            Vertex vertex(pos, color, texCoords);
+void ObjFile::_dedup_hashed(std::vector<uint32_t>& indices, std::vector<uint32_t>& uniqueCorners) const
+{
+    static constexpr uint64_t EMPTY_KEY = ~0ull;
+
+    size_t numCorners = _data.indices.size();
+    indices.resize(numCorners);
+
+    // Every corner could be unique, so a table of twice that many slots never exceeds half load
+    size_t capacity = 16;
+    while (capacity < numCorners * 2)
+    {
+        capacity <<= 1;
+    }
+
+    std::vector<uint64_t> keys(capacity, EMPTY_KEY);
+    std::vector<uint32_t> values(capacity);
+    size_t mask = capacity - 1;
+
+    for (size_t corner = 0; corner < numCorners; ++corner)
+    {
+        uint64_t key = _corner_key(_data.indices[corner]);
+        size_t slot = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+
+        while (keys[slot] != EMPTY_KEY && keys[slot] != key)
+        {
+            slot = (slot + 1) & mask;
+        }
+
+        if (keys[slot] == EMPTY_KEY)
+        {
+            keys[slot] = key;
+            values[slot] = static_cast<uint32_t>(uniqueCorners.size());
+            uniqueCorners.push_back(static_cast<uint32_t>(corner));
+        }
+
+        indices[corner] = values[slot];
+    }
+}
+
+void ObjFile::_dedup_sorted(std::vector<uint32_t>& indices, std::vector<uint32_t>& uniqueCorners) const
+{
+    static constexpr uint32_t UNASSIGNED = ~0u;
 
-            if (uniqueVertices.count(vertex) == 0) 
-            {
-                uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
-                vertices.push_back(vertex);
-            }
+    size_t numCorners = _data.indices.size();
+    indices.resize(numCorners);
 
-            indices.push_back(uniqueVertices[vertex]);
+    std::vector<std::pair<uint64_t, uint32_t>> sortedCorners(numCorners);
+    for (size_t corner = 0; corner < numCorners; ++corner)
+    {
+        sortedCorners[corner] = { _corner_key(_data.indices[corner]), static_cast<uint32_t>(corner) };
+    }
+    std::sort(sortedCorners.begin(), sortedCorners.end());
+
+    // Number the runs of equal keys, then renumber them by first use so both paths produce the same mesh
+    std::vector<uint32_t> groupOfCorner(numCorners);
+    uint32_t numGroups = 0;
+    for (size_t i = 0; i < numCorners; ++i)
+    {
+        if (i > 0 && sortedCorners[i].first != sortedCorners[i - 1].first)
+        {
+            numGroups++;
         }
+        groupOfCorner[sortedCorners[i].second] = numGroups;
     }
+    sortedCorners = {};
+
+    std::vector<uint32_t> vertexOfGroup(numCorners == 0 ? 0 : numGroups + 1, UNASSIGNED);
+    uniqueCorners.reserve(vertexOfGroup.size());
 
-    return Mesh(vertices, indices);
+    for (size_t corner = 0; corner < numCorners; ++corner)
+    {
+        uint32_t& vertex = vertexOfGroup[groupOfCorner[corner]];
+        if (vertex == UNASSIGNED)
+        {
+            vertex = static_cast<uint32_t>(uniqueCorners.size());
+            uniqueCorners.push_back(static_cast<uint32_t>(corner));
+        }
+
+        indices[corner] = vertex;
+    }
 }
@@ -1,30 +1,67 @@
 #pragma once
 
-
-// #define TINYOBJLOADER_IMPLEMENTATION
-#include <tinyobj/tiny_obj_loader.h>
-
-
-
-
 #include <string>
 
 #include "Mesh.h"
+#include "ObjParser.h"
 
 class ObjFile
 {
 public:
 
+	/* Summary of the vertex deduplication done by get_mesh
+	*/
+	struct DedupStats
+	{
+		size_t cornerCount;
+		size_t uniqueVertexCount;
+		bool usedSort;
+		double milliseconds;
+
+		/* @brief Returns the fraction of face corners that were merged into an existing vertex
+		*/
+		inline double ratio() const { return cornerCount == 0 ? 0.0 : 1.0 - static_cast<double>(uniqueVertexCount) / cornerCount; }
+	};
+
+	/* Inputs with more face corners than this are deduplicated by sorting instead of hashing
+	*/
+	static constexpr size_t SORT_DEDUP_THRESHOLD = 1 << 24;
+
 	ObjFile();
 	ObjFile(const std::string& filepath);
 
+	/* @brief Memory maps and parses the file on every hardware thread
+	*/
 	void read(const std::string& filepath);
 
-	Mesh get_mesh() const;
+	/* @brief Parses the file with tinyobj. Kept as a reference for benchmarking the native parser
+	*/
+	void read_tinyobj(const std::string& filepath);
+
+	/* @brief Builds an indexed mesh, sharing a vertex between every corner with the same attribute indices
+	*
+	* @param pStats If not null, receives the deduplication ratio and time
+	*/
+	Mesh get_mesh(DedupStats* pStats = nullptr) const;
 
 private:
-	tinyobj::attrib_t _attrib;
-	std::vector<tinyobj::shape_t> _shapes;
-	std::vector<tinyobj::material_t> _materials;
-};
+	ObjParser::Result _data;
 
+	/* @brief Returns the key a corner is deduplicated on. Normals aren't part of Vertex, so only position and texcoord count
+	*/
+	static inline uint64_t _corner_key(const ObjParser::Index& index)
+	{
+		return (static_cast<uint64_t>(static_cast<uint32_t>(index.vertex)) << 32) | static_cast<uint32_t>(index.texcoord + 1);
+	}
+
+	/* @brief Deduplicates with an open addressing table sized for the worst case up front
+	*
+	* @param indices Receives the vertex index of every corner
+	* @param uniqueCorners Receives the first corner of every unique vertex, in order of first use
+	*/
+	void _dedup_hashed(std::vector<uint32_t>& indices, std::vector<uint32_t>& uniqueCorners) const;
+
+	/* @brief Deduplicates by sorting the corner keys. Slower on small inputs but never probes randomly through a huge table
+	*/
+	void _dedup_sorted(std::vector<uint32_t>& indices, std::vector<uint32_t>& uniqueCorners) const;
+};
@@ -0,0 +1,354 @@
+#include "ObjParser.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+#include "MappedFile.h"
+
+/* @brief Checks for the characters that separate tokens on a line
+*/
+static inline bool is_blank(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+/* @brief Skips blanks, returning a pointer to the next token or to the end of the line
+*/
+static inline const char* skip_blanks(const char* p, const char* pEnd)
+{
+	while (p < pEnd && is_blank(*p))
+	{
+		++p;
+	}
+	return p;
+}
+
+
+
+
+
+/*
+* PUBLIC STATIC METHOD DEFINITIONS
+*/
+
+ObjParser::Result ObjParser::parse(const char* pData, size_t size, unsigned numThreads)
+{
+	if (numThreads == 0)
+	{
+		numThreads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	size_t numChunks = std::min<size_t>(numThreads, std::max<size_t>(1, size / MIN_CHUNK_SIZE));
+	auto ranges = _split_lines(pData, size, numChunks);
+	std::vector<_Chunk> chunks(ranges.size());
+
+	// The calling thread parses the first chunk itself
+	std::vector<std::future<void>> tasks;
+	for (size_t i = 1; i < ranges.size(); ++i)
+	{
+		tasks.push_back(std::async(std::launch::async, &ObjParser::_parse_chunk, ranges[i].first, ranges[i].second, std::ref(chunks[i])));
+	}
+
+	if (!ranges.empty())
+	{
+		_parse_chunk(ranges[0].first, ranges[0].second, chunks[0]);
+	}
+
+	for (auto& task : tasks)
+	{
+		task.get();
+	}
+
+	return _merge(chunks);
+}
+
+ObjParser::Result ObjParser::parse_file(const std::string& filepath, unsigned numThreads)
+{
+	MappedFile file(filepath);
+	return parse(file.data(), file.size(), numThreads);
+}
+
+
+
+
+
+/*
+* PRIVATE STATIC METHOD DEFINITIONS
+*/
+
+std::vector<std::pair<const char*, const char*>> ObjParser::_split_lines(const char* pData, size_t size, size_t numChunks)
+{
+	std::vector<std::pair<const char*, const char*>> ranges;
+	if (size == 0)
+	{
+		return ranges;
+	}
+
+	const char* pEnd = pData + size;
+	const char* pStart = pData;
+	size_t chunkSize = size / numChunks;
+
+	for (size_t i = 1; i < numChunks; ++i)
+	{
+		const char* pTarget = pData + i * chunkSize;
+		if (pTarget <= pStart)
+		{
+			continue;
+		}
+
+		auto pNewline = static_cast<const char*>(memchr(pTarget, '\n', pEnd - pTarget));
+		if (pNewline == nullptr)
+		{
+			break;
+		}
+
+		ranges.push_back({ pStart, pNewline + 1 });
+		pStart = pNewline + 1;
+	}
+
+	if (pStart < pEnd)
+	{
+		ranges.push_back({ pStart, pEnd });
+	}
+
+	return ranges;
+}
+
+void ObjParser::_parse_chunk(const char* pBegin, const char* pEnd, _Chunk& chunk)
+{
+	auto& result = chunk.result;
+	const char* p = pBegin;
+
+	while (p < pEnd)
+	{
+		p = skip_blanks(p, pEnd);
+
+		auto pLineEnd = static_cast<const char*>(memchr(p, '\n', pEnd - p));
+		if (pLineEnd == nullptr)
+		{
+			pLineEnd = pEnd;
+		}
+
+		size_t lineLength = pLineEnd - p;
+		if (lineLength >= 2 && p[0] == 'v' && is_blank(p[1]))
+		{
+			float position[3];
+			_parse_floats(p + 2, pLineEnd, position, 3, 3);
+			result.positions.insert(result.positions.end(), position, position + 3);
+		}
+		else if (lineLength >= 3 && p[0] == 'v' && p[1] == 't' && is_blank(p[2]))
+		{
+			float texcoord[2] = { 0.0f, 0.0f };
+			_parse_floats(p + 3, pLineEnd, texcoord, 2, 1);
+			result.texcoords.insert(result.texcoords.end(), texcoord, texcoord + 2);
+		}
+		else if (lineLength >= 3 && p[0] == 'v' && p[1] == 'n' && is_blank(p[2]))
+		{
+			float normal[3];
+			_parse_floats(p + 3, pLineEnd, normal, 3, 3);
+			result.normals.insert(result.normals.end(), normal, normal + 3);
+		}
+		else if (lineLength >= 2 && p[0] == 'f' && is_blank(p[1]))
+		{
+			_parse_face(p + 2, pLineEnd, chunk);
+		}
+
+		p = pLineEnd + 1;
+	}
+}
+
+const char* ObjParser::_parse_face(const char* p, const char* pEnd, _Chunk& chunk)
+{
+	auto& result = chunk.result;
+	int32_t numPositions = static_cast<int32_t>(result.positions.size() / 3);
+	int32_t numTexcoords = static_cast<int32_t>(result.texcoords.size() / 2);
+	int32_t numNormals = static_cast<int32_t>(result.normals.size() / 3);
+
+	auto parse_index = [&](int32_t count, uint8_t relativeFlag, int32_t* pIndex, uint8_t* pRelative) {
+		int32_t value = 0;
+		auto [ptr, ec] = std::from_chars(p, pEnd, value);
+		if (ec != std::errc() || value == 0)
+		{
+			throw std::runtime_error("Malformed face index in OBJ data");
+		}
+		p = ptr;
+
+		if (value > 0)
+		{
+			*pIndex = value - 1;
+		}
+		else
+		{
+			// Relative to the attributes parsed so far, the chunk's base offset is added when merging
+			*pIndex = count + value;
+			*pRelative |= relativeFlag;
+		}
+	};
+
+	auto push_corner = [&](const Index& index, uint8_t relative) {
+		// The mask is only allocated once a chunk contains its first relative index
+		if (relative != 0 || !chunk.relativeMask.empty())
+		{
+			chunk.relativeMask.resize(result.indices.size(), 0);
+			chunk.relativeMask.push_back(relative);
+		}
+
+		result.indices.push_back(index);
+	};
+
+	Index first{};
+	Index previous{};
+	uint8_t firstRelative = 0;
+	uint8_t previousRelative = 0;
+	size_t numCorners = 0;
+
+	while (true)
+	{
+		p = skip_blanks(p, pEnd);
+		if (p >= pEnd || *p == '#')
+		{
+			break;
+		}
+
+		Index corner{ -1, -1, -1 };
+		uint8_t relative = 0;
+
+		parse_index(numPositions, _RELATIVE_VERTEX, &corner.vertex, &relative);
+		if (p < pEnd && *p == '/')
+		{
+			++p;
+			if (p < pEnd && *p != '/')
+			{
+				parse_index(numTexcoords, _RELATIVE_TEXCOORD, &corner.texcoord, &relative);
+			}
+
+			if (p < pEnd && *p == '/')
+			{
+				++p;
+				parse_index(numNormals, _RELATIVE_NORMAL, &corner.normal, &relative);
+			}
+		}
+
+		// Polygons are triangulated as a fan around the first corner
+		if (numCorners == 0)
+		{
+			first = corner;
+			firstRelative = relative;
+		}
+		else if (numCorners >= 2)
+		{
+			push_corner(first, firstRelative);
+			push_corner(previous, previousRelative);
+			push_corner(corner, relative);
+		}
+
+		previous = corner;
+		previousRelative = relative;
+		numCorners++;
+	}
+
+	return p;
+}
+
+const char* ObjParser::_parse_floats(const char* p, const char* pEnd, float* pOut, size_t count, size_t minCount)
+{
+	size_t numParsed = 0;
+	for (; numParsed < count; ++numParsed)
+	{
+		p = skip_blanks(p, pEnd);
+		if (p >= pEnd || *p == '#')
+		{
+			break;
+		}
+
+		// from_chars doesn't accept an explicit plus sign
+		if (*p == '+')
+		{
+			++p;
+		}
+
+		auto [ptr, ec] = std::from_chars(p, pEnd, pOut[numParsed]);
+		if (ec != std::errc())
+		{
+			throw std::runtime_error("Malformed number in OBJ data");
+		}
+		p = ptr;
+	}
+
+	if (numParsed < minCount)
+	{
+		throw std::runtime_error("Too few components in OBJ attribute");
+	}
+
+	return p;
+}
+
+ObjParser::Result ObjParser::_merge(std::vector<_Chunk>& chunks)
+{
+	Result merged;
+
+	size_t totalPositions = 0;
+	size_t totalTexcoords = 0;
+	size_t totalNormals = 0;
+	size_t totalIndices = 0;
+	for (const auto& chunk : chunks)
+	{
+		totalPositions += chunk.result.positions.size();
+		totalTexcoords += chunk.result.texcoords.size();
+		totalNormals += chunk.result.normals.size();
+		totalIndices += chunk.result.indices.size();
+	}
+
+	merged.positions.reserve(totalPositions);
+	merged.texcoords.reserve(totalTexcoords);
+	merged.normals.reserve(totalNormals);
+	merged.indices.reserve(totalIndices);
+
+	int32_t numPositions = static_cast<int32_t>(totalPositions / 3);
+	int32_t numTexcoords = static_cast<int32_t>(totalTexcoords / 2);
+	int32_t numNormals = static_cast<int32_t>(totalNormals / 3);
+
+	for (auto& chunk : chunks)
+	{
+		// Attributes of earlier chunks come first, which is where relative indices are measured from
+		int32_t positionBase = static_cast<int32_t>(merged.positions.size() / 3);
+		int32_t texcoordBase = static_cast<int32_t>(merged.texcoords.size() / 2);
+		int32_t normalBase = static_cast<int32_t>(merged.normals.size() / 3);
+
+		auto& result = chunk.result;
+		for (size_t i = 0; i < result.indices.size(); ++i)
+		{
+			Index index = result.indices[i];
+			uint8_t relative = chunk.relativeMask.empty() ? 0 : chunk.relativeMask[i];
+			index.vertex += (relative & _RELATIVE_VERTEX) ? positionBase : 0;
+			index.texcoord += (relative & _RELATIVE_TEXCOORD) ? texcoordBase : 0;
+			index.normal += (relative & _RELATIVE_NORMAL) ? normalBase : 0;
+
+			// -1 only means "missing" for attributes that weren't given as relative indices
+			int32_t minTexcoord = (relative & _RELATIVE_TEXCOORD) ? 0 : -1;
+			int32_t minNormal = (relative & _RELATIVE_NORMAL) ? 0 : -1;
+
+			if (index.vertex < 0 || index.vertex >= numPositions ||
+				index.texcoord < minTexcoord || index.texcoord >= numTexcoords ||
+				index.normal < minNormal || index.normal >= numNormals)
+			{
+				throw std::runtime_error("OBJ face references a missing attribute");
+			}
+
+			merged.indices.push_back(index);
+		}
+
+		merged.positions.insert(merged.positions.end(), result.positions.begin(), result.positions.end());
+		merged.texcoords.insert(merged.texcoords.end(), result.texcoords.begin(), result.texcoords.end());
+		merged.normals.insert(merged.normals.end(), result.normals.begin(), result.normals.end());
+
+		// Release the chunk as soon as it has been copied to keep peak memory down
+		chunk = _Chunk();
+	}
+
+	return merged;
+}
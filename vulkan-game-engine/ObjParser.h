@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+* Class implementing a multithreaded Wavefront OBJ parser
+*
+* The file is split into line-aligned chunks that are parsed in parallel, then the per-chunk
+* attribute and index arrays are merged. Only geometry is read, materials and groups are ignored.
+*/
+class ObjParser
+{
+public:
+
+	/*
+	* PUBLIC STATIC CONSTANTS
+	*/
+
+	/* Files smaller than this per thread are not split any further
+	*/
+	static constexpr size_t MIN_CHUNK_SIZE = 1 << 20;
+
+
+
+	/*
+	* PUBLIC STRUCTS
+	*/
+
+	/* Zero-based attribute indices of a single face corner. Missing attributes are -1
+	*/
+	struct Index
+	{
+		int32_t vertex;
+		int32_t texcoord;
+		int32_t normal;
+	};
+
+	/* Parsed attribute arrays, laid out like tinyobj::attrib_t, and triangulated face corners
+	*/
+	struct Result
+	{
+		std::vector<float> positions;
+		std::vector<float> texcoords;
+		std::vector<float> normals;
+		std::vector<Index> indices;
+	};
+
+
+
+	/*
+	* PUBLIC STATIC METHODS
+	*/
+
+	/* @brief Parses OBJ text held in memory
+	*
+	* @param pData Start of the OBJ text
+	* @param size Size of the text in bytes
+	* @param numThreads Number of threads to parse with, or 0 to use every hardware thread
+	*
+	* @throws std::runtime_error if the text is malformed or a face references a missing attribute
+	*/
+	static Result parse(const char* pData, size_t size, unsigned numThreads = 0);
+
+	/* @brief Memory maps and parses an OBJ file
+	*/
+	static Result parse_file(const std::string& filepath, unsigned numThreads = 0);
+
+private:
+
+	/*
+	* PRIVATE STRUCTS
+	*/
+
+	/* Output of a single chunk. Negative OBJ indices can only be resolved once the counts of earlier chunks are known
+	*/
+	struct _Chunk
+	{
+		Result result;
+		std::vector<uint8_t> relativeMask;
+	};
+
+
+
+	/*
+	* PRIVATE STATIC CONSTANTS
+	*/
+
+	static constexpr uint8_t _RELATIVE_VERTEX = 1 << 0;
+	static constexpr uint8_t _RELATIVE_TEXCOORD = 1 << 1;
+	static constexpr uint8_t _RELATIVE_NORMAL = 1 << 2;
+
+
+
+	/*
+	* PRIVATE STATIC METHODS
+	*/
+
+	/* @brief Splits the text into up to `numChunks` ranges that start and end on line boundaries
+	*/
+	static std::vector<std::pair<const char*, const char*>> _split_lines(const char* pData, size_t size, size_t numChunks);
+
+	/* @brief Parses every line in a range
+	*/
+	static void _parse_chunk(const char* pBegin, const char* pEnd, _Chunk& chunk);
+
+	/* @brief Parses the corners of a face line and appends them as a triangle fan
+	*/
+	static const char* _parse_face(const char* p, const char* pEnd, _Chunk& chunk);
+
+	/* @brief Parses up to `count` floats, stopping early at the end of the line
+	*/
+	static const char* _parse_floats(const char* p, const char* pEnd, float* pOut, size_t count, size_t minCount);
+
+	/* @brief Joins the chunks in file order, resolving relative indices and validating every index
+	*/
+	static Result _merge(std::vector<_Chunk>& chunks);
+};
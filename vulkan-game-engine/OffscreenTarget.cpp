@@ -0,0 +1,195 @@
+#include "OffscreenTarget.h"
+
+#include <stdexcept>
+
+#include "Buffer.h"
+#include "CommandBufferPool.h"
+
+/*
+* CTORS / ASSIGNMENT DEFINITIONS
+*/
+
+OffscreenTarget::OffscreenTarget()
+	: _extent(VkExtent2D{}),
+	_colorImages({}),
+	_frameBuffers({}),
+	_deviceHandle(VK_NULL_HANDLE)
+{
+}
+
+OffscreenTarget::OffscreenTarget(const Device& device, VkExtent2D extent, uint32_t imageCount)
+	: _extent(extent),
+	_colorImages({}),
+	_frameBuffers({}),
+	_deviceHandle(device.handle())
+{
+	if (imageCount == 0)
+	{
+		throw std::invalid_argument("Offscreen target needs at least one color image");
+	}
+
+	_colorImages.reserve(imageCount);
+	for (uint32_t i = 0; i < imageCount; ++i)
+	{
+		_colorImages.push_back(Image(device, {
+			_extent.width,
+			_extent.height,
+			COLOR_FORMAT,
+			VK_IMAGE_TILING_OPTIMAL,
+			VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+			VK_IMAGE_ASPECT_COLOR_BIT
+		}));
+	}
+}
+
+OffscreenTarget::OffscreenTarget(OffscreenTarget&& other) noexcept
+	: OffscreenTarget()
+{
+	swap(*this, other);
+}
+
+OffscreenTarget& OffscreenTarget::operator=(OffscreenTarget other)
+{
+	swap(*this, other);
+	return *this;
+}
+
+OffscreenTarget::~OffscreenTarget()
+{
+	if (_deviceHandle != VK_NULL_HANDLE)
+	{
+		for (auto frameBuffer : _frameBuffers)
+		{
+			vkDestroyFramebuffer(_deviceHandle, frameBuffer, nullptr);
+		}
+	}
+}
+
+
+
+
+
+/*
+* PUBLIC METHOD DEFINITIONS
+*/
+
+void OffscreenTarget::init_framebuffers(VkRenderPass renderPass, VkImageView depthImageView)
+{
+	_frameBuffers.resize(_colorImages.size());
+	for (size_t i = 0; i < _frameBuffers.size(); ++i)
+	{
+		VkFramebufferCreateInfo bufferCreateInfo{};
+		std::vector<VkImageView> attachments = {
+			_colorImages[i].get_image_view(),
+			depthImageView
+		};
+
+		_configure_frame_buffer(&bufferCreateInfo, renderPass, attachments);
+		if (vkCreateFramebuffer(_deviceHandle, &bufferCreateInfo, nullptr, &_frameBuffers[i]) != VK_SUCCESS)
+		{
+			throw std::runtime_error("Failed to create framebuffer");
+		}
+	}
+}
+
+std::vector<uint8_t> OffscreenTarget::read_pixels(const Device& device, const CommandPool& commandPool, size_t index) const
+{
+	size_t imageSize = static_cast<size_t>(_extent.width) * _extent.height * 4;
+	Buffer readbackBuffer(device, Buffer::Type::READBACK, imageSize);
+
+	VkCommandBufferBeginInfo beginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+	CommandBufferPool commandBuffer(_deviceHandle, 1, commandPool.handle());
+	commandBuffer.begin_all(beginInfo);
+	_record_copy_image_to_buffer(commandBuffer[0], _colorImages.at(index).handle(), readbackBuffer.handle());
+	commandBuffer.end_all();
+
+	auto graphicsQueue = device.queue_family_info().get_queue_handle(QueueFamilyType::Graphics);
+	commandBuffer.submit_all_to_queue(graphicsQueue);
+
+	std::vector<uint8_t> pixels(imageSize);
+	readbackBuffer.copy_from_mapped_mem(pixels.data());
+	return pixels;
+}
+
+
+
+
+
+/*
+* PRIVATE CONST METHOD DEFINITIONS
+*/
+
+void OffscreenTarget::_configure_frame_buffer(VkFramebufferCreateInfo* pCreateInfo, VkRenderPass renderPass, std::vector<VkImageView>& attachments) const
+{
+	memset(pCreateInfo, 0, sizeof(VkFramebufferCreateInfo));
+	pCreateInfo->sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+	pCreateInfo->renderPass = renderPass;
+	pCreateInfo->attachmentCount = static_cast<uint32_t>(attachments.size());
+	pCreateInfo->pAttachments = attachments.data();
+	pCreateInfo->width = _extent.width;
+	pCreateInfo->height = _extent.height;
+	pCreateInfo->layers = 1;
+}
+
+void OffscreenTarget::_record_copy_image_to_buffer(VkCommandBuffer cmdBuffer, VkImage image, VkBuffer readbackBuffer) const
+{
+	// The render pass already left the image in FINAL_LAYOUT, only the attachment writes need to be made visible
+	VkImageMemoryBarrier imageBarrier{};
+	imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	imageBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	imageBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+	imageBarrier.oldLayout = FINAL_LAYOUT;
+	imageBarrier.newLayout = FINAL_LAYOUT;
+	imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	imageBarrier.image = image;
+	imageBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	imageBarrier.subresourceRange.baseMipLevel = 0;
+	imageBarrier.subresourceRange.levelCount = 1;
+	imageBarrier.subresourceRange.baseArrayLayer = 0;
+	imageBarrier.subresourceRange.layerCount = 1;
+
+	vkCmdPipelineBarrier(
+		cmdBuffer,
+		VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+		0,
+		0, nullptr,
+		0, nullptr,
+		1, &imageBarrier
+	);
+
+	VkBufferImageCopy region{};
+	region.bufferOffset = 0;
+	region.bufferRowLength = 0;
+	region.bufferImageHeight = 0;
+	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	region.imageSubresource.mipLevel = 0;
+	region.imageSubresource.baseArrayLayer = 0;
+	region.imageSubresource.layerCount = 1;
+	region.imageOffset = { 0, 0, 0 };
+	region.imageExtent = { _extent.width, _extent.height, 1 };
+
+	vkCmdCopyImageToBuffer(cmdBuffer, image, FINAL_LAYOUT, readbackBuffer, 1, &region);
+
+	VkBufferMemoryBarrier bufferBarrier{};
+	bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	bufferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	bufferBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+	bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	bufferBarrier.buffer = readbackBuffer;
+	bufferBarrier.offset = 0;
+	bufferBarrier.size = VK_WHOLE_SIZE;
+
+	vkCmdPipelineBarrier(
+		cmdBuffer,
+		VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+		0,
+		0, nullptr,
+		1, &bufferBarrier,
+		0, nullptr
+	);
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "Device.h"
+#include "Image.h"
+#include "CommandPool.h"
+
+/*
+* Class implementing a set of offscreen color images that can be rendered to in place of a swap chain
+*/
+class OffscreenTarget
+{
+public:
+
+	/*
+	* PUBLIC STATIC CONSTANTS
+	*/
+
+	/* Format of every color image, 4 bytes per pixel in RGBA order
+	*/
+	static constexpr VkFormat COLOR_FORMAT = VK_FORMAT_R8G8B8A8_SRGB;
+
+	/* Layout the color images are left in after a render pass
+	*/
+	static constexpr VkImageLayout FINAL_LAYOUT = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+
+
+	/*
+	* PUBLIC FRIEND METHODS
+	*/
+
+	/* @brief Swap implementation for OffscreenTarget class
+	*/
+	friend void swap(OffscreenTarget& targetA, OffscreenTarget& targetB)
+	{
+		using std::swap;
+
+		swap(targetA._extent, targetB._extent);
+		swap(targetA._colorImages, targetB._colorImages);
+		swap(targetA._frameBuffers, targetB._frameBuffers);
+		swap(targetA._deviceHandle, targetB._deviceHandle);
+	}
+
+
+
+	/*
+	* CTORS / ASSIGNMENT
+	*/
+
+	OffscreenTarget();
+
+	/*
+	* @param device Device being used
+	* @param extent Size of every color image in pixels
+	* @param imageCount Number of color images to create, usually one per frame in flight
+	*/
+	OffscreenTarget(const Device& device, VkExtent2D extent, uint32_t imageCount);
+	OffscreenTarget(const OffscreenTarget&) = delete;
+	OffscreenTarget(OffscreenTarget&& other) noexcept;
+	OffscreenTarget& operator=(OffscreenTarget other);
+	~OffscreenTarget();
+
+
+
+	/*
+	* PUBLIC METHODS
+	*/
+
+	/* @brief Initializes framebuffers for use
+	*
+	* @param renderPass Handle to render pass that framebuffers will be used with
+	* @param depthImageView Handle to depth image view shared by all framebuffers
+	*/
+	void init_framebuffers(VkRenderPass renderPass, VkImageView depthImageView);
+
+	/* @brief Copies the color image at the given index into host memory. Waits for the copy to finish
+	*
+	* @param device Device being used
+	* @param commandPool Command pool used to record the copy
+	* @param index Index of the color image to read
+	* @returns Tightly packed RGBA pixels, row by row from the top left corner
+	*/
+	std::vector<uint8_t> read_pixels(const Device& device, const CommandPool& commandPool, size_t index) const;
+
+
+
+	/*
+	* PUBLIC CONST METHODS
+	*/
+
+	/* @brief Returns the size of the color images
+	*/
+	inline VkExtent2D extent() const { return _extent; }
+
+	/* @brief Returns the number of color images
+	*/
+	inline size_t image_count() const { return _colorImages.size(); }
+
+	/* @brief Returns the frame buffer at the given index
+	*/
+	inline VkFramebuffer frame_buffer_at(size_t index) const { return _frameBuffers[index]; }
+
+private:
+
+	/*
+	* PRIVATE MEMBERS
+	*/
+
+	/* Size of the color images
+	*/
+	VkExtent2D _extent;
+
+	/* Color images, one per frame buffer
+	*/
+	std::vector<Image> _colorImages;
+
+	/* Frame buffer list
+	*/
+	std::vector<VkFramebuffer> _frameBuffers;
+
+	/* Handle to device being used
+	*/
+	VkDevice _deviceHandle;
+
+
+
+	/*
+	* PRIVATE CONST METHODS
+	*/
+
+	/* @brief Fills struct with necessary info for creating frame buffer
+	*/
+	void _configure_frame_buffer(VkFramebufferCreateInfo* pCreateInfo, VkRenderPass renderPass, std::vector<VkImageView>& attachments) const;
+
+	/* @brief Records the barriers and copy needed to read a color image from the host
+	*/
+	void _record_copy_image_to_buffer(VkCommandBuffer cmdBuffer, VkImage image, VkBuffer readbackBuffer) const;
+};
@@ -1,19 +1,32 @@
 #include "PNGImage.h"
 
-#include <algorithm>
+#include <png++/png.hpp>
 
-PNGImage::pixel_bits_t PNGImage::_bits_from_struct(png::rgba_pixel pixelStruct)
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "PixelKernels.h"
+
+struct PNGImage::_Decoder
 {
-	pixel_bits_t redBits = ((pixel_bits_t)pixelStruct.red);
-	pixel_bits_t greenBits = ((pixel_bits_t)pixelStruct.green) << 8;
-	pixel_bits_t blueBits = ((pixel_bits_t)pixelStruct.blue) << 16;
-	pixel_bits_t alphaBits = ((pixel_bits_t)pixelStruct.alpha) << 24;
+	std::ifstream file;
+	png::reader<std::istream> reader;
 
-	return redBits | greenBits | blueBits | alphaBits;
-}
+	_Decoder(const std::string& filepath)
+		: file(filepath, std::ios::binary),
+		reader(file)
+	{
+	}
+};
 
 PNGImage::PNGImage()
-	: _pixels({})
+	: _pDecoder(nullptr),
+	_width(0),
+	_height(0),
+	_sourceChannels(_NUM_CHANNELS),
+	_outputChannels(_NUM_CHANNELS)
 {
 }
 
@@ -23,24 +36,257 @@ PNGImage::PNGImage(const std::string& filepath)
 	read(filepath);
 }
 
+PNGImage::PNGImage(PNGImage&& other) noexcept
+	: PNGImage()
+{
+	swap(*this, other);
+}
+
+PNGImage& PNGImage::operator=(PNGImage other)
+{
+	swap(*this, other);
+	return *this;
+}
+
 PNGImage::~PNGImage()
 {
 }
 
 void PNGImage::read(const std::string& filepath)
 {
-	_image.read(filepath);
-	_load_pixels();
+	auto pDecoder = std::make_unique<_Decoder>(filepath);
+	if (!pDecoder->file)
+	{
+		throw std::runtime_error("Failed to open PNG file " + filepath);
+	}
+
+	try
+	{
+		pDecoder->reader.read_info();
+	}
+	catch (const png::error& e)
+	{
+		throw std::runtime_error("Failed to read PNG header of " + filepath + ": " + e.what());
+	}
+
+	_width = pDecoder->reader.get_width();
+	_height = pDecoder->reader.get_height();
+
+	auto colorType = pDecoder->reader.get_color_type();
+	bool hasColorKey = pDecoder->reader.has_chunk(png::chunk_tRNS);
+	if (colorType == png::color_type_gray)
+	{
+		_sourceChannels = hasColorKey ? 2 : 1;
+	}
+	else if (colorType == png::color_type_gray_alpha)
+	{
+		_sourceChannels = 2;
+	}
+	else
+	{
+		_sourceChannels = _NUM_CHANNELS;
+	}
+	_outputChannels = _NUM_CHANNELS;
+
+	_pDecoder = std::move(pDecoder);
 }
 
-void PNGImage::_load_pixels()
+void PNGImage::set_output_channels(uint32_t numChannels)
 {
-	auto& buf = _image.get_pixbuf();
-	auto numRows = buf.get_height();
+	if (numChannels != _NUM_CHANNELS && numChannels != _sourceChannels)
+	{
+		throw std::invalid_argument("PNG images can only be decoded to RGBA or to their source channels");
+	}
 
-	for (size_t i = 0; i < numRows; ++i)
+	_outputChannels = numChannels;
+}
+
+void PNGImage::decode(void* pDest)
+{
+	if (!_pDecoder)
 	{
-		auto& row = buf[i];
-		std::transform(row.begin(), row.end(), std::back_inserter(_pixels), &PNGImage::_bits_from_struct);
+		throw std::logic_error("PNG image has no undecoded file to read pixels from");
 	}
-}
\ No newline at end of file
+
+	auto& reader = _pDecoder->reader;
+	bool isInterlaced = reader.get_interlace_type() != png::interlace_none;
+	bool hasColorKey = reader.get_color_type() != png::color_type_palette && reader.has_chunk(png::chunk_tRNS);
+
+	try
+	{
+		// The kernels work one row at a time, so multi-pass and color-keyed images are left to libpng
+		if (isInterlaced || hasColorKey)
+		{
+			_decode_with_transforms(static_cast<uint8_t*>(pDest));
+		}
+		else
+		{
+			_decode_rows(static_cast<uint8_t*>(pDest));
+		}
+	}
+	catch (const png::error& e)
+	{
+		_pDecoder.reset();
+		throw std::runtime_error(std::string("Failed to decode PNG pixels: ") + e.what());
+	}
+
+	_pDecoder.reset();
+}
+
+void PNGImage::write_rgba(const std::string& filepath, uint32_t width, uint32_t height, const std::vector<uint8_t>& pixels)
+{
+	if (pixels.size() < static_cast<size_t>(width) * height * _NUM_CHANNELS)
+	{
+		throw std::invalid_argument("Pixel data is smaller than the image size");
+	}
+
+	png::image<png::rgba_pixel> image(width, height);
+	for (uint32_t y = 0; y < height; ++y)
+	{
+		const uint8_t* pRow = pixels.data() + static_cast<size_t>(y) * width * _NUM_CHANNELS;
+		for (uint32_t x = 0; x < width; ++x)
+		{
+			const uint8_t* pPixel = pRow + x * _NUM_CHANNELS;
+			image[y][x] = png::rgba_pixel(pPixel[0], pPixel[1], pPixel[2], pPixel[3]);
+		}
+	}
+
+	image.write(filepath);
+}
+
+void PNGImage::_decode_rows(uint8_t* pDest)
+{
+	auto& reader = _pDecoder->reader;
+	auto colorType = reader.get_color_type();
+	bool is16Bit = reader.get_bit_depth() == 16;
+
+	// Low bit depths are unpacked to a byte per sample, everything else is expanded by the kernels
+	if (reader.get_bit_depth() < 8)
+	{
+		if (colorType == png::color_type_gray)
+		{
+			reader.set_gray_1_2_4_to_8();
+		}
+		reader.set_packing();
+	}
+
+	std::array<uint32_t, 256> palette{};
+	if (colorType == png::color_type_palette)
+	{
+		const auto& colors = reader.get_info().get_palette();
+		const auto& alphas = reader.get_info().get_tRNS();
+		for (size_t i = 0; i < colors.size() && i < palette.size(); ++i)
+		{
+			uint8_t rgba[4] = { colors[i].red, colors[i].green, colors[i].blue, i < alphas.size() ? alphas[i] : uint8_t(0xFF) };
+			memcpy(&palette[i], rgba, sizeof(uint32_t));
+		}
+	}
+
+	reader.update_info();
+
+	size_t rowBytes = png_get_rowbytes(reader.get_png_struct(), reader.get_info().get_png_info());
+	size_t destRowBytes = static_cast<size_t>(_width) * _outputChannels;
+	size_t rowSamples = is16Bit ? rowBytes / 2 : rowBytes;
+
+	// RGBA and kept gray layouts only ever need their samples narrowed. At 8 bits they go straight to the destination
+	bool isFinalLayout = colorType == png::color_type_rgba || _outputChannels < _NUM_CHANNELS;
+	bool isDirect = isFinalLayout && !is16Bit;
+	std::vector<uint8_t> scratchRow(isDirect ? 0 : rowBytes);
+
+	for (uint32_t y = 0; y < _height; ++y)
+	{
+		uint8_t* pDestRow = pDest + y * destRowBytes;
+		if (isDirect)
+		{
+			reader.read_row(pDestRow);
+			continue;
+		}
+
+		uint8_t* pRow = scratchRow.data();
+		reader.read_row(pRow);
+
+		if (is16Bit)
+		{
+			PixelKernels::strip_16(pRow, isFinalLayout ? pDestRow : pRow, rowSamples);
+			if (isFinalLayout)
+			{
+				continue;
+			}
+		}
+
+		switch (colorType)
+		{
+		case png::color_type_gray:
+			PixelKernels::gray_to_rgba(pRow, pDestRow, _width);
+			break;
+		case png::color_type_gray_alpha:
+			PixelKernels::gray_alpha_to_rgba(pRow, pDestRow, _width);
+			break;
+		case png::color_type_rgb:
+			PixelKernels::rgb_to_rgba(pRow, pDestRow, _width);
+			break;
+		case png::color_type_palette:
+			PixelKernels::palette_to_rgba(pRow, pDestRow, _width, palette.data());
+			break;
+		default:
+			break;
+		}
+	}
+
+	reader.read_end_info();
+}
+
+void PNGImage::_decode_with_transforms(uint8_t* pDest)
+{
+	auto& reader = _pDecoder->reader;
+	auto colorType = reader.get_color_type();
+
+	if (colorType == png::color_type_palette)
+	{
+		reader.set_palette_to_rgb();
+	}
+
+	if (reader.has_chunk(png::chunk_tRNS))
+	{
+		reader.set_tRNS_to_alpha();
+	}
+
+	if (colorType == png::color_type_gray || colorType == png::color_type_gray_alpha)
+	{
+		if (reader.get_bit_depth() < 8)
+		{
+			reader.set_gray_1_2_4_to_8();
+		}
+
+		if (_outputChannels == _NUM_CHANNELS)
+		{
+			reader.set_gray_to_rgb();
+		}
+	}
+
+	if (reader.get_bit_depth() == 16)
+	{
+		reader.set_strip_16();
+	}
+
+	// A kept gray layout already has alpha when it needs it, from its own channel or the color key
+	if (_outputChannels == _NUM_CHANNELS)
+	{
+		reader.set_add_alpha(0xFF, png::filler_after);
+	}
+
+	// Each pass only writes the pixels it owns, so every pass can read its rows straight into the destination
+	int numPasses = png_set_interlace_handling(reader.get_png_struct());
+	reader.update_info();
+
+	size_t destRowBytes = static_cast<size_t>(_width) * _outputChannels;
+	for (int pass = 0; pass < numPasses; ++pass)
+	{
+		for (uint32_t y = 0; y < _height; ++y)
+		{
+			reader.read_row(pDest + y * destRowBytes);
+		}
+	}
+
+	reader.read_end_info();
+}
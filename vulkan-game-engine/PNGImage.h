@@ -1,40 +1,94 @@
 #pragma once
 
-#include <png++/png.hpp>
-
+#include <algorithm>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
+/*
+* Class that decodes PNG files to 8-bit RGBA, or to 8-bit gray and gray with alpha when they are kept as is
+*
+* Reading a file only parses its header. The pixels are decoded later, row by row, straight into memory the caller
+* provides, such as a mapped staging buffer, so the image never exists in an intermediate copy.
+*/
 class PNGImage
 {
 public:
 
-	using pixel_bits_t = uint32_t;
+	friend void swap(PNGImage& imgA, PNGImage& imgB)
+	{
+		using std::swap;
+
+		swap(imgA._pDecoder, imgB._pDecoder);
+		swap(imgA._width, imgB._width);
+		swap(imgA._height, imgB._height);
+		swap(imgA._sourceChannels, imgB._sourceChannels);
+		swap(imgA._outputChannels, imgB._outputChannels);
+	}
 
 	PNGImage();
 	PNGImage(const std::string& filepath);
+	PNGImage(PNGImage&& other) noexcept;
+	PNGImage& operator=(PNGImage other);
 	~PNGImage();
 
+	/* @brief Opens a PNG file and reads its header
+	*
+	* @throws std::runtime_error if the file can't be opened or isn't a PNG
+	*/
 	void read(const std::string& filepath);
-	inline pixel_bits_t* data() { return _pixels.data(); }
 
-	inline uint32_t width() const { return _image.get_width(); }
-	inline uint32_t height() const { return _image.get_height(); }
-	inline constexpr uint32_t channels() const { return _NUM_CHANNELS; }
+	/* @brief Selects how many channels `decode` writes
+	*
+	* @param numChannels Either 4 for RGBA, the default, or `source_channels()` to keep a gray or gray and alpha layout
+	* @throws std::invalid_argument for any other channel count
+	*/
+	void set_output_channels(uint32_t numChannels);
+
+	/* @brief Decodes the image as tightly packed rows of `channels()` samples. Palette, 16-bit and low bit depth images are expanded,
+	* and so are gray images unless their layout is kept
+	*
+	* @param pDest Room for `size_in_bytes()` bytes. Only written to, so write-combined memory is fine
+	* @throws std::logic_error if no file was read or the image was already decoded
+	* @throws std::runtime_error if the pixel data is corrupt
+	*/
+	void decode(void* pDest);
+
+	inline uint32_t width() const { return _width; }
+	inline uint32_t height() const { return _height; }
+	inline uint32_t channels() const { return _outputChannels; }
+
+	/* @brief Returns the fewest 8-bit channels that hold the image without loss: 1 for gray, 2 for gray with alpha or a
+	* color key and 4 for everything else
+	*/
+	inline uint32_t source_channels() const { return _sourceChannels; }
+
+	/* @brief Returns the size of the decoded pixels in bytes
+	*/
+	inline size_t size_in_bytes() const { return static_cast<size_t>(_width) * _height * _outputChannels; }
+
+	static void write_rgba(const std::string& filepath, uint32_t width, uint32_t height, const std::vector<uint8_t>& pixels);
 
 private:
 
 	static constexpr uint32_t _NUM_CHANNELS = 4;
 
-	
+	/* Open file and libpng reader, positioned after the header until the image is decoded
+	*/
+	struct _Decoder;
 
-	png::image<png::rgba_pixel> _image;
+	std::unique_ptr<_Decoder> _pDecoder;
+	uint32_t _width;
+	uint32_t _height;
+	uint32_t _sourceChannels;
+	uint32_t _outputChannels;
 
-	std::vector<pixel_bits_t> _pixels;
+	/* @brief Expands each raw row with the pixel kernels, or copies it when its layout is kept
+	*/
+	void _decode_rows(uint8_t* pDest);
 
-	void _load_pixels();
-
-	static pixel_bits_t _bits_from_struct(png::rgba_pixel pixelStruct);
-	
+	/* @brief Lets libpng expand interlaced and color-keyed images, writing each pass straight into the destination
+	*/
+	void _decode_with_transforms(uint8_t* pDest);
 };
-
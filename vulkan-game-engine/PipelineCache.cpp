@@ -0,0 +1,230 @@
+#include "PipelineCache.h"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+/*
+* CTORS
+*/
+
+PipelineCache::PipelineCache(VkDevice device, const VkPhysicalDeviceProperties& physicalProps, const std::string& filepath, bool hasCreationFeedback)
+	: _deviceHandle(device),
+	_handle(VK_NULL_HANDLE),
+	_filepath(filepath),
+	_stats({})
+{
+	auto initialData = _load_compatible_data(filepath, physicalProps);
+	_stats.loadedBytes = initialData.size();
+	_stats.hasCreationFeedback = hasCreationFeedback;
+
+	VkPipelineCacheCreateInfo createInfo{};
+	createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	createInfo.initialDataSize = initialData.size();
+	createInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+
+	if (vkCreatePipelineCache(_deviceHandle, &createInfo, nullptr, &_handle) != VK_SUCCESS)
+	{
+		// Data that passed the header check can still be rejected, an empty cache always works
+		createInfo.initialDataSize = 0;
+		createInfo.pInitialData = nullptr;
+		_stats.loadedBytes = 0;
+		if (vkCreatePipelineCache(_deviceHandle, &createInfo, nullptr, &_handle) != VK_SUCCESS)
+		{
+			throw std::runtime_error("Failed to create pipeline cache");
+		}
+	}
+}
+
+PipelineCache::~PipelineCache()
+{
+	try
+	{
+		save();
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+	}
+
+	vkDestroyPipelineCache(_deviceHandle, _handle, nullptr);
+}
+
+
+
+
+
+/*
+* PUBLIC METHOD DEFINITIONS
+*/
+
+VkPipeline PipelineCache::create_graphics_pipeline(const VkGraphicsPipelineCreateInfo& createInfo)
+{
+	VkGraphicsPipelineCreateInfo pipelineInfo = createInfo;
+
+	VkPipelineCreationFeedbackEXT pipelineFeedback{};
+	std::vector<VkPipelineCreationFeedbackEXT> stageFeedbacks;
+	VkPipelineCreationFeedbackCreateInfoEXT feedbackInfo{};
+	if (_stats.hasCreationFeedback)
+	{
+		_configure_feedback(&feedbackInfo, &pipelineFeedback, stageFeedbacks, createInfo.stageCount, createInfo.pNext);
+		pipelineInfo.pNext = &feedbackInfo;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	VkPipeline pipeline = VK_NULL_HANDLE;
+	VkResult result = vkCreateGraphicsPipelines(_deviceHandle, _handle, 1, &pipelineInfo, nullptr, &pipeline);
+	double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	if (result != VK_SUCCESS)
+	{
+		throw std::runtime_error("Failed to create graphics pipeline");
+	}
+
+	_record_creation(ms, pipelineFeedback);
+	return pipeline;
+}
+
+VkPipeline PipelineCache::create_compute_pipeline(const VkComputePipelineCreateInfo& createInfo)
+{
+	VkComputePipelineCreateInfo pipelineInfo = createInfo;
+
+	VkPipelineCreationFeedbackEXT pipelineFeedback{};
+	std::vector<VkPipelineCreationFeedbackEXT> stageFeedbacks;
+	VkPipelineCreationFeedbackCreateInfoEXT feedbackInfo{};
+	if (_stats.hasCreationFeedback)
+	{
+		_configure_feedback(&feedbackInfo, &pipelineFeedback, stageFeedbacks, 1, createInfo.pNext);
+		pipelineInfo.pNext = &feedbackInfo;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	VkPipeline pipeline = VK_NULL_HANDLE;
+	VkResult result = vkCreateComputePipelines(_deviceHandle, _handle, 1, &pipelineInfo, nullptr, &pipeline);
+	double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	if (result != VK_SUCCESS)
+	{
+		throw std::runtime_error("Failed to create compute pipeline");
+	}
+
+	_record_creation(ms, pipelineFeedback);
+	return pipeline;
+}
+
+
+
+
+/*
+* PUBLIC CONST METHOD DEFINITIONS
+*/
+
+void PipelineCache::save() const
+{
+	size_t dataSize = 0;
+	if (vkGetPipelineCacheData(_deviceHandle, _handle, &dataSize, nullptr) != VK_SUCCESS)
+	{
+		throw std::runtime_error("Failed to get pipeline cache size");
+	}
+
+	std::vector<char> data(dataSize);
+	if (vkGetPipelineCacheData(_deviceHandle, _handle, &dataSize, data.data()) != VK_SUCCESS)
+	{
+		throw std::runtime_error("Failed to get pipeline cache data");
+	}
+
+	std::string tempPath = _filepath + ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		file.write(data.data(), static_cast<std::streamsize>(dataSize));
+		if (!file)
+		{
+			throw std::runtime_error("Failed to write pipeline cache to " + tempPath);
+		}
+	}
+
+	// Renaming over the old file replaces it in one step
+	std::error_code error;
+	std::filesystem::rename(tempPath, _filepath, error);
+	if (error)
+	{
+		throw std::runtime_error("Failed to replace pipeline cache " + _filepath + ": " + error.message());
+	}
+}
+
+PipelineCache::Stats PipelineCache::stats() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _stats;
+}
+
+
+
+
+
+/*
+* PRIVATE METHOD DEFINITIONS
+*/
+
+void PipelineCache::_record_creation(double ms, const VkPipelineCreationFeedbackEXT& feedback)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_stats.pipelinesCreated++;
+	_stats.compileMs += ms;
+	if (feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT)
+	{
+		bool isHit = feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT;
+		(isHit ? _stats.cacheHits : _stats.cacheMisses)++;
+	}
+}
+
+void PipelineCache::_configure_feedback(VkPipelineCreationFeedbackCreateInfoEXT* pInfo, VkPipelineCreationFeedbackEXT* pFeedback, std::vector<VkPipelineCreationFeedbackEXT>& stageFeedbacks, uint32_t stageCount, const void* pNext) const
+{
+	stageFeedbacks.assign(stageCount, {});
+
+	memset(pInfo, 0, sizeof(VkPipelineCreationFeedbackCreateInfoEXT));
+	pInfo->sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT;
+	pInfo->pNext = pNext;
+	pInfo->pPipelineCreationFeedback = pFeedback;
+	pInfo->pipelineStageCreationFeedbackCount = stageCount;
+	pInfo->pPipelineStageCreationFeedbacks = stageFeedbacks.data();
+}
+
+
+
+
+
+/*
+* PRIVATE STATIC METHOD DEFINITIONS
+*/
+
+std::vector<char> PipelineCache::_load_compatible_data(const std::string& filepath, const VkPhysicalDeviceProperties& physicalProps)
+{
+	std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+	if (!file)
+	{
+		return {};
+	}
+
+	std::vector<char> data(static_cast<size_t>(file.tellg()));
+	file.seekg(0);
+	file.read(data.data(), static_cast<std::streamsize>(data.size()));
+	if (!file || data.size() < sizeof(VkPipelineCacheHeaderVersionOne))
+	{
+		return {};
+	}
+
+	VkPipelineCacheHeaderVersionOne header;
+	memcpy(&header, data.data(), sizeof(header));
+
+	bool isCompatible = header.headerSize >= sizeof(header) &&
+		header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+		header.vendorID == physicalProps.vendorID &&
+		header.deviceID == physicalProps.deviceID &&
+		memcmp(header.pipelineCacheUUID, physicalProps.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+
+	return isCompatible ? data : std::vector<char>();
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*
+* Class that owns a device's pipeline cache and keeps it on disk between runs
+*
+* The cache file is only used when its header matches the device's vendor, device ID and pipeline cache UUID,
+* since drivers are free to reject or even misbehave on data from another driver version. It is written back
+* when the cache is destroyed, to a temporary file first that then replaces the old one, so a crash mid-write
+* can never leave a truncated cache behind. Pipelines are created through the cache so every creation is timed,
+* and counted as a hit or miss when the driver supports VK_EXT_pipeline_creation_feedback.
+*/
+class PipelineCache
+{
+public:
+
+	/*
+	* PUBLIC STRUCTS
+	*/
+
+	/* Counters for every pipeline created through the cache
+	*/
+	struct Stats
+	{
+		uint32_t pipelinesCreated;
+
+		/* Hits and misses as reported by the driver, both stay 0 without creation feedback
+		*/
+		uint32_t cacheHits;
+		uint32_t cacheMisses;
+
+		/* Wall time spent inside pipeline creation calls
+		*/
+		double compileMs;
+
+		/* Size of the cache data accepted from disk, 0 on a cold start
+		*/
+		size_t loadedBytes;
+
+		bool hasCreationFeedback;
+	};
+
+
+
+	/*
+	* DELETED METHODS
+	*/
+
+	PipelineCache(const PipelineCache&) = delete;
+	PipelineCache& operator=(const PipelineCache&) = delete;
+
+
+
+	/*
+	* CTORS
+	*/
+
+	/*
+	* @param device Logical device the cache belongs to
+	* @param physicalProps Properties of the physical device, used to validate the file
+	* @param filepath File the cache is loaded from and saved to
+	* @param hasCreationFeedback Whether VK_EXT_pipeline_creation_feedback is enabled on the device
+	*/
+	PipelineCache(VkDevice device, const VkPhysicalDeviceProperties& physicalProps, const std::string& filepath, bool hasCreationFeedback);
+
+	/* Saves the cache to disk before destroying it
+	*/
+	~PipelineCache();
+
+
+
+	/*
+	* PUBLIC METHODS
+	*/
+
+	/* @brief Creates a graphics pipeline with the cache, timing it and recording whether the cache was hit
+	*
+	* @throws std::runtime_error if the pipeline can't be created
+	*/
+	VkPipeline create_graphics_pipeline(const VkGraphicsPipelineCreateInfo& createInfo);
+
+	/* @brief Creates a compute pipeline with the cache, timing it and recording whether the cache was hit
+	*
+	* @throws std::runtime_error if the pipeline can't be created
+	*/
+	VkPipeline create_compute_pipeline(const VkComputePipelineCreateInfo& createInfo);
+
+
+
+	/*
+	* PUBLIC CONST METHODS
+	*/
+
+	/* @brief Writes the cache data to disk, replacing the previous file
+	*
+	* @throws std::runtime_error if the file can't be written
+	*/
+	void save() const;
+
+	/* @brief Returns a copy of the creation counters
+	*/
+	Stats stats() const;
+
+	inline VkPipelineCache handle() const { return _handle; }
+
+private:
+
+	/*
+	* PRIVATE MEMBERS
+	*/
+
+	VkDevice _deviceHandle;
+	VkPipelineCache _handle;
+
+	/* File the cache is loaded from and saved to
+	*/
+	std::string _filepath;
+
+	Stats _stats;
+
+	/* Guards the counters, pipelines may be created from several threads
+	*/
+	mutable std::mutex _mutex;
+
+
+
+	/*
+	* PRIVATE METHODS
+	*/
+
+	/* @brief Adds a created pipeline to the counters
+	*
+	* @param feedback Creation feedback filled by the driver, ignored unless marked valid
+	*/
+	void _record_creation(double ms, const VkPipelineCreationFeedbackEXT& feedback);
+
+	/* @brief Fills the creation feedback chain for a pipeline with the given number of stages
+	*
+	* @param[out] pInfo The struct to fill, linked in front of `pNext`
+	* @param[out] pFeedback Receives the whole-pipeline feedback
+	* @param[out] stageFeedbacks Receives the per-stage feedback
+	*/
+	void _configure_feedback(VkPipelineCreationFeedbackCreateInfoEXT* pInfo, VkPipelineCreationFeedbackEXT* pFeedback, std::vector<VkPipelineCreationFeedbackEXT>& stageFeedbacks, uint32_t stageCount, const void* pNext) const;
+
+
+
+	/*
+	* PRIVATE STATIC METHODS
+	*/
+
+	/* @brief Reads a cache file, returning nothing if it is missing or was written for another device or driver
+	*/
+	static std::vector<char> _load_compatible_data(const std::string& filepath, const VkPhysicalDeviceProperties& physicalProps);
+};
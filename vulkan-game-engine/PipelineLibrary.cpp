@@ -0,0 +1,146 @@
+#include "PipelineLibrary.h"
+
+#include <chrono>
+#include <stdexcept>
+
+/*
+* CTORS
+*/
+
+PipelineLibrary::PipelineLibrary(const Device& device, std::shared_ptr<const std::vector<Shader>> shaders, VkDescriptorSetLayout setLayout, unsigned numThreads)
+	: _device(device),
+	_shaders(shaders),
+	_setLayout(setLayout),
+	_entries(),
+	_pool(numThreads)
+{
+}
+
+
+
+
+
+/*
+* PUBLIC METHOD DEFINITIONS
+*/
+
+void PipelineLibrary::request(const GraphicsPipeline::Desc& desc)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_find_or_queue(desc);
+}
+
+const GraphicsPipeline& PipelineLibrary::get(const GraphicsPipeline::Desc& desc)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	auto hash = desc.hash();
+	auto it = _entries.find(hash);
+	if (it == _entries.end())
+	{
+		// Nothing to wait on, so compiling here saves a round trip through the pool
+		auto pipeline = std::make_unique<GraphicsPipeline>(_device, desc, *_shaders, _setLayout);
+		auto& entry = _entries[hash];
+		entry.desc = desc;
+		entry.pipeline = std::move(pipeline);
+		return *entry.pipeline;
+	}
+
+	auto& entry = it->second;
+	if (entry.desc != desc)
+	{
+		throw std::logic_error("Pipeline descriptions collided on the same hash");
+	}
+
+	if (entry.pending.valid())
+	{
+		try
+		{
+			entry.pipeline = entry.pending.get();
+		}
+		catch (...)
+		{
+			_entries.erase(it);
+			throw;
+		}
+	}
+
+	return *entry.pipeline;
+}
+
+const GraphicsPipeline* PipelineLibrary::find_ready(const GraphicsPipeline::Desc& desc)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	auto it = _entries.find(desc.hash());
+	if (it == _entries.end() || it->second.desc != desc)
+	{
+		return nullptr;
+	}
+
+	auto& entry = it->second;
+	if (entry.pending.valid())
+	{
+		if (entry.pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			return nullptr;
+		}
+
+		// A failed compile is dropped so the variant can be requested again
+		try
+		{
+			entry.pipeline = entry.pending.get();
+		}
+		catch (...)
+		{
+			_entries.erase(it);
+			throw;
+		}
+	}
+
+	return entry.pipeline.get();
+}
+
+
+
+
+
+/*
+* PUBLIC CONST METHOD DEFINITIONS
+*/
+
+size_t PipelineLibrary::size() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _entries.size();
+}
+
+
+
+
+
+/*
+* PRIVATE METHOD DEFINITIONS
+*/
+
+PipelineLibrary::_Entry& PipelineLibrary::_find_or_queue(const GraphicsPipeline::Desc& desc)
+{
+	auto hash = desc.hash();
+	auto it = _entries.find(hash);
+	if (it != _entries.end())
+	{
+		if (it->second.desc != desc)
+		{
+			throw std::logic_error("Pipeline descriptions collided on the same hash");
+		}
+		return it->second;
+	}
+
+	auto& entry = _entries[hash];
+	entry.desc = desc;
+	entry.pending = _pool.submit([this, desc]() {
+		return std::make_unique<GraphicsPipeline>(_device, desc, *_shaders, _setLayout);
+	});
+
+	return entry;
+}
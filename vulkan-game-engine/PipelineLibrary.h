@@ -0,0 +1,129 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "Device.h"
+#include "Shader.h"
+#include "GraphicsPipeline.h"
+#include "ThreadPool.h"
+
+/*
+* Class that builds and deduplicates the graphics pipeline variants of one shader set
+*
+* Variants are keyed by the hash of their description, so requesting the same state twice returns the same pipeline.
+* New variants compile on worker threads, letting the render loop keep drawing with a pipeline that is already
+* built until the variant is ready instead of stalling a frame on the driver's compiler.
+*/
+class PipelineLibrary
+{
+public:
+
+	/*
+	* DELETED METHODS
+	*/
+
+	PipelineLibrary(const PipelineLibrary&) = delete;
+	PipelineLibrary& operator=(const PipelineLibrary&) = delete;
+
+
+
+	/*
+	* CTORS
+	*/
+
+	/*
+	* @param device Device the pipelines are created on
+	* @param shaders Shaders every variant is built from, kept alive until the library is destroyed
+	* @param setLayout Layout of the descriptor set bound with every variant, it must outlive the library
+	* @param numThreads Number of compile threads
+	*/
+	PipelineLibrary(const Device& device, std::shared_ptr<const std::vector<Shader>> shaders, VkDescriptorSetLayout setLayout, unsigned numThreads = 1);
+
+
+
+	/*
+	* PUBLIC METHODS
+	*/
+
+	/* @brief Queues a variant for compilation unless it was already requested
+	*/
+	void request(const GraphicsPipeline::Desc& desc);
+
+	/* @brief Returns a variant, compiling it on this thread or waiting for its queued compile if it isn't ready
+	*
+	* @throws std::runtime_error if the pipeline can't be created
+	*/
+	const GraphicsPipeline& get(const GraphicsPipeline::Desc& desc);
+
+	/* @brief Returns a variant if it has finished compiling, or nullptr if it is still pending or was never requested
+	*
+	* @throws std::runtime_error if the variant failed to compile
+	*/
+	const GraphicsPipeline* find_ready(const GraphicsPipeline::Desc& desc);
+
+
+
+	/*
+	* PUBLIC CONST METHODS
+	*/
+
+	/* @brief Returns the number of variants requested so far, pending ones included
+	*/
+	size_t size() const;
+
+private:
+
+	/*
+	* PRIVATE STRUCTS
+	*/
+
+	/* A requested variant. The future is only valid until the pipeline has been collected from it
+	*/
+	struct _Entry
+	{
+		GraphicsPipeline::Desc desc;
+		std::future<std::unique_ptr<GraphicsPipeline>> pending;
+		std::unique_ptr<GraphicsPipeline> pipeline;
+	};
+
+
+
+	/*
+	* PRIVATE MEMBERS
+	*/
+
+	Device _device;
+	std::shared_ptr<const std::vector<Shader>> _shaders;
+	VkDescriptorSetLayout _setLayout;
+
+	/* Requested variants keyed by the hash of their description
+	*/
+	std::unordered_map<uint64_t, _Entry> _entries;
+
+	/* Guards the entries
+	*/
+	mutable std::mutex _mutex;
+
+	/* Compile threads. Declared last so queued compiles finish before anything they use is destroyed
+	*/
+	ThreadPool _pool;
+
+
+
+	/*
+	* PRIVATE METHODS
+	*/
+
+	/* @brief Returns the entry of a description, creating it and queueing its compile if it doesn't exist. Must be called with the mutex held
+	*
+	* @throws std::logic_error if a different description already has the same hash
+	*/
+	_Entry& _find_or_queue(const GraphicsPipeline::Desc& desc);
+};
@@ -0,0 +1,237 @@
+#include "PixelKernels.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define PIXEL_KERNELS_AVX2
+#elif defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define PIXEL_KERNELS_SSE2
+#endif
+
+#if defined(PIXEL_KERNELS_AVX2) || defined(PIXEL_KERNELS_SSE2)
+#define PIXEL_KERNELS_SIMD
+#endif
+
+static constexpr uint32_t OPAQUE_ALPHA = 0xFF000000u;
+
+/* @brief Packs four channel values into the byte order of an RGBA pixel
+*/
+static inline uint32_t pack_rgba(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+{
+	uint8_t bytes[4] = { r, g, b, a };
+	uint32_t pixel;
+	memcpy(&pixel, bytes, sizeof(pixel));
+	return pixel;
+}
+
+/* @brief Returns a table decoding every 8-bit sRGB value to linear intensity
+*/
+static const std::array<float, 256>& srgb_to_linear_table()
+{
+	static const std::array<float, 256> table = []()
+	{
+		std::array<float, 256> values{};
+		for (size_t i = 0; i < values.size(); ++i)
+		{
+			float c = static_cast<float>(i) / 255.0f;
+			values[i] = (c <= 0.04045f) ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+		}
+		return values;
+	}();
+	return table;
+}
+
+/* @brief Encodes a linear intensity back to an 8-bit sRGB value
+*/
+static inline uint8_t linear_to_srgb(float c)
+{
+	float encoded = (c <= 0.0031308f) ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+	return static_cast<uint8_t>(std::clamp(encoded * 255.0f + 0.5f, 0.0f, 255.0f));
+}
+
+
+
+
+
+/*
+* PUBLIC STATIC METHOD DEFINITIONS
+*/
+
+const char* PixelKernels::instruction_set()
+{
+#if defined(PIXEL_KERNELS_AVX2)
+	return "AVX2";
+#elif defined(PIXEL_KERNELS_SSE2)
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
+
+void PixelKernels::gray_to_rgba(const uint8_t* pSrc, uint8_t* pDst, size_t count)
+{
+	size_t i = 0;
+
+#if defined(PIXEL_KERNELS_SIMD)
+	const __m128i alpha = _mm_set1_epi32(static_cast<int>(OPAQUE_ALPHA));
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i gray = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i));
+
+		// Doubling each byte twice turns one gray sample into four equal channels
+		__m128i pairsLow = _mm_unpacklo_epi8(gray, gray);
+		__m128i pairsHigh = _mm_unpackhi_epi8(gray, gray);
+
+		__m128i* pOut = reinterpret_cast<__m128i*>(pDst + i * 4);
+		_mm_storeu_si128(pOut + 0, _mm_or_si128(_mm_unpacklo_epi16(pairsLow, pairsLow), alpha));
+		_mm_storeu_si128(pOut + 1, _mm_or_si128(_mm_unpackhi_epi16(pairsLow, pairsLow), alpha));
+		_mm_storeu_si128(pOut + 2, _mm_or_si128(_mm_unpacklo_epi16(pairsHigh, pairsHigh), alpha));
+		_mm_storeu_si128(pOut + 3, _mm_or_si128(_mm_unpackhi_epi16(pairsHigh, pairsHigh), alpha));
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		uint32_t pixel = pack_rgba(pSrc[i], pSrc[i], pSrc[i], 0xFF);
+		memcpy(pDst + i * 4, &pixel, sizeof(pixel));
+	}
+}
+
+void PixelKernels::gray_alpha_to_rgba(const uint8_t* pSrc, uint8_t* pDst, size_t count)
+{
+	size_t i = 0;
+
+#if defined(PIXEL_KERNELS_SIMD)
+	const __m128i grayMask = _mm_set1_epi32(0xFF);
+	const __m128i keepMask = _mm_set1_epi32(static_cast<int>(0xFFFF00FFu));
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i pairs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i * 2));
+
+		// Doubling each gray and alpha pair gives G A G A, the second byte is then replaced by the gray sample
+		__m128i low = _mm_unpacklo_epi16(pairs, pairs);
+		__m128i high = _mm_unpackhi_epi16(pairs, pairs);
+		low = _mm_or_si128(_mm_and_si128(low, keepMask), _mm_slli_epi32(_mm_and_si128(low, grayMask), 8));
+		high = _mm_or_si128(_mm_and_si128(high, keepMask), _mm_slli_epi32(_mm_and_si128(high, grayMask), 8));
+
+		__m128i* pOut = reinterpret_cast<__m128i*>(pDst + i * 4);
+		_mm_storeu_si128(pOut + 0, low);
+		_mm_storeu_si128(pOut + 1, high);
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		uint8_t gray = pSrc[i * 2];
+		uint32_t pixel = pack_rgba(gray, gray, gray, pSrc[i * 2 + 1]);
+		memcpy(pDst + i * 4, &pixel, sizeof(pixel));
+	}
+}
+
+void PixelKernels::rgb_to_rgba(const uint8_t* pSrc, uint8_t* pDst, size_t count)
+{
+	size_t i = 0;
+
+#if defined(PIXEL_KERNELS_AVX2)
+	// SSE2 has no byte shuffle, so only builds with AVX2 (and with it SSSE3) vectorize this one
+	const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+	const __m128i alpha = _mm_set1_epi32(static_cast<int>(OPAQUE_ALPHA));
+
+	// Each load reads 16 bytes but only uses 12, so stop while a full load still fits in the source
+	for (; i + 6 <= count; i += 4)
+	{
+		__m128i rgb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i * 3));
+		__m128i rgba = _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alpha);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i * 4), rgba);
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		const uint8_t* pPixel = pSrc + i * 3;
+		uint32_t pixel = pack_rgba(pPixel[0], pPixel[1], pPixel[2], 0xFF);
+		memcpy(pDst + i * 4, &pixel, sizeof(pixel));
+	}
+}
+
+void PixelKernels::palette_to_rgba(const uint8_t* pSrc, uint8_t* pDst, size_t count, const uint32_t* pPalette)
+{
+	size_t i = 0;
+
+#if defined(PIXEL_KERNELS_AVX2)
+	const int* pTable = reinterpret_cast<const int*>(pPalette);
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i indexBytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pSrc + i));
+		__m256i colors = _mm256_i32gather_epi32(pTable, _mm256_cvtepu8_epi32(indexBytes), 4);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst + i * 4), colors);
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		memcpy(pDst + i * 4, &pPalette[pSrc[i]], sizeof(uint32_t));
+	}
+}
+
+void PixelKernels::strip_16(const uint8_t* pSrc, uint8_t* pDst, size_t count)
+{
+	size_t i = 0;
+
+#if defined(PIXEL_KERNELS_SIMD)
+	// Loaded as little-endian words the high byte of each big-endian sample is the low byte of the word
+	const __m128i highByteMask = _mm_set1_epi16(0xFF);
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i * 2));
+		__m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i * 2 + 16));
+		__m128i packed = _mm_packus_epi16(_mm_and_si128(first, highByteMask), _mm_and_si128(second, highByteMask));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i), packed);
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		pDst[i] = pSrc[i * 2];
+	}
+}
+
+void PixelKernels::downsample(const uint8_t* pSrc, uint32_t width, uint32_t height, uint32_t numChannels, uint8_t* pDst, bool isSrgb)
+{
+	const auto& toLinear = srgb_to_linear_table();
+	uint32_t alphaChannel = (numChannels == 2 || numChannels == 4) ? numChannels - 1 : numChannels;
+
+	uint32_t dstWidth = std::max(1u, width / 2);
+	uint32_t dstHeight = std::max(1u, height / 2);
+	for (uint32_t y = 0; y < dstHeight; ++y)
+	{
+		const uint8_t* pRow0 = pSrc + static_cast<size_t>(std::min(y * 2, height - 1)) * width * numChannels;
+		const uint8_t* pRow1 = pSrc + static_cast<size_t>(std::min(y * 2 + 1, height - 1)) * width * numChannels;
+		uint8_t* pDstRow = pDst + static_cast<size_t>(y) * dstWidth * numChannels;
+
+		for (uint32_t x = 0; x < dstWidth; ++x)
+		{
+			size_t left = static_cast<size_t>(std::min(x * 2, width - 1)) * numChannels;
+			size_t right = static_cast<size_t>(std::min(x * 2 + 1, width - 1)) * numChannels;
+
+			for (size_t c = 0; c < numChannels; ++c)
+			{
+				uint8_t samples[4] = { pRow0[left + c], pRow0[right + c], pRow1[left + c], pRow1[right + c] };
+				if (isSrgb && c != alphaChannel)
+				{
+					float sum = toLinear[samples[0]] + toLinear[samples[1]] + toLinear[samples[2]] + toLinear[samples[3]];
+					pDstRow[x * numChannels + c] = linear_to_srgb(sum * 0.25f);
+				}
+				else
+				{
+					pDstRow[x * numChannels + c] = static_cast<uint8_t>((samples[0] + samples[1] + samples[2] + samples[3] + 2) / 4);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+* Class of kernels that expand decoded image rows to 8-bit RGBA and downsample 8-bit images
+*
+* Like MeshKernels, each kernel is compiled for the widest instruction set the build targets: AVX2 when compiled
+* with it, SSE2 on any x86-64 build and plain scalar code elsewhere. Sources and destinations may be unaligned.
+*/
+class PixelKernels
+{
+public:
+
+	/*
+	* PUBLIC STATIC METHODS
+	*/
+
+	/* @brief Returns the name of the instruction set the kernels were compiled for
+	*/
+	static const char* instruction_set();
+
+	/* @brief Replicates 8-bit gray samples into RGB and adds an opaque alpha
+	*
+	* @param pSrc `count` gray bytes
+	* @param pDst Room for `count` RGBA pixels, must not overlap the source
+	* @param count Number of pixels
+	*/
+	static void gray_to_rgba(const uint8_t* pSrc, uint8_t* pDst, size_t count);
+
+	/* @brief Replicates the gray sample of 8-bit gray and alpha pairs into RGB
+	*/
+	static void gray_alpha_to_rgba(const uint8_t* pSrc, uint8_t* pDst, size_t count);
+
+	/* @brief Adds an opaque alpha to 8-bit RGB pixels
+	*/
+	static void rgb_to_rgba(const uint8_t* pSrc, uint8_t* pDst, size_t count);
+
+	/* @brief Looks up 8-bit palette indices in a table of RGBA colors
+	*
+	* @param pPalette 256 colors, each packed as R, G, B, A bytes. Entries past the PNG's palette should be zeroed
+	*/
+	static void palette_to_rgba(const uint8_t* pSrc, uint8_t* pDst, size_t count, const uint32_t* pPalette);
+
+	/* @brief Reduces big-endian 16-bit samples to 8 bits by keeping their high byte
+	*
+	* @param pSrc `count` 16-bit samples as stored in a PNG row
+	* @param pDst Room for `count` bytes. May be the same pointer as the source
+	* @param count Number of samples, not pixels
+	*/
+	static void strip_16(const uint8_t* pSrc, uint8_t* pDst, size_t count);
+
+	/* @brief Halves an 8-bit image with a 2x2 box filter, producing the next level of a mip chain
+	*
+	* Odd edges repeat their last row or column. Scalar on every instruction set, it only backs mip generation
+	* for formats the GPU cannot blit
+	*
+	* @param numChannels 1 for gray, 2 for gray and alpha or 4 for RGBA. The last of 2 or 4 channels is alpha
+	* @param pDst Room for max(1, width / 2) x max(1, height / 2) texels
+	* @param isSrgb Whether color channels are sRGB encoded and should be averaged in linear space. Alpha never is
+	*/
+	static void downsample(const uint8_t* pSrc, uint32_t width, uint32_t height, uint32_t numChannels, uint8_t* pDst, bool isSrgb);
+};
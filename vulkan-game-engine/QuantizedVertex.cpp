@@ -0,0 +1,88 @@
+#include "QuantizedVertex.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "MeshKernels.h"
+
+static_assert(sizeof(QuantizedVertex) == QuantizedVertex::Layout::STRIDE, "QuantizedVertex must stay tightly packed");
+
+/* @brief Maps a value in [lower, lower + extent] onto the full UNORM16 range
+*/
+static inline uint16_t quantize_unorm16(float value, float lower, float invExtent)
+{
+	float normalized = std::clamp((value - lower) * invExtent, 0.0f, 1.0f);
+	return static_cast<uint16_t>(std::lround(normalized * 65535.0f));
+}
+
+/* @brief Returns the reciprocal of an extent. Flat axes quantize to zero and decode back to their single value
+*/
+static inline float safe_inverse(float extent)
+{
+	return extent > 0.0f ? 1.0f / extent : 0.0f;
+}
+
+/*
+* STATIC METHOD DEFINITIONS
+*/
+
+QuantizedVertex::Decode QuantizedVertex::identity_decode()
+{
+	return { glm::mat4(1.0f), glm::vec4(0.0f, 0.0f, 1.0f, 1.0f) };
+}
+
+std::vector<QuantizedVertex> QuantizedVertex::quantize(const std::vector<Vertex>& vertices, Decode& decode)
+{
+	glm::vec3 posMin;
+	glm::vec3 posMax;
+	MeshKernels::compute_bounds(vertices.data(), vertices.size(), posMin, posMax);
+
+	glm::vec2 texMin = vertices.empty() ? glm::vec2(0.0f) : vertices[0].tex_coord();
+	glm::vec2 texMax = texMin;
+	for (const auto& vertex : vertices)
+	{
+		texMin = glm::min(texMin, vertex.tex_coord());
+		texMax = glm::max(texMax, vertex.tex_coord());
+	}
+
+	glm::vec3 posExtent = posMax - posMin;
+	glm::vec2 texExtent = texMax - texMin;
+	glm::vec3 posInverse(safe_inverse(posExtent.x), safe_inverse(posExtent.y), safe_inverse(posExtent.z));
+	glm::vec2 texInverse(safe_inverse(texExtent.x), safe_inverse(texExtent.y));
+
+	std::vector<QuantizedVertex> quantized(vertices.size());
+	for (size_t i = 0; i < vertices.size(); ++i)
+	{
+		const auto& pos = vertices[i].position();
+		const auto& texCoord = vertices[i].tex_coord();
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			quantized[i]._pos[axis] = quantize_unorm16(pos[axis], posMin[axis], posInverse[axis]);
+		}
+		quantized[i]._pos[3] = 0;
+
+		quantized[i]._texCoord[0] = quantize_unorm16(texCoord.x, texMin.x, texInverse.x);
+		quantized[i]._texCoord[1] = quantize_unorm16(texCoord.y, texMin.y, texInverse.y);
+	}
+
+	decode.position = glm::scale(glm::translate(glm::mat4(1.0f), posMin), posExtent);
+	decode.texCoord = glm::vec4(texMin, texExtent);
+	return quantized;
+}
+
+VkVertexInputBindingDescription QuantizedVertex::getBindingDescription()
+{
+	return Layout::BINDING;
+}
+
+std::array<VkVertexInputAttributeDescription, QuantizedVertex::Layout::ATTRIBUTE_COUNT> QuantizedVertex::getAttributeDescriptions()
+{
+	static_assert(offsetof(QuantizedVertex, _pos) == Layout::OFFSETS[0], "QuantizedVertex members don't match its layout");
+	static_assert(offsetof(QuantizedVertex, _texCoord) == Layout::OFFSETS[1], "QuantizedVertex members don't match its layout");
+
+	return Layout::ATTRIBUTES;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Vertex.h"
+#include "VertexLayout.h"
+
+/* Vertex layouts a mesh can be uploaded and drawn with
+*/
+enum class VertexFormat
+{
+	/* Vertex, 32 bytes of floats
+	*/
+	FULL,
+
+	/* QuantizedVertex, 12 bytes of UNORM16 with the constant color dropped
+	*/
+	QUANTIZED
+};
+
+/*
+* Class describing a compressed mesh vertex
+*
+* Positions and texture coordinates are stored as 16-bit UNORM values relative to the bounds of their mesh.
+* The vertex input stage turns them into floats in [0, 1], which the shader maps back with the decode
+* transforms the mesh was quantized with. The color attribute is dropped, imported meshes are always white.
+*/
+class QuantizedVertex
+{
+public:
+
+	/* Interleaved layout of the members. Texture coordinates keep location 2 so shaders don't renumber their inputs
+	*/
+	using Layout = VertexLayout<PositionUnorm16, TexCoordUnorm16>;
+
+	/*
+	* PUBLIC STRUCTS
+	*/
+
+	/* Maps quantized attributes back into mesh space
+	*/
+	struct Decode
+	{
+		/* Scales and offsets a [0, 1] position into the mesh bounds. Meant to be folded into the model matrix
+		*/
+		glm::mat4 position;
+
+		/* Offset in xy and scale in zw applied to [0, 1] texture coordinates
+		*/
+		glm::vec4 texCoord;
+	};
+
+
+
+	/*
+	* PUBLIC STATIC METHODS
+	*/
+
+	/* @brief Returns the decode transforms of unquantized vertices
+	*/
+	static Decode identity_decode();
+
+	/* @brief Quantizes a vertex array against its own bounds
+	*
+	* @param vertices Vertices to quantize
+	* @param decode Receives the transforms that undo the quantization
+	*/
+	static std::vector<QuantizedVertex> quantize(const std::vector<Vertex>& vertices, Decode& decode);
+
+	/* @brief Returns binding description used for vertex input pipeline stage
+	*/
+	static VkVertexInputBindingDescription getBindingDescription();
+
+	/* @brief Returns attribute descriptions used for vertex input pipeline stage
+	*/
+	static std::array<VkVertexInputAttributeDescription, Layout::ATTRIBUTE_COUNT> getAttributeDescriptions();
+
+private:
+
+	/*
+	* PRIVATE MEMBERS
+	*/
+
+	/* Position in the mesh bounds. The fourth component pads the attribute to a format every device can fetch
+	*/
+	uint16_t _pos[4];
+
+	/* Texture coordinates in the texture coordinate bounds
+	*/
+	uint16_t _texCoord[2];
+};
@@ -118,11 +118,15 @@ void QueueFamilyInfo::load_queue_family_indices(VkPhysicalDevice physicalDevice,
 				_set_index_value(QueueFamilyType::Graphics, i);
 			}
 
-			VkBool32 surfaceHasPresentSupport = false;
-			vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &surfaceHasPresentSupport);
-			if (surfaceHasPresentSupport)
+			// Present support can't be queried without a surface, e.g. when rendering offscreen
+			if (surface != VK_NULL_HANDLE)
 			{
-				_set_index_value(QueueFamilyType::Present, i);
+				VkBool32 surfaceHasPresentSupport = false;
+				vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &surfaceHasPresentSupport);
+				if (surfaceHasPresentSupport)
+				{
+					_set_index_value(QueueFamilyType::Present, i);
+				}
 			}
 
 			i++;
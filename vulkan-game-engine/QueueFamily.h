@@ -73,7 +73,7 @@ public:
 	* PUBLIC METHODS
 	*/
 
-	/* @brief Loads queue family indices based on the given device and surface
+	/* @brief Loads queue family indices based on the given device and surface. The present family is left unknown if `surface` is null
 	*/
 	void load_queue_family_indices(VkPhysicalDevice physicalDevice, VkSurfaceKHR surface);
 
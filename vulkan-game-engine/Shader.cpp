@@ -1,7 +1,48 @@
 #include "Shader.h"
 
-#include <fstream>
-#include <sstream>
+#include <stdexcept>
+
+#include "MappedFile.h"
+
+/*
+* PUBLIC STATIC METHOD DEFINITIONS
+*/
+
+std::vector<uint32_t> Shader::declared_constants(const std::string& filepath)
+{
+    MappedFile file(filepath);
+    const auto* pCode = reinterpret_cast<const uint32_t*>(file.data());
+    size_t numWords = file.size() / sizeof(uint32_t);
+
+    if (numWords < _SPIRV_HEADER_WORDS || file.size() % sizeof(uint32_t) != 0 || pCode[0] != _SPIRV_MAGIC)
+    {
+        throw std::runtime_error("Shader file " + filepath + " is not SPIR-V");
+    }
+
+    // Each instruction starts with its word count in the high half and its opcode in the low half
+    std::vector<uint32_t> constantIds;
+    for (size_t i = _SPIRV_HEADER_WORDS; i < numWords;)
+    {
+        uint32_t wordCount = pCode[i] >> 16;
+        uint32_t opcode = pCode[i] & 0xFFFF;
+        if (wordCount == 0 || i + wordCount > numWords)
+        {
+            throw std::runtime_error("Shader file " + filepath + " has a truncated instruction");
+        }
+
+        if (opcode == _OP_DECORATE && wordCount >= 4 && pCode[i + 2] == _DECORATION_SPEC_ID)
+        {
+            constantIds.push_back(pCode[i + 3]);
+        }
+        i += wordCount;
+    }
+
+    return constantIds;
+}
+
+
+
+
 
 /*
 * CTOR / ASSIGNMENT DEFINITONS
@@ -10,33 +51,38 @@
 Shader::Shader()
 	: VulkanObject(),
 	_shaderType(Type::NONE),
-	_shaderCode({}),
-    _filepath({})
+    _filepath({}),
+    _module(nullptr),
+    _constants()
 {
 }
 
 Shader::Shader(const std::string& filepath, Type shaderType, const Device& device)
     : VulkanObject(device.handle()),
-    _shaderType(Type::NONE),
-    _shaderCode({}),
-    _filepath(filepath)
+    _shaderType(shaderType),
+    _filepath(filepath),
+    _module(nullptr),
+    _constants()
 {
-    load_shader(filepath, shaderType);
+    // Mapped views start on a page boundary, so the words can be passed to the driver in place
+    MappedFile file(filepath);
+    const auto* pCode = reinterpret_cast<const uint32_t*>(file.data());
 
-    VkShaderModuleCreateInfo createInfo{};
-    _configure_module(&createInfo);
-
-    if (vkCreateShaderModule(_deviceHandle, &createInfo, nullptr, &_handle) != VK_SUCCESS)
+    if (file.size() == 0 || file.size() % sizeof(uint32_t) != 0 || pCode[0] != _SPIRV_MAGIC)
     {
-        throw std::runtime_error("Failed to create shader module");
+        throw std::runtime_error("Shader file " + filepath + " is not SPIR-V");
     }
+
+    _module = device.shader_modules()->acquire(pCode, file.size());
+    _handle = *_module;
 }
 
 Shader::Shader(const Shader& other)
     : VulkanObject(other),
     _shaderType(other._shaderType),
     _filepath(other._filepath),
-    _shaderCode(other._shaderCode)
+    _module(other._module),
+    _constants(other._constants)
 {
 }
 
@@ -53,57 +99,4 @@ Shader& Shader::operator=(Shader other)
 
 Shader::~Shader()
 {
-    if (_deviceHandle != VK_NULL_HANDLE && _handle != VK_NULL_HANDLE)
-    {
-        vkDestroyShaderModule(_deviceHandle, _handle, nullptr);
-    }
-}
-
-
-
-
-
-/*
-* PUBLIC METHOD DEFINITIONS
-*/
-
-void Shader::load_shader(const std::string & filepath, Type shaderType)
-{
-    std::ifstream file(filepath, std::ios::ate | std::ios::binary);
-
-    if (!file.is_open())
-    {
-        throw std::runtime_error("Failed to open shader file");
-    }
-    file.unsetf(std::ios::skipws);
-
-    std::streampos fileSize;
-    file.seekg(0, std::ios::end);
-    fileSize = file.tellg();
-    file.seekg(0, std::ios::beg);
-    _shaderCode.reserve(fileSize);
-
-    _shaderCode.insert(_shaderCode.begin(),
-        std::istream_iterator<char>(file),
-        std::istream_iterator<char>());
-
-    file.close();
-
-    _shaderType = shaderType;
 }
-
-
-
-
-
-/*
-* PRIVATE CONST METHOD DEFINITIONS
-*/
-
-void Shader::_configure_module(VkShaderModuleCreateInfo* pCreateInfo) const
-{
-    memset(pCreateInfo, 0, sizeof(VkShaderModuleCreateInfo));
-    pCreateInfo->sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-    pCreateInfo->codeSize = _shaderCode.size();
-    pCreateInfo->pCode = reinterpret_cast<const uint32_t*>(_shaderCode.data());
-}
\ No newline at end of file
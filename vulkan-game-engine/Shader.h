@@ -6,9 +6,14 @@
 
 #include "VulkanObject.h"
 #include "Device.h"
+#include "ShaderModuleCache.h"
+#include "SpecializationConstants.h"
 
 /*
 * Class that implements a Vulkan shader
+*
+* The module comes from the device's shader module cache, so copies and shaders loaded from identical files
+* share it. The SPIR-V itself is only mapped while the module is created.
 */
 class Shader : public VulkanObject<VkShaderModule>
 {
@@ -28,6 +33,40 @@ public:
 
 
 
+	/*
+	* PUBLIC STATIC CONSTANTS
+	*/
+
+	/* Specialization constant IDs declared by the engine's shaders
+	*/
+
+	/* Fragment shader samples the texture when true, and outputs the vertex color otherwise
+	*/
+	static constexpr uint32_t USE_TEXTURE_CONSTANT = 0;
+
+	/* Fragment shader discards fragments whose alpha is below ALPHA_CUTOFF_CONSTANT
+	*/
+	static constexpr uint32_t ALPHA_TEST_CONSTANT = 1;
+	static constexpr uint32_t ALPHA_CUTOFF_CONSTANT = 2;
+
+	/* Quantized vertex shader applies the UBO's texture coordinate decode. Off when the mesh's coordinates already span [0, 1]
+	*/
+	static constexpr uint32_t DECODE_TEX_COORDS_CONSTANT = 3;
+
+
+
+	/*
+	* PUBLIC STATIC METHODS
+	*/
+
+	/* @brief Returns the IDs of the specialization constants a SPIR-V file declares, without creating a module
+	*
+	* @throws std::runtime_error if the file can't be read or isn't SPIR-V
+	*/
+	static std::vector<uint32_t> declared_constants(const std::string& filepath);
+
+
+
 	/*
 	* PUBLIC FRIEND METHODS
 	*/
@@ -40,8 +79,9 @@ public:
 
 		swap(shaderA._handle, shaderB._handle);
 		swap(shaderA._shaderType, shaderB._shaderType);
-		swap(shaderA._shaderCode, shaderB._shaderCode);
 		swap(shaderA._filepath, shaderB._filepath);
+		swap(shaderA._module, shaderB._module);
+		swap(shaderA._constants, shaderB._constants);
 	}
 
 
@@ -54,6 +94,7 @@ public:
 	/*
 	* @param filepath Path to shader file to load
 	* @param device Device being used
+	* @throws std::runtime_error if the file can't be read or isn't SPIR-V
 	*/
 	Shader(const std::string& filepath, Type shaderType, const Device& device);
 	Shader(const Shader& other);
@@ -67,12 +108,9 @@ public:
 	* PUBLIC METHODS
 	*/
 
-	/* @brief Loads shader code from the given file
-	* 
-	* @param filepath Path to shader file
-	* @param shaderType The type of shader that is being loaded
+	/* @brief Sets the specialization constants this shader is built with. Copies share the module, so a specialized copy is cheap
 	*/
-	void load_shader(const std::string& filepath, Type shaderType);
+	inline void set_constants(const SpecializationConstants& constants) { _constants = constants; }
 
 
 
@@ -84,6 +122,14 @@ public:
 	*/
 	inline Type shader_type() const { return _shaderType; }
 
+	/* @brief Returns the path of the file the shader was loaded from
+	*/
+	inline const std::string& filepath() const { return _filepath; }
+
+	/* @brief Returns the specialization constants this shader is built with, before any pipeline overrides
+	*/
+	inline const SpecializationConstants& constants() const { return _constants; }
+
 private:
 
 	/*
@@ -98,18 +144,31 @@ private:
 	*/
 	std::string _filepath;
 
-	/* The binary content of the shader file
+	/* Module shared with every shader using the same code. `_handle` stays valid while this is held
+	*/
+	ShaderModuleCache::Module _module;
+
+	/* Specialization constants applied when a pipeline is created with this shader
 	*/
-	std::vector<char> _shaderCode;
+	SpecializationConstants _constants;
 
 
 
 	/*
-	* PRIVATE CONST METHODS
+	* PRIVATE STATIC CONSTANTS
+	*/
+
+	/* First word of every SPIR-V binary
+	*/
+	static constexpr uint32_t _SPIRV_MAGIC = 0x07230203;
+
+	/* Words before the first instruction of a SPIR-V binary
 	*/
+	static constexpr size_t _SPIRV_HEADER_WORDS = 5;
 
-	/* @brief Fills struct with necessary info for creating shader module
+	/* OpDecorate opcode and the SpecId decoration it carries for specialization constants
 	*/
-	void _configure_module(VkShaderModuleCreateInfo* pCreateInfo) const;
+	static constexpr uint32_t _OP_DECORATE = 71;
+	static constexpr uint32_t _DECORATION_SPEC_ID = 1;
 };
 
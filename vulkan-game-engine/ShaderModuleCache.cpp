@@ -0,0 +1,118 @@
+#include "ShaderModuleCache.h"
+
+#include <stdexcept>
+
+/*
+* PUBLIC STATIC METHOD DEFINITIONS
+*/
+
+uint64_t ShaderModuleCache::content_hash(const uint32_t* pCode, size_t codeSize)
+{
+	// FNV-1a over whole words, SPIR-V is always a multiple of 4 bytes
+	uint64_t hash = 14695981039346656037ull;
+	for (size_t i = 0; i < codeSize / sizeof(uint32_t); ++i)
+	{
+		hash ^= pCode[i];
+		hash *= 1099511628211ull;
+	}
+
+	return hash ^ codeSize;
+}
+
+
+
+
+
+/*
+* CTORS
+*/
+
+ShaderModuleCache::ShaderModuleCache(VkDevice device)
+	: _deviceHandle(device),
+	_modules(),
+	_stats({})
+{
+}
+
+
+
+
+
+/*
+* PUBLIC METHOD DEFINITIONS
+*/
+
+ShaderModuleCache::Module ShaderModuleCache::acquire(const uint32_t* pCode, size_t codeSize)
+{
+	auto hash = content_hash(pCode, codeSize);
+	auto checkDigest = _check_digest(pCode, codeSize);
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	auto it = _modules.find(hash);
+	if (it != _modules.end() && it->second.codeSize == codeSize && it->second.checkDigest == checkDigest)
+	{
+		if (auto module = it->second.module.lock())
+		{
+			_stats.modulesReused++;
+			return module;
+		}
+	}
+
+	VkShaderModuleCreateInfo createInfo{};
+	createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+	createInfo.codeSize = codeSize;
+	createInfo.pCode = pCode;
+
+	VkShaderModule handle = VK_NULL_HANDLE;
+	if (vkCreateShaderModule(_deviceHandle, &createInfo, nullptr, &handle) != VK_SUCCESS)
+	{
+		throw std::runtime_error("Failed to create shader module");
+	}
+
+	VkDevice device = _deviceHandle;
+	Module module(new VkShaderModule(handle), [device](const VkShaderModule* pModule) {
+		vkDestroyShaderModule(device, *pModule, nullptr);
+		delete pModule;
+	});
+
+	_modules[hash] = { codeSize, checkDigest, module };
+	_stats.modulesCreated++;
+
+	return module;
+}
+
+
+
+
+
+/*
+* PUBLIC CONST METHOD DEFINITIONS
+*/
+
+ShaderModuleCache::Stats ShaderModuleCache::stats() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _stats;
+}
+
+
+
+
+
+/*
+* PRIVATE STATIC METHOD DEFINITIONS
+*/
+
+uint64_t ShaderModuleCache::_check_digest(const uint32_t* pCode, size_t codeSize)
+{
+	// Multiply-rotate over word positions and values, unrelated to the FNV key so their collisions don't coincide
+	uint64_t digest = 0x9E3779B97F4A7C15ull ^ codeSize;
+	for (size_t i = 0; i < codeSize / sizeof(uint32_t); ++i)
+	{
+		digest += ((static_cast<uint64_t>(pCode[i]) << 32) | i) * 0xC2B2AE3D27D4EB4Full;
+		digest = ((digest << 31) | (digest >> 33)) * 0x165667B19E3779F9ull;
+	}
+
+	return digest;
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+/*
+* Class that creates shader modules once per distinct SPIR-V binary
+*
+* Modules are keyed by a hash of their code, so shaders loaded for several pipelines or windows share one module.
+* The cache only holds weak references: a module is destroyed when the last shader using it goes away, and is
+* created again if the same code is loaded after that.
+*/
+class ShaderModuleCache
+{
+public:
+
+	/*
+	* TYPEDEFS
+	*/
+
+	/* Shared handle to a module, destroying the module with its last reference
+	*/
+	using Module = std::shared_ptr<const VkShaderModule>;
+
+
+
+	/*
+	* PUBLIC STRUCTS
+	*/
+
+	/* Counters for every module requested from the cache
+	*/
+	struct Stats
+	{
+		uint32_t modulesCreated;
+		uint32_t modulesReused;
+	};
+
+
+
+	/*
+	* PUBLIC STATIC METHODS
+	*/
+
+	/* @brief Returns a hash of SPIR-V code that is the same across runs and platforms
+	*
+	* @param codeSize Size of the code in bytes, a multiple of 4
+	*/
+	static uint64_t content_hash(const uint32_t* pCode, size_t codeSize);
+
+
+
+	/*
+	* DELETED METHODS
+	*/
+
+	ShaderModuleCache(const ShaderModuleCache&) = delete;
+	ShaderModuleCache& operator=(const ShaderModuleCache&) = delete;
+
+
+
+	/*
+	* CTORS
+	*/
+
+	/*
+	* @param device Logical device the modules are created on. Modules must be released before it is destroyed
+	*/
+	ShaderModuleCache(VkDevice device);
+
+
+
+	/*
+	* PUBLIC METHODS
+	*/
+
+	/* @brief Returns the module for a SPIR-V binary, creating it only if no live module has the same code
+	*
+	* The code isn't kept, so it can be freed as soon as this returns
+	*
+	* @param pCode SPIR-V words, 4-byte aligned
+	* @param codeSize Size of the code in bytes
+	* @throws std::runtime_error if the module can't be created
+	*/
+	Module acquire(const uint32_t* pCode, size_t codeSize);
+
+
+
+	/*
+	* PUBLIC CONST METHODS
+	*/
+
+	/* @brief Returns a copy of the creation counters
+	*/
+	Stats stats() const;
+
+private:
+
+	/*
+	* PRIVATE STRUCTS
+	*/
+
+	/* A module created by the cache. A hit also has to match the size and a second digest computed independently of
+	* the key, so different code is only shared if both 64-bit hashes collide at once
+	*/
+	struct _Entry
+	{
+		size_t codeSize;
+		uint64_t checkDigest;
+		std::weak_ptr<const VkShaderModule> module;
+	};
+
+
+
+	/*
+	* PRIVATE MEMBERS
+	*/
+
+	VkDevice _deviceHandle;
+
+	/* Modules keyed by the content hash of their code
+	*/
+	std::unordered_map<uint64_t, _Entry> _modules;
+
+	Stats _stats;
+
+	/* Guards the modules and counters, shaders are loaded from several threads
+	*/
+	mutable std::mutex _mutex;
+
+
+
+	/*
+	* PRIVATE STATIC METHODS
+	*/
+
+	/* @brief Returns a digest of SPIR-V code that is independent of `content_hash`, used to confirm a cache hit
+	*/
+	static uint64_t _check_digest(const uint32_t* pCode, size_t codeSize);
+};
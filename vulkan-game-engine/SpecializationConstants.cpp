@@ -0,0 +1,69 @@
+#include "SpecializationConstants.h"
+
+#include <cstring>
+
+/*
+* PUBLIC METHOD DEFINITIONS
+*/
+
+void SpecializationConstants::set(uint32_t constantId, bool value)
+{
+	_values[constantId] = value ? VK_TRUE : VK_FALSE;
+}
+
+void SpecializationConstants::set(uint32_t constantId, int32_t value)
+{
+	_values[constantId] = static_cast<uint32_t>(value);
+}
+
+void SpecializationConstants::set(uint32_t constantId, uint32_t value)
+{
+	_values[constantId] = value;
+}
+
+void SpecializationConstants::set(uint32_t constantId, float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	_values[constantId] = bits;
+}
+
+
+
+
+
+/*
+* PUBLIC CONST METHOD DEFINITIONS
+*/
+
+SpecializationConstants SpecializationConstants::merged_with(const SpecializationConstants& overrides) const
+{
+	SpecializationConstants merged = *this;
+	for (const auto& [constantId, value] : overrides._values)
+	{
+		merged._values[constantId] = value;
+	}
+
+	return merged;
+}
+
+void SpecializationConstants::configure_info(VkSpecializationInfo* pInfo, std::vector<VkSpecializationMapEntry>& entries, std::vector<uint32_t>& data) const
+{
+	entries.clear();
+	data.clear();
+	for (const auto& [constantId, value] : _values)
+	{
+		VkSpecializationMapEntry entry{};
+		entry.constantID = constantId;
+		entry.offset = static_cast<uint32_t>(data.size() * sizeof(uint32_t));
+		entry.size = sizeof(uint32_t);
+		entries.push_back(entry);
+		data.push_back(value);
+	}
+
+	memset(pInfo, 0, sizeof(VkSpecializationInfo));
+	pInfo->mapEntryCount = static_cast<uint32_t>(entries.size());
+	pInfo->pMapEntries = entries.data();
+	pInfo->dataSize = data.size() * sizeof(uint32_t);
+	pInfo->pData = data.data();
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+/*
+* Class holding specialization constant values by constant ID
+*
+* Every value is stored as a 32-bit word, which covers the bool, int, uint and float constants GLSL allows.
+* Values are kept sorted by ID so equal sets always produce the same create info and hash. IDs a shader
+* doesn't declare are ignored by the driver, so one set can be applied to every stage of a pipeline.
+*/
+class SpecializationConstants
+{
+public:
+
+	/*
+	* PUBLIC METHODS
+	*/
+
+	/* @brief Sets a bool constant, stored as a VkBool32
+	*/
+	void set(uint32_t constantId, bool value);
+
+	void set(uint32_t constantId, int32_t value);
+
+	void set(uint32_t constantId, uint32_t value);
+
+	void set(uint32_t constantId, float value);
+
+
+
+	/*
+	* PUBLIC CONST METHODS
+	*/
+
+	/* @brief Returns a copy of these constants with every value in `overrides` replacing or adding to them
+	*/
+	SpecializationConstants merged_with(const SpecializationConstants& overrides) const;
+
+	/* @brief Fills the map entries and data of a specialization info. The info points into both vectors
+	*
+	* @param[out] pInfo The struct to fill
+	* @param[out] entries One entry per constant
+	* @param[out] data One word per constant
+	*/
+	void configure_info(VkSpecializationInfo* pInfo, std::vector<VkSpecializationMapEntry>& entries, std::vector<uint32_t>& data) const;
+
+	/* @brief Returns the stored words by constant ID
+	*/
+	inline const std::map<uint32_t, uint32_t>& values() const { return _values; }
+
+	inline bool empty() const { return _values.empty(); }
+
+	bool operator==(const SpecializationConstants& other) const = default;
+
+private:
+
+	/*
+	* PRIVATE MEMBERS
+	*/
+
+	/* Raw 32-bit value of each constant by ID
+	*/
+	std::map<uint32_t, uint32_t> _values;
+};
@@ -1,34 +1,105 @@
 #include "Texture.h"
 
+#include <stdexcept>
+
+#include "BCEncoder.h"
+
+VkFormat Texture::select_format(PNGImage& image, ColorSpace colorSpace, const Device& device)
+{
+    bool isSrgb = colorSpace == ColorSpace::SRGB;
+    VkFormat format = isSrgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+    if (image.source_channels() == 1)
+    {
+        format = isSrgb ? VK_FORMAT_R8_SRGB : VK_FORMAT_R8_UNORM;
+    }
+    else if (image.source_channels() == 2)
+    {
+        format = isSrgb ? VK_FORMAT_R8G8_SRGB : VK_FORMAT_R8G8_UNORM;
+    }
+
+    // The sRGB variants of the small formats are optional in Vulkan
+    if (!device.supports_format(format, VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT))
+    {
+        format = isSrgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+    }
+
+    bool isRgba = format == VK_FORMAT_R8G8B8A8_SRGB || format == VK_FORMAT_R8G8B8A8_UNORM;
+    image.set_output_channels(isRgba ? 4 : image.source_channels());
+    return format;
+}
+
+const char* Texture::format_name(VkFormat format)
+{
+    switch (format)
+    {
+    case VK_FORMAT_R8_UNORM: return "R8 UNORM";
+    case VK_FORMAT_R8_SRGB: return "R8 SRGB";
+    case VK_FORMAT_R8G8_UNORM: return "R8G8 UNORM";
+    case VK_FORMAT_R8G8_SRGB: return "R8G8 SRGB";
+    case VK_FORMAT_R8G8B8A8_UNORM: return "R8G8B8A8 UNORM";
+    case VK_FORMAT_R8G8B8A8_SRGB: return "R8G8B8A8 SRGB";
+    case VK_FORMAT_BC1_RGB_UNORM_BLOCK: return "BC1 UNORM";
+    case VK_FORMAT_BC1_RGB_SRGB_BLOCK: return "BC1 SRGB";
+    case VK_FORMAT_BC3_UNORM_BLOCK: return "BC3 UNORM";
+    case VK_FORMAT_BC3_SRGB_BLOCK: return "BC3 SRGB";
+    case VK_FORMAT_BC5_UNORM_BLOCK: return "BC5 UNORM";
+    case VK_FORMAT_BC7_UNORM_BLOCK: return "BC7 UNORM";
+    case VK_FORMAT_BC7_SRGB_BLOCK: return "BC7 SRGB";
+    default: return "other";
+    }
+}
+
 Texture::Texture()
     : Image()
 {
 }
 
-Texture::Texture(PNGImage& texture, Device& device, CommandPool& cmdPool)
+Texture::Texture(PNGImage& texture, Device& device, UploadBatch& uploads, ColorSpace colorSpace)
+    : Texture(texture.width(), texture.height(), select_format(texture, colorSpace, device), device)
+{
+    // Pixels are decoded straight into the staging buffer instead of passing through host memory first
+    texture.decode(uploads.stage_image(*this, texture.size_in_bytes()));
+}
+
+Texture::Texture(const KTX2Image& texture, Device& device, UploadBatch& uploads)
     : Image(device, {
         texture.width(),
         texture.height(),
-        _IMAGE_FORMAT,
+        _sampled_format(texture, device),
         VK_IMAGE_TILING_OPTIMAL,
         VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-        VK_IMAGE_ASPECT_COLOR_BIT
+        VK_IMAGE_ASPECT_COLOR_BIT,
+        texture.level_count()
         })
 {
-    
-    size_t imageSize = _props.width * _props.height * sizeof(PNGImage::pixel_bits_t);
-    Buffer stagingBuffer(device, Buffer::Type::STAGING, imageSize);
-    stagingBuffer.copy_to_mapped_mem(texture.data());
-
-    const auto& queueFamilyInfo = device.queue_family_info();
-    auto graphicsQueue = queueFamilyInfo.get_queue_handle(QueueFamilyType::Graphics);
-    _record_image_layout_transition(VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, cmdPool, graphicsQueue);
-    _record_copy_image_to_buffer(stagingBuffer.handle(), cmdPool, graphicsQueue);
-    _record_image_layout_transition(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, cmdPool, graphicsQueue);
+    std::vector<const void*> levelData;
+    std::vector<VkDeviceSize> levelSizes;
+    for (uint32_t level = 0; level < texture.level_count(); ++level)
+    {
+        levelData.push_back(texture.level_data(level));
+        levelSizes.push_back(texture.level_size(level));
+    }
+
+    uploads.upload_image_levels(*this, levelData, levelSizes);
 }
 
-Texture::Texture(const Texture& other)
-    : Image(other)
+Texture::Texture(uint32_t width, uint32_t height, Device& device)
+    : Texture(width, height, _IMAGE_FORMAT, device)
+{
+}
+
+Texture::Texture(uint32_t width, uint32_t height, VkFormat format, Device& device)
+    : Image(device, {
+        width,
+        height,
+        format,
+        VK_IMAGE_TILING_OPTIMAL,
+        // Mip levels are blitted from each other, so the image is also a transfer source
+        VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        VK_IMAGE_ASPECT_COLOR_BIT,
+        full_mip_chain_length(width, height),
+        _gray_swizzle(format)
+        })
 {
 }
 
@@ -47,94 +118,67 @@ Texture::~Texture()
 {
 }
 
-void Texture::_record_image_layout_transition(VkImageLayout oldLayout, VkImageLayout newLayout, const CommandPool& commandPool, VkQueue graphicsQueue)
+size_t Texture::size_in_bytes() const
 {
-    VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-    CommandBufferPool commandBuffer(_deviceHandle, 1, commandPool.handle());
-    commandBuffer.begin_all(beginInfo);
-    VkCommandBuffer cmdBufHandle = commandBuffer[0];
-
-    VkImageMemoryBarrier barrier{};
-    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.oldLayout = oldLayout;
-    barrier.newLayout = newLayout;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.image = _handle;
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = 1;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
-
-    VkPipelineStageFlags sourceStage;
-    VkPipelineStageFlags destinationStage;
-
-    if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+    size_t total = 0;
+    for (uint32_t level = 0; level < _props.mipLevels; ++level)
     {
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-        sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        total += _level_size(_props.format, std::max(1u, _props.width >> level), std::max(1u, _props.height >> level));
     }
-    else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
-    {
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    return total;
+}
 
-        sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-        destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+size_t Texture::rgba_size_in_bytes() const
+{
+    size_t total = 0;
+    for (uint32_t level = 0; level < _props.mipLevels; ++level)
+    {
+        total += _level_size(VK_FORMAT_R8G8B8A8_UNORM, std::max(1u, _props.width >> level), std::max(1u, _props.height >> level));
     }
-    else
+    return total;
+}
+
+VkFormat Texture::_sampled_format(const KTX2Image& texture, const Device& device)
+{
+    if (!device.supports_format(texture.format(), VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT))
     {
-        throw std::invalid_argument("Image layout transition is unsupported");
+        throw std::runtime_error("Device can't sample the format of the KTX2 texture");
     }
+    return texture.format();
+}
 
-    vkCmdPipelineBarrier(
-        cmdBufHandle,
-        sourceStage, destinationStage,
-        0,
-        0, nullptr,
-        0, nullptr,
-        1, &barrier
-    );
-
-    commandBuffer.end_all();
-    commandBuffer.submit_all_to_queue(graphicsQueue);
+VkComponentMapping Texture::_gray_swizzle(VkFormat format)
+{
+    switch (format)
+    {
+    case VK_FORMAT_R8_UNORM:
+    case VK_FORMAT_R8_SRGB:
+        return { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_ONE };
+    case VK_FORMAT_R8G8_UNORM:
+    case VK_FORMAT_R8G8_SRGB:
+        return { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G };
+    default:
+        return {};
+    }
 }
 
-void Texture::_record_copy_image_to_buffer(VkBuffer stagingBuffer, const CommandPool& commandPool, VkQueue graphicsQueue)
+size_t Texture::_level_size(VkFormat format, uint32_t width, uint32_t height)
 {
-    VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-    CommandBufferPool commandBuffer(_deviceHandle, 1, commandPool.handle());
-    commandBuffer.begin_all(beginInfo);
-    VkCommandBuffer cmdBufHandle = commandBuffer[0];
-
-
-    VkBufferImageCopy region{};
-    region.bufferOffset = 0;
-    region.bufferRowLength = 0;
-    region.bufferImageHeight = 0;
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.mipLevel = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount = 1;
-    region.imageOffset = { 0, 0, 0 };
-    region.imageExtent = {
-        _props.width,
-        _props.height,
-        1
-    };
-
-    vkCmdCopyBufferToImage(cmdBufHandle, stagingBuffer, _handle, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-    commandBuffer.end_all();
-    commandBuffer.submit_all_to_queue(graphicsQueue);
+    if (BCEncoder::block_size(format) > 0)
+    {
+        return BCEncoder::encoded_size(format, width, height);
+    }
+
+    size_t texels = static_cast<size_t>(width) * height;
+    switch (format)
+    {
+    case VK_FORMAT_R8_UNORM:
+    case VK_FORMAT_R8_SRGB:
+        return texels;
+    case VK_FORMAT_R8G8_UNORM:
+    case VK_FORMAT_R8G8_SRGB:
+        return texels * 2;
+    default:
+        return texels * 4;
+    }
 }
\ No newline at end of file
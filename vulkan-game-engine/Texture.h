@@ -8,25 +8,75 @@
 #include "Device.h"
 #include "Buffer.h"
 #include "PNGImage.h"
-#include "CommandPool.h"
+#include "KTX2Image.h"
 #include "Image.h"
+#include "UploadBatch.h"
 
 class Texture : public Image
 {
 public:
 
+	/* How color channels are encoded. Alpha is always linear
+	*/
+	enum class ColorSpace
+	{
+		SRGB,
+		LINEAR
+	};
+
+	/* @brief Picks the smallest format that holds a PNG's channels, R8, R8G8 or R8G8B8A8, and sets the image to decode to it
+	*
+	* Gray formats are swizzled back to RGBA by the texture's view, so shaders read the same values as from an expanded image.
+	* Falls back to R8G8B8A8 when the device can't sample and filter the smaller format
+	*/
+	static VkFormat select_format(PNGImage& image, ColorSpace colorSpace, const Device& device);
+
+	/* @brief Returns a short name for the formats textures are created with, such as "R8 SRGB" or "BC7 SRGB"
+	*/
+	static const char* format_name(VkFormat format);
+
 	Texture();
-	Texture(PNGImage& texture, Device& device, CommandPool& cmdPool);
-	Texture(const Texture& other);
+	/* Decodes the image into staging memory of the upload batch, keeping gray layouts, see select_format
+	*/
+	Texture(PNGImage& texture, Device& device, UploadBatch& uploads, ColorSpace colorSpace = ColorSpace::SRGB);
+	/* Uploads every mip level stored in the container as is, without decoding or generating any
+	*
+	* @throws std::runtime_error if the device can't sample the container's format
+	*/
+	Texture(const KTX2Image& texture, Device& device, UploadBatch& uploads);
+	/* Creates an empty RGBA texture with a full mip chain. Its pixels still have to be staged, see UploadBatch::stage_image
+	*/
+	Texture(uint32_t width, uint32_t height, Device& device);
+	/* Creates an empty texture of an 8-bit R, RG or RGBA format with a full mip chain
+	*/
+	Texture(uint32_t width, uint32_t height, VkFormat format, Device& device);
+	Texture(const Texture&) = delete;
 	Texture(Texture&& other) noexcept;
 	Texture& operator=(Texture other);
 	~Texture();
 
+	/* @brief Returns the device memory taken by every mip level's texels
+	*/
+	size_t size_in_bytes() const;
+
+	/* @brief Returns the memory the same mip chain would take as uncompressed R8G8B8A8
+	*/
+	size_t rgba_size_in_bytes() const;
+
 private:
 
 	static constexpr VkFormat _IMAGE_FORMAT = VK_FORMAT_R8G8B8A8_SRGB;
 
-	void _record_image_layout_transition(VkImageLayout oldLayout, VkImageLayout newLayout, const CommandPool& commandPool, VkQueue graphicsQueue);
-	void _record_copy_image_to_buffer(VkBuffer stagingBuffer, const CommandPool& commandPool, VkQueue graphicsQueue);
+	/* @brief Returns the container's format, throwing if the device can't sample it
+	*/
+	static VkFormat _sampled_format(const KTX2Image& texture, const Device& device);
+
+	/* @brief Returns the view swizzle that makes a gray format read like RGBA
+	*/
+	static VkComponentMapping _gray_swizzle(VkFormat format);
+
+	/* @brief Returns the size of one mip level of the given format in bytes
+	*/
+	static size_t _level_size(VkFormat format, uint32_t width, uint32_t height);
 
 };
\ No newline at end of file
@@ -5,11 +5,11 @@ TextureSampler::TextureSampler()
 {
 }
 
-TextureSampler::TextureSampler(const Device& device)
+TextureSampler::TextureSampler(const Device& device, uint32_t mipLevels)
 	: VulkanObject(device.handle())
 {
 	VkSamplerCreateInfo samplerInfo{};
-	_configure_sampler(&samplerInfo, device.physical_properties());
+	_configure_sampler(&samplerInfo, device.physical_properties(), mipLevels);
 
 	if (vkCreateSampler(_deviceHandle, &samplerInfo, nullptr, &_handle) != VK_SUCCESS)
 	{
@@ -42,7 +42,7 @@ TextureSampler::~TextureSampler()
 	}
 }
 
-void TextureSampler::_configure_sampler(VkSamplerCreateInfo* pCreateInfo, VkPhysicalDeviceProperties deviceProps)
+void TextureSampler::_configure_sampler(VkSamplerCreateInfo* pCreateInfo, VkPhysicalDeviceProperties deviceProps, uint32_t mipLevels)
 {
 	memset(pCreateInfo, 0, sizeof(VkSamplerCreateInfo));
 	pCreateInfo->sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
@@ -58,4 +58,7 @@ void TextureSampler::_configure_sampler(VkSamplerCreateInfo* pCreateInfo, VkPhys
 	pCreateInfo->compareEnable = VK_FALSE;
 	pCreateInfo->compareOp = VK_COMPARE_OP_ALWAYS;
 	pCreateInfo->mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+	pCreateInfo->mipLodBias = 0.0f;
+	pCreateInfo->minLod = 0.0f;
+	pCreateInfo->maxLod = static_cast<float>(mipLevels - 1);
 }
\ No newline at end of file
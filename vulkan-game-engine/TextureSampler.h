@@ -19,13 +19,16 @@ public:
 	}
 
 	TextureSampler();
-	TextureSampler(const Device& device);
+	/*
+	* @param mipLevels Number of mip levels of the textures sampled, the sampler's maxLod is set to reach the last one
+	*/
+	TextureSampler(const Device& device, uint32_t mipLevels = 1);
 	TextureSampler(const TextureSampler& other);
 	TextureSampler(TextureSampler&& other) noexcept;
 	TextureSampler& operator=(TextureSampler other);
 	~TextureSampler();
 
 private:	
-	void _configure_sampler(VkSamplerCreateInfo* pCreateInfo, VkPhysicalDeviceProperties deviceProps);
+	void _configure_sampler(VkSamplerCreateInfo* pCreateInfo, VkPhysicalDeviceProperties deviceProps, uint32_t mipLevels);
 };
 
@@ -0,0 +1,68 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+/*
+* CTORS
+*/
+
+ThreadPool::ThreadPool(unsigned numThreads)
+	: _workers(),
+	_tasks(),
+	_isStopping(false)
+{
+	if (numThreads == 0)
+	{
+		numThreads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	_workers.reserve(numThreads);
+	for (unsigned i = 0; i < numThreads; ++i)
+	{
+		_workers.emplace_back(&ThreadPool::_work, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_isStopping = true;
+	}
+	_taskAvailable.notify_all();
+
+	for (auto& worker : _workers)
+	{
+		worker.join();
+	}
+}
+
+
+
+
+
+/*
+* PRIVATE METHOD DEFINITIONS
+*/
+
+void ThreadPool::_work()
+{
+	while (true)
+	{
+		std::function<void()> task;
+
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_taskAvailable.wait(lock, [this]() { return _isStopping || !_tasks.empty(); });
+			if (_tasks.empty())
+			{
+				return;
+			}
+
+			task = std::move(_tasks.front());
+			_tasks.pop();
+		}
+
+		task();
+	}
+}
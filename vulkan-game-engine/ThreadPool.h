@@ -0,0 +1,113 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/*
+* Class that runs tasks on a fixed set of worker threads
+*
+* Tasks are taken in submission order. Each submit returns a future, so exceptions thrown by a task surface
+* wherever its result is collected. Destroying the pool finishes every queued task before joining the workers.
+*/
+class ThreadPool
+{
+public:
+
+	/*
+	* DELETED METHODS
+	*/
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+
+
+	/*
+	* CTORS
+	*/
+
+	/*
+	* @param numThreads Number of workers, or 0 for one per hardware thread
+	*/
+	ThreadPool(unsigned numThreads = 0);
+	~ThreadPool();
+
+
+
+	/*
+	* PUBLIC METHODS
+	*/
+
+	/* @brief Queues a callable and returns a future for its result
+	*/
+	template<typename F>
+	std::future<std::invoke_result_t<F>> submit(F&& task)
+	{
+		using Result = std::invoke_result_t<F>;
+
+		// packaged_task is move-only and std::function needs a copyable target, so the queue holds it by shared pointer
+		auto pTask = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+		auto future = pTask->get_future();
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_tasks.push([pTask]() { (*pTask)(); });
+		}
+		_taskAvailable.notify_one();
+
+		return future;
+	}
+
+
+
+	/*
+	* PUBLIC CONST METHODS
+	*/
+
+	/* @brief Returns the number of worker threads
+	*/
+	inline size_t size() const { return _workers.size(); }
+
+private:
+
+	/*
+	* PRIVATE MEMBERS
+	*/
+
+	/* Worker threads, each running `_work()`
+	*/
+	std::vector<std::thread> _workers;
+
+	/* Tasks waiting for a worker
+	*/
+	std::queue<std::function<void()>> _tasks;
+
+	/* Guards the task queue and the stop flag
+	*/
+	std::mutex _mutex;
+
+	/* Signaled when a task is queued or the pool stops
+	*/
+	std::condition_variable _taskAvailable;
+
+	/* Set once the pool is being destroyed
+	*/
+	bool _isStopping;
+
+
+
+	/*
+	* PRIVATE METHODS
+	*/
+
+	/* @brief Runs queued tasks until the pool stops and the queue is empty
+	*/
+	void _work();
+};
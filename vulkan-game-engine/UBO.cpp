@@ -3,14 +3,16 @@
 UBO::UBO()
 	: _model({}),
 	_view({}),
-	_projection({})
+	_projection({}),
+	_texCoordDecode(0.0f, 0.0f, 1.0f, 1.0f)
 {
 }
 
-UBO::UBO(const model_mat_t& model, const view_mat_t& view, const proj_mat_t& projection)
+UBO::UBO(const model_mat_t& model, const view_mat_t& view, const proj_mat_t& projection, const glm::vec4& texCoordDecode)
 	: _model(model),
 	_view(view),
-	_projection(projection)
+	_projection(projection),
+	_texCoordDecode(texCoordDecode)
 {
 
 }
@@ -11,7 +11,10 @@ public:
 	using proj_mat_t = glm::mat4;
 
 	UBO();
-	UBO(const model_mat_t& model, const view_mat_t& view, const proj_mat_t& projection);
+	/*
+	* @param texCoordDecode Offset in xy and scale in zw for quantized texture coordinates. Ignored by the full vertex shader
+	*/
+	UBO(const model_mat_t& model, const view_mat_t& view, const proj_mat_t& projection, const glm::vec4& texCoordDecode = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
 	~UBO();
 
 	void update(const model_mat_t& model, const view_mat_t& view, const proj_mat_t& projection);
@@ -22,4 +25,5 @@ private:
 	alignas(16) model_mat_t _model;
 	alignas(16) view_mat_t _view;
 	alignas(16) proj_mat_t _projection;
+	alignas(16) glm::vec4 _texCoordDecode;
 };
\ No newline at end of file
@@ -0,0 +1,308 @@
+#include "UploadBatch.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "PixelKernels.h"
+
+/*
+* CTORS
+*/
+
+UploadBatch::UploadBatch(const Device& device)
+	: _device(device),
+	_cmdPool(VK_NULL_HANDLE),
+	_cmdBuffer(VK_NULL_HANDLE),
+	_fence(VK_NULL_HANDLE),
+	_stagingBuffers({}),
+	_pendingMipChains({}),
+	_uploadCount(0),
+	_isSubmitted(false)
+{
+	auto deviceHandle = _device.handle();
+
+	VkCommandPoolCreateInfo poolInfo{};
+	_configure_command_pool(&poolInfo, _device.queue_family_info()[QueueFamilyType::Graphics]);
+	if (vkCreateCommandPool(deviceHandle, &poolInfo, nullptr, &_cmdPool) != VK_SUCCESS)
+	{
+		throw std::runtime_error("Failed to create upload command pool");
+	}
+
+	VkCommandBufferAllocateInfo allocInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocInfo.commandPool = _cmdPool;
+	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocInfo.commandBufferCount = 1;
+	if (vkAllocateCommandBuffers(deviceHandle, &allocInfo, &_cmdBuffer) != VK_SUCCESS)
+	{
+		throw std::runtime_error("Failed to allocate upload command buffer");
+	}
+
+	VkFenceCreateInfo fenceInfo{};
+	fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+	if (vkCreateFence(deviceHandle, &fenceInfo, nullptr, &_fence) != VK_SUCCESS)
+	{
+		throw std::runtime_error("Failed to create upload fence");
+	}
+
+	VkCommandBufferBeginInfo beginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	vkBeginCommandBuffer(_cmdBuffer, &beginInfo);
+}
+
+UploadBatch::~UploadBatch()
+{
+	if (_isSubmitted)
+	{
+		wait();
+	}
+
+	_release();
+	vkDestroyFence(_device.handle(), _fence, nullptr);
+}
+
+
+
+
+
+/*
+* PUBLIC METHOD DEFINITIONS
+*/
+
+void UploadBatch::upload_buffer(Buffer& destBuf, const void* data, VkDeviceSize dataSize)
+{
+	_check_recording();
+
+	auto& stagingBuffer = _stage(data, dataSize);
+	stagingBuffer.record_copy_to(_cmdBuffer, destBuf);
+	_uploadCount++;
+}
+
+void UploadBatch::upload_image(Image& destImage, const void* data, VkDeviceSize dataSize)
+{
+	_check_recording();
+
+	memcpy(_stage_image(destImage, dataSize), data, static_cast<size_t>(dataSize));
+}
+
+void* UploadBatch::stage_image(Image& destImage, VkDeviceSize dataSize)
+{
+	_check_recording();
+
+	// The copy only executes once the batch is submitted, so the caller can still fill the memory
+	return _stage_image(destImage, dataSize);
+}
+
+void UploadBatch::upload_image_levels(Image& destImage, const std::vector<const void*>& levelData, const std::vector<VkDeviceSize>& levelSizes)
+{
+	_check_recording();
+
+	if (levelData.size() != levelSizes.size() || levelData.size() != destImage.mip_levels())
+	{
+		throw std::invalid_argument("Every mip level of the image needs exactly one payload");
+	}
+
+	// Compressed levels have to start on a block boundary, 16 bytes covers every block size
+	constexpr VkDeviceSize LEVEL_ALIGNMENT = 16;
+	std::vector<VkDeviceSize> levelOffsets;
+	VkDeviceSize bufferSize = 0;
+	for (auto levelSize : levelSizes)
+	{
+		levelOffsets.push_back(bufferSize);
+		bufferSize += (levelSize + LEVEL_ALIGNMENT - 1) / LEVEL_ALIGNMENT * LEVEL_ALIGNMENT;
+	}
+
+	_stagingBuffers.push_back(Buffer(_device, Buffer::Type::STAGING, static_cast<size_t>(bufferSize)));
+	auto& stagingBuffer = _stagingBuffers.back();
+
+	void* pData = nullptr;
+	stagingBuffer.map_memory(&pData);
+
+	destImage.record_layout_transition(_cmdBuffer, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+	for (uint32_t level = 0; level < levelData.size(); ++level)
+	{
+		memcpy(static_cast<uint8_t*>(pData) + levelOffsets[level], levelData[level], static_cast<size_t>(levelSizes[level]));
+		destImage.record_copy_from_buffer(_cmdBuffer, stagingBuffer.handle(), level, levelOffsets[level]);
+	}
+	destImage.record_layout_transition(_cmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+	_uploadCount++;
+}
+
+void UploadBatch::submit()
+{
+	_check_recording();
+	_generate_pending_mip_chains();
+	vkEndCommandBuffer(_cmdBuffer);
+
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &_cmdBuffer;
+
+	auto graphicsQueue = _device.queue_family_info().get_queue_handle(QueueFamilyType::Graphics);
+	if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, _fence) != VK_SUCCESS)
+	{
+		throw std::runtime_error("Failed to submit upload batch");
+	}
+
+	_isSubmitted = true;
+}
+
+bool UploadBatch::is_complete()
+{
+	if (!_isSubmitted)
+	{
+		return false;
+	}
+
+	if (vkGetFenceStatus(_device.handle(), _fence) != VK_SUCCESS)
+	{
+		return false;
+	}
+
+	_release();
+	return true;
+}
+
+void UploadBatch::wait()
+{
+	if (!_isSubmitted)
+	{
+		throw std::logic_error("Upload batch must be submitted before waiting on it");
+	}
+
+	vkWaitForFences(_device.handle(), 1, &_fence, VK_TRUE, UINT64_MAX);
+	_release();
+}
+
+
+
+
+
+/*
+* PRIVATE METHOD DEFINITIONS
+*/
+
+Buffer& UploadBatch::_stage(const void* data, VkDeviceSize dataSize)
+{
+	_stagingBuffers.push_back(Buffer(_device, Buffer::Type::STAGING, static_cast<size_t>(dataSize)));
+
+	auto& stagingBuffer = _stagingBuffers.back();
+	stagingBuffer.copy_to_mapped_mem(data);
+	return stagingBuffer;
+}
+
+void* UploadBatch::_stage_image(Image& destImage, VkDeviceSize dataSize)
+{
+	auto props = destImage.properties();
+	bool isBlittable = props.mipLevels == 1 || destImage.supports_linear_blit();
+
+	// Without blits every level is copied from staging memory, so the buffer holds the whole chain
+	std::vector<VkDeviceSize> levelOffsets = { 0 };
+	VkDeviceSize bufferSize = dataSize;
+	VkDeviceSize texelSize = dataSize / (static_cast<VkDeviceSize>(props.width) * props.height);
+	if (!isBlittable)
+	{
+		if (texelSize != 1 && texelSize != 2 && texelSize != 4)
+		{
+			throw std::invalid_argument("Mip chains of formats the device cannot blit can only be generated for 8-bit R, RG and RGBA images");
+		}
+
+		// Copies out of a buffer have to start on a multiple of 4 bytes
+		for (uint32_t level = 1; level < props.mipLevels; ++level)
+		{
+			bufferSize = (bufferSize + 3) / 4 * 4;
+			levelOffsets.push_back(bufferSize);
+			bufferSize += static_cast<VkDeviceSize>(std::max(1u, props.width >> level)) * std::max(1u, props.height >> level) * texelSize;
+		}
+	}
+
+	_stagingBuffers.push_back(Buffer(_device, Buffer::Type::STAGING, static_cast<size_t>(bufferSize)));
+	auto& stagingBuffer = _stagingBuffers.back();
+
+	void* pData = nullptr;
+	stagingBuffer.map_memory(&pData);
+
+	destImage.record_layout_transition(_cmdBuffer, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+	for (uint32_t level = 0; level < levelOffsets.size(); ++level)
+	{
+		destImage.record_copy_from_buffer(_cmdBuffer, stagingBuffer.handle(), level, levelOffsets[level]);
+	}
+
+	if (props.mipLevels > 1 && isBlittable)
+	{
+		destImage.record_generate_mipmaps(_cmdBuffer);
+	}
+	else
+	{
+		destImage.record_layout_transition(_cmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	}
+
+	if (!isBlittable)
+	{
+		bool isSrgb = props.format == VK_FORMAT_R8_SRGB || props.format == VK_FORMAT_R8G8_SRGB || props.format == VK_FORMAT_R8G8B8A8_SRGB || props.format == VK_FORMAT_B8G8R8A8_SRGB;
+		_pendingMipChains.push_back({ static_cast<uint8_t*>(pData), levelOffsets, props.width, props.height, static_cast<uint32_t>(texelSize), isSrgb });
+	}
+
+	_uploadCount++;
+	return pData;
+}
+
+void UploadBatch::_generate_pending_mip_chains()
+{
+	for (const auto& chain : _pendingMipChains)
+	{
+		uint32_t width = chain.width;
+		uint32_t height = chain.height;
+		for (size_t level = 1; level < chain.levelOffsets.size(); ++level)
+		{
+			const uint8_t* pLevel = chain.pData + chain.levelOffsets[level - 1];
+			uint8_t* pNextLevel = chain.pData + chain.levelOffsets[level];
+			PixelKernels::downsample(pLevel, width, height, chain.numChannels, pNextLevel, chain.isSrgb);
+
+			width = std::max(1u, width / 2);
+			height = std::max(1u, height / 2);
+		}
+	}
+
+	_pendingMipChains.clear();
+}
+
+void UploadBatch::_check_recording() const
+{
+	if (_isSubmitted)
+	{
+		throw std::logic_error("Upload batch has already been submitted");
+	}
+}
+
+void UploadBatch::_release()
+{
+	_stagingBuffers.clear();
+
+	if (_cmdPool != VK_NULL_HANDLE)
+	{
+		// Destroying the pool frees the command buffer with it
+		vkDestroyCommandPool(_device.handle(), _cmdPool, nullptr);
+		_cmdPool = VK_NULL_HANDLE;
+		_cmdBuffer = VK_NULL_HANDLE;
+	}
+}
+
+
+
+
+
+/*
+* PRIVATE CONST METHOD DEFINITIONS
+*/
+
+void UploadBatch::_configure_command_pool(VkCommandPoolCreateInfo* pCreateInfo, uint32_t graphicsQueueFamilyIndex) const
+{
+	memset(pCreateInfo, 0, sizeof(VkCommandPoolCreateInfo));
+	pCreateInfo->sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	pCreateInfo->flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	pCreateInfo->queueFamilyIndex = graphicsQueueFamilyIndex;
+}
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+
+#include "Device.h"
+#include "Buffer.h"
+#include "Image.h"
+
+/*
+* Class that records the uploads of many assets into a single command buffer
+*
+* Every upload gets its own staging buffer. The batch is submitted once with a fence, and the staging
+* buffers are released as soon as the fence is seen signaled. A batch can only be submitted once.
+*
+* Images with more than one mip level get their chain generated in the same command buffer with blits. Formats
+* the device cannot blit have the chain downsampled in staging memory on submit and every level copied instead.
+*/
+class UploadBatch
+{
+public:
+
+	/*
+	* DELETED METHODS
+	*/
+
+	UploadBatch(const UploadBatch&) = delete;
+	UploadBatch& operator=(const UploadBatch&) = delete;
+
+
+
+	/*
+	* CTORS
+	*/
+
+	/*
+	* @param device Device the assets are uploaded to
+	*/
+	UploadBatch(const Device& device);
+
+	/* Waits for a submitted batch to finish before releasing it
+	*/
+	~UploadBatch();
+
+
+
+	/*
+	* PUBLIC METHODS
+	*/
+
+	/* @brief Records a copy of host data into a device local buffer
+	*
+	* @param destBuf Buffer to upload to
+	* @param data Host data, copied into a staging buffer immediately
+	* @param dataSize Size of the data in bytes
+	*/
+	void upload_buffer(Buffer& destBuf, const void* data, VkDeviceSize dataSize);
+
+	/* @brief Records a copy of host pixels into an image, fills its mip chain and leaves it ready for sampling
+	*
+	* @param destImage Image to upload to, expected to be in an undefined layout
+	* @param data Host pixels of mip level 0, copied into a staging buffer immediately
+	* @param dataSize Size of the pixel data in bytes
+	*/
+	void upload_image(Image& destImage, const void* data, VkDeviceSize dataSize);
+
+	/* @brief Records the upload of an image whose pixels the caller writes directly into staging memory
+	*
+	* @param destImage Image to upload to, expected to be in an undefined layout
+	* @param dataSize Size of the pixel data of mip level 0 in bytes
+	* @returns Mapped staging memory of `dataSize` bytes for mip level 0. It must be filled before the batch is submitted
+	*/
+	void* stage_image(Image& destImage, VkDeviceSize dataSize);
+
+	/* @brief Records a copy of every mip level of an image whose levels were prepared offline, such as block-compressed textures
+	*
+	* @param destImage Image to upload to, expected to be in an undefined layout with one mip level per entry
+	* @param levelData Host payload of each level, level 0 first, copied into a staging buffer immediately
+	* @param levelSizes Size of each level's payload in bytes
+	*/
+	void upload_image_levels(Image& destImage, const std::vector<const void*>& levelData, const std::vector<VkDeviceSize>& levelSizes);
+
+	/* @brief Submits every recorded upload to the graphics queue without waiting
+	*/
+	void submit();
+
+	/* @brief Checks if the submitted uploads have finished, releasing the staging buffers if they have
+	*/
+	bool is_complete();
+
+	/* @brief Blocks until the submitted uploads have finished and releases the staging buffers
+	*/
+	void wait();
+
+
+
+	/*
+	* PUBLIC CONST METHODS
+	*/
+
+	/* @brief Returns the number of uploads recorded so far
+	*/
+	inline size_t upload_count() const { return _uploadCount; }
+
+private:
+
+	/*
+	* PRIVATE STRUCTS
+	*/
+
+	/* Mip chain that has to be downsampled in staging memory before the batch is submitted
+	*/
+	struct _PendingMipChain
+	{
+		/* Mapped staging memory holding every level, level 0 first
+		*/
+		uint8_t* pData;
+
+		/* Offset of each level in the staging memory
+		*/
+		std::vector<VkDeviceSize> levelOffsets;
+
+		uint32_t width;
+		uint32_t height;
+		uint32_t numChannels;
+		bool isSrgb;
+	};
+
+
+
+	/*
+	* PRIVATE MEMBERS
+	*/
+
+	/* Device the assets are uploaded to
+	*/
+	const Device& _device;
+
+	/* Transient command pool the batch records from
+	*/
+	VkCommandPool _cmdPool;
+
+	/* Command buffer holding every upload
+	*/
+	VkCommandBuffer _cmdBuffer;
+
+	/* Fence signaled once the batch has executed
+	*/
+	VkFence _fence;
+
+	/* Staging buffers kept alive until the fence signals
+	*/
+	std::vector<Buffer> _stagingBuffers;
+
+	/* Mip chains the device cannot blit, generated on submit
+	*/
+	std::vector<_PendingMipChain> _pendingMipChains;
+
+	/* Number of uploads recorded
+	*/
+	size_t _uploadCount;
+
+	/* Whether the batch has been submitted
+	*/
+	bool _isSubmitted;
+
+
+
+	/*
+	* PRIVATE METHODS
+	*/
+
+	/* @brief Creates a staging buffer holding a copy of the given data
+	*/
+	Buffer& _stage(const void* data, VkDeviceSize dataSize);
+
+	/* @brief Creates a staging buffer for an image and records the copies and layout transitions that move it into the image
+	*
+	* @returns Mapped staging memory for mip level 0
+	*/
+	void* _stage_image(Image& destImage, VkDeviceSize dataSize);
+
+	/* @brief Downsamples every pending mip chain into the staging memory of its lower levels
+	*/
+	void _generate_pending_mip_chains();
+
+	/* @brief Throws if the batch can no longer be recorded to
+	*/
+	void _check_recording() const;
+
+	/* @brief Releases the staging buffers and command pool once the uploads are done
+	*/
+	void _release();
+
+
+
+	/*
+	* PRIVATE CONST METHODS
+	*/
+
+	/* @brief Fills struct with info necessary for creating a transient command pool
+	*/
+	void _configure_command_pool(VkCommandPoolCreateInfo* pCreateInfo, uint32_t graphicsQueueFamilyIndex) const;
+};
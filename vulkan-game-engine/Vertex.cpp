@@ -6,34 +6,17 @@
 
 VkVertexInputBindingDescription Vertex::getBindingDescription()
 {
-    VkVertexInputBindingDescription bindingDescription{};
-    bindingDescription.binding = 0;
-    bindingDescription.stride = sizeof(Vertex);
-    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-
-    return bindingDescription;
+    return Layout::BINDING;
 }
 
-std::array<VkVertexInputAttributeDescription, 3> Vertex::getAttributeDescriptions()
+std::array<VkVertexInputAttributeDescription, Vertex::Layout::ATTRIBUTE_COUNT> Vertex::getAttributeDescriptions()
 {
-    std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions{};
-
-    attributeDescriptions[0].binding = 0;
-    attributeDescriptions[0].location = 0;
-    attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
-    attributeDescriptions[0].offset = offsetof(Vertex, _pos);
-
-    attributeDescriptions[1].binding = 0;
-    attributeDescriptions[1].location = 1;
-    attributeDescriptions[1].format = VK_FORMAT_R32G32B32_SFLOAT;
-    attributeDescriptions[1].offset = offsetof(Vertex, _color);
-
-    attributeDescriptions[2].binding = 0;
-    attributeDescriptions[2].location = 2;
-    attributeDescriptions[2].format = VK_FORMAT_R32G32_SFLOAT;
-    attributeDescriptions[2].offset = offsetof(Vertex, _texCoord);
+    static_assert(sizeof(Vertex) == Layout::STRIDE, "Vertex members don't match its layout");
+    static_assert(offsetof(Vertex, _pos) == Layout::OFFSETS[0], "Vertex members don't match its layout");
+    static_assert(offsetof(Vertex, _color) == Layout::OFFSETS[1], "Vertex members don't match its layout");
+    static_assert(offsetof(Vertex, _texCoord) == Layout::OFFSETS[2], "Vertex members don't match its layout");
 
-    return attributeDescriptions;
+    return Layout::ATTRIBUTES;
 }
 
 
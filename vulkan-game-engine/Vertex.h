@@ -8,6 +8,8 @@
 
 #include <array>
 
+#include "VertexLayout.h"
+
 /*
 * Class describing a mesh vertex
 */
@@ -15,6 +17,10 @@ class Vertex
 {
 public:
 
+	/* Interleaved layout of the members, used for the vertex input state, hashing and equality
+	*/
+	using Layout = VertexLayout<PositionF32, ColorF32, TexCoordF32>;
+
 	/*
 	* CTORS / ASSIGNMENT
 	*/
@@ -32,9 +38,12 @@ public:
 
 
 	bool operator==(const Vertex& other) const {
-		return _pos == other._pos && _color == other._color && _texCoord == other._texCoord;
+		return Layout::equal(*this, other);
 	}
 
+	inline const glm::vec3& position() const { return _pos; }
+	inline const glm::vec2& tex_coord() const { return _texCoord; }
+
 	inline void scale(float scalar)	{ _pos *= scalar; }
 
 	inline void rotate_x(float degrees) { _rotate(degrees, 0); }
@@ -52,12 +61,10 @@ public:
 
 	/* @brief Returns attribute descriptions used for vertex input pipeline stage
 	*/
-	static std::array<VkVertexInputAttributeDescription, 3> getAttributeDescriptions();
+	static std::array<VkVertexInputAttributeDescription, Layout::ATTRIBUTE_COUNT> getAttributeDescriptions();
 
 private:
 
-	friend struct std::hash<Vertex>;
-
 	/*
 	* PRIVATE MEMBERS
 	*/
@@ -83,9 +90,7 @@ namespace std
 	{
 		size_t operator()(Vertex const& vertex) const 
 		{
-			return ((hash<glm::vec3>()(vertex._pos) ^
-				(hash<glm::vec3>()(vertex._color) << 1)) >> 1) ^
-				(hash<glm::vec2>()(vertex._texCoord) << 1);
+			return Vertex::Layout::hash(vertex);
 		}
 	};
 }
\ No newline at end of file
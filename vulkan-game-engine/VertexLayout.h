@@ -0,0 +1,122 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+/*
+* Description of a single vertex attribute
+*
+* @tparam T Type the attribute is stored as in a vertex
+* @tparam Format Format the vertex input stage reads it with
+* @tparam Location Shader input location it feeds
+*/
+template<typename T, VkFormat Format, uint32_t Location>
+struct VertexAttribute
+{
+	using value_type = T;
+
+	static constexpr VkFormat FORMAT = Format;
+	static constexpr uint32_t LOCATION = Location;
+	static constexpr uint32_t SIZE = sizeof(T);
+};
+
+/*
+* Attributes understood by the shaders
+*/
+using PositionF32 = VertexAttribute<glm::vec3, VK_FORMAT_R32G32B32_SFLOAT, 0>;
+using ColorF32 = VertexAttribute<glm::vec3, VK_FORMAT_R32G32B32_SFLOAT, 1>;
+using TexCoordF32 = VertexAttribute<glm::vec2, VK_FORMAT_R32G32_SFLOAT, 2>;
+using PositionUnorm16 = VertexAttribute<std::array<uint16_t, 4>, VK_FORMAT_R16G16B16A16_UNORM, 0>;
+using TexCoordUnorm16 = VertexAttribute<std::array<uint16_t, 2>, VK_FORMAT_R16G16_UNORM, 2>;
+
+/*
+* Compile time description of a packed, interleaved vertex made of the given attributes in order
+*
+* Stride, offsets and the Vulkan input descriptions are all constant expressions, so a pipeline specialized on a
+* layout points straight at static data. Vertex types declare their layout and check it against their members.
+*/
+template<typename... Attrs>
+class VertexLayout
+{
+public:
+
+	/*
+	* PUBLIC STATIC CONSTANTS
+	*/
+
+	static constexpr uint32_t ATTRIBUTE_COUNT = sizeof...(Attrs);
+
+	/* Size of one vertex in bytes
+	*/
+	static constexpr uint32_t STRIDE = (Attrs::SIZE + ... + 0);
+
+	/* Byte offset of each attribute within a vertex
+	*/
+	static constexpr std::array<uint32_t, ATTRIBUTE_COUNT> OFFSETS = [] {
+		std::array<uint32_t, ATTRIBUTE_COUNT> offsets{};
+		uint32_t sizes[] = { Attrs::SIZE... };
+		uint32_t offset = 0;
+		for (uint32_t i = 0; i < ATTRIBUTE_COUNT; ++i)
+		{
+			offsets[i] = offset;
+			offset += sizes[i];
+		}
+		return offsets;
+	}();
+
+	/* Binding description for a vertex buffer bound at binding 0
+	*/
+	static constexpr VkVertexInputBindingDescription BINDING = { 0, STRIDE, VK_VERTEX_INPUT_RATE_VERTEX };
+
+	/* Attribute descriptions in declaration order
+	*/
+	static constexpr std::array<VkVertexInputAttributeDescription, ATTRIBUTE_COUNT> ATTRIBUTES = [] {
+		std::array<VkVertexInputAttributeDescription, ATTRIBUTE_COUNT> attributes{};
+		uint32_t locations[] = { Attrs::LOCATION... };
+		VkFormat formats[] = { Attrs::FORMAT... };
+		for (uint32_t i = 0; i < ATTRIBUTE_COUNT; ++i)
+		{
+			attributes[i] = { locations[i], BINDING.binding, formats[i], OFFSETS[i] };
+		}
+		return attributes;
+	}();
+
+
+
+	/*
+	* PUBLIC STATIC METHODS
+	*/
+
+	/* @brief Compares the bytes of two vertices of this layout
+	*/
+	template<typename V>
+	static bool equal(const V& vertexA, const V& vertexB)
+	{
+		static_assert(sizeof(V) == STRIDE, "Vertex type doesn't match its layout");
+		return memcmp(&vertexA, &vertexB, STRIDE) == 0;
+	}
+
+	/* @brief Hashes the bytes of a vertex of this layout, one 32-bit word at a time
+	*/
+	template<typename V>
+	static size_t hash(const V& vertex)
+	{
+		static_assert(sizeof(V) == STRIDE, "Vertex type doesn't match its layout");
+		static_assert(STRIDE % sizeof(uint32_t) == 0, "Vertex layouts are hashed in whole words");
+
+		uint32_t words[STRIDE / sizeof(uint32_t)];
+		memcpy(words, &vertex, STRIDE);
+
+		uint64_t hash = 0xCBF29CE484222325ull;
+		for (uint32_t word : words)
+		{
+			hash = (hash ^ word) * 0x100000001B3ull;
+		}
+		return static_cast<size_t>(hash ^ (hash >> 32));
+	}
+};
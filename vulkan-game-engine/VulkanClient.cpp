@@ -10,6 +10,39 @@
 
 #include "VulkanInstance.h"
 
+/* @brief Waits for every task before collecting any result, so an exception can't leave the others running
+* on data that is about to be destroyed
+*/
+template<typename T>
+static std::vector<T> join_all(std::vector<std::future<T>>& tasks)
+{
+	for (auto& task : tasks)
+	{
+		task.wait();
+	}
+
+	std::vector<T> results;
+	results.reserve(tasks.size());
+	for (auto& task : tasks)
+	{
+		results.push_back(task.get());
+	}
+	return results;
+}
+
+static void join_all(std::vector<std::future<void>>& tasks)
+{
+	for (auto& task : tasks)
+	{
+		task.wait();
+	}
+
+	for (auto& task : tasks)
+	{
+		task.get();
+	}
+}
+
 /*
 * CTORS / ASSIGNMENT DEFINITIONS
 */
@@ -17,10 +50,17 @@
 VulkanClient::VulkanClient()
 	: _device({}),
 	_windows({}),
+	_offscreenExtents({}),
 	_shaderFiles({}),
-	_model3d()
+	_model3d(),
+	_meshes(nullptr),
+	_modelMesh(MeshRegistry::INVALID_HANDLE),
+	_vertexFormat(VertexFormat::FULL),
+	_lodErrorThreshold(1.0f),
+	_pipelineState(),
+	_meshletCulling(false)
 {
-	_model3d.from_obj("models/maxwell.obj");
+	// Only the transform is set up here, the model itself is loaded by `init()`
 	_model3d.scale(0.0005);
 	_model3d.rotate_x(90);
 }
@@ -43,24 +83,87 @@ void VulkanClient::add_window(const char* title, uint32_t width, uint32_t height
 	_windows.push_back(Window(title, width, height));
 }
 
+void VulkanClient::add_offscreen_target(uint32_t width, uint32_t height)
+{
+	_offscreenExtents.push_back({ width, height });
+}
+
 void VulkanClient::add_shader(const std::string& filepath, Shader::Type shaderType)
 {
 	_shaderFiles.push_back({ filepath, shaderType });
 }
 
-void VulkanClient::add_texture(const std::string& filepath)
+void VulkanClient::add_texture(const std::string& filepath, Texture::ColorSpace colorSpace)
 {
 	_textureFiles.push_back(filepath);
+	_textureColorSpaces.push_back(colorSpace);
 }
 
 void VulkanClient::init(const std::vector<const char*>& deviceExtensions)
 {
-	_create_logical_device(deviceExtensions);
+	_timeline.reset();
+	ThreadPool pool;
+
+	// Reading and processing files doesn't need the device, so it starts before the device is created
+	auto modelTask = pool.submit([this]() {
+		LoadTimeline::Scope step(_timeline, "model", _MODEL_FILE);
+		_model3d.from_obj(_MODEL_FILE);
+	});
+
+	std::vector<std::future<_TextureFile>> textureHeaders;
+	for (const auto& imgFile : _textureFiles)
+	{
+		textureHeaders.push_back(pool.submit([this, imgFile]() {
+			LoadTimeline::Scope step(_timeline, "texture headers", imgFile);
+
+			bool isKtx2 = imgFile.size() >= 5 && imgFile.compare(imgFile.size() - 5, 5, ".ktx2") == 0;
+			return isKtx2 ? _TextureFile(KTX2Image(imgFile)) : _TextureFile(PNGImage(imgFile));
+		}));
+	}
 
-	auto shaders = _load_shaders();
-	_load_textures();
+	{
+		LoadTimeline::Scope step(_timeline, "device", "logical device");
+		_create_logical_device(deviceExtensions);
+	}
+
+	auto shaderTasks = _load_shaders(pool);
+
+	std::future<Shader> cullShaderTask;
+	if (_meshletCulling)
+	{
+		cullShaderTask = pool.submit([this]() {
+			LoadTimeline::Scope step(_timeline, "shaders", _MESHLET_CULL_SHADER_FILE);
+			return Shader(_MESHLET_CULL_SHADER_FILE, Shader::COMPUTE, _device);
+		});
+	}
+
+	// Asset uploads run on the GPU while renderers are created
+	UploadBatch assetUploads(_device);
+	_load_textures(pool, textureHeaders, assetUploads);
+
+	modelTask.get();
+	{
+		LoadTimeline::Scope step(_timeline, "mesh upload", _MODEL_FILE);
+		_meshes = std::make_shared<MeshRegistry>(_device);
+		_modelMesh = _meshes->add(_model3d.get_mesh(), assetUploads, _vertexFormat);
+		assetUploads.submit();
+	}
+
+	auto shaders = std::make_shared<const std::vector<Shader>>(join_all(shaderTasks));
 	_model3d.set_texture(_textures[0]);
-	_create_renderers(shaders);
+	{
+		LoadTimeline::Scope step(_timeline, "renderers", "create renderers");
+		_create_renderers(shaders);
+	}
+
+	if (cullShaderTask.valid())
+	{
+		LoadTimeline::Scope step(_timeline, "renderers", "meshlet cull pipeline");
+		_enable_meshlet_culling(cullShaderTask.get());
+	}
+
+	LoadTimeline::Scope step(_timeline, "upload wait", "asset upload batch");
+	assetUploads.wait();
 }
 
 void VulkanClient::run()
@@ -84,8 +187,29 @@ void VulkanClient::run()
 	//*/
 }
 
+std::vector<VulkanRenderer::FrameStats> VulkanClient::run_offscreen(uint32_t numFrames)
+{
+	std::vector<VulkanRenderer::FrameStats> stats;
+	for (auto& renderer : _offscreenRenderers)
+	{
+		stats.push_back(renderer.render_offscreen(numFrames));
+	}
+
+	return stats;
+}
+
+std::vector<uint8_t> VulkanClient::read_offscreen_frame(size_t index)
+{
+	return _offscreenRenderers.at(index).read_last_frame();
+}
+
 void VulkanClient::stop()
 {
+	for (auto& renderer : _offscreenRenderers)
+	{
+		renderer.stop();
+	}
+
 	for (auto& future : _windowFutures)
 	{
 		future.get();
@@ -96,12 +220,61 @@ void VulkanClient::stop()
 
 
 
+/*
+* PUBLIC CONST METHOD DEFINITIONS
+*/
+
+void VulkanClient::print_texture_memory(std::ostream& out) const
+{
+	size_t totalBytes = 0;
+	size_t totalRgbaBytes = 0;
+
+	out << "Texture memory" << std::endl;
+	for (size_t i = 0; i < _textures.size(); ++i)
+	{
+		size_t bytes = _textures[i].size_in_bytes();
+		size_t rgbaBytes = _textures[i].rgba_size_in_bytes();
+		totalBytes += bytes;
+		totalRgbaBytes += rgbaBytes;
+
+		out << "  " << _textureFiles[i] << ": " << Texture::format_name(_textures[i].properties().format) << ", "
+			<< bytes << " bytes, " << rgbaBytes - bytes << " saved" << std::endl;
+	}
+	out << "  total: " << totalBytes << " bytes, " << totalRgbaBytes - totalBytes << " saved against RGBA8" << std::endl;
+}
+
+void VulkanClient::print_pipeline_cache_stats(std::ostream& out) const
+{
+	auto stats = _device.pipeline_cache()->stats();
+
+	out << "Pipeline cache: " << (stats.loadedBytes > 0 ? "warm, " : "cold, ") << stats.loadedBytes << " bytes loaded" << std::endl;
+	out << "  " << stats.pipelinesCreated << " pipelines in " << stats.compileMs << " ms";
+	if (stats.hasCreationFeedback)
+	{
+		out << ", " << stats.cacheHits << " hits, " << stats.cacheMisses << " misses";
+	}
+	out << std::endl;
+
+	auto moduleStats = _device.shader_modules()->stats();
+	out << "Shader modules: " << moduleStats.modulesCreated << " created, " << moduleStats.modulesReused << " reused" << std::endl;
+}
+
+
+
+
+
 /*
 * PRIVATE CONST METHOD DEFINITONS
 */
 
 bool VulkanClient::_device_compatible_with_surfaces(VkPhysicalDevice physicalDevice) const
 {
+	// Offscreen rendering only needs a graphics queue
+	if (_windows.empty())
+	{
+		return QueueFamilyInfo::info_for(physicalDevice, VK_NULL_HANDLE).queue_families_are_supported({ QueueFamilyType::Graphics });
+	}
+
 	QueueFamilyInfo queueFamilyInfo;
 	for (const auto& win : _windows)
 	{
@@ -198,33 +371,64 @@ void VulkanClient::_create_logical_device(const std::vector<const char*>& device
 		throw std::runtime_error("Failed to find a supported physical device");
 	}
 
-	auto queueFamilyInfo = QueueFamilyInfo::info_for(physicalDevice, _windows.front().surface_handle());
+	VkSurfaceKHR surface = _windows.empty() ? VK_NULL_HANDLE : _windows.front().surface_handle();
+	auto queueFamilyInfo = QueueFamilyInfo::info_for(physicalDevice, surface);
 
 	_device = Device(physicalDevice, queueFamilyInfo, deviceExtensions, validationLayers);
 }
 
-std::vector<Shader> VulkanClient::_load_shaders()
+std::vector<std::future<Shader>> VulkanClient::_load_shaders(ThreadPool& pool)
 {
-	std::vector<Shader> shaders;
-	for (auto shaderInfo : _shaderFiles)
+	std::vector<std::future<Shader>> shaders;
+	for (const auto& shaderInfo : _shaderFiles)
 	{
-		shaders.push_back(Shader(shaderInfo.first, shaderInfo.second, _device));
+		shaders.push_back(pool.submit([this, shaderInfo]() {
+			LoadTimeline::Scope step(_timeline, "shaders", shaderInfo.first);
+			return Shader(shaderInfo.first, shaderInfo.second, _device);
+		}));
 	}
 
 	return shaders;
 }
 
-void VulkanClient::_load_textures()
+void VulkanClient::_load_textures(ThreadPool& pool, std::vector<std::future<_TextureFile>>& headers, UploadBatch& uploads)
 {
-	CommandPool tempCmdPool(_device);
-	for (const auto& imgFile : _textureFiles)
+	auto files = join_all(headers);
+
+	// Images and staging buffers are created on this thread, since the upload batch can only be recorded from one thread.
+	// Compressed levels are copied straight from the mapped file, only PNGs are left to decode
+	std::vector<size_t> pngIndices;
+	std::vector<void*> stagedPixels;
+	for (size_t i = 0; i < files.size(); ++i)
 	{
-		PNGImage png(imgFile);
-		_textures.push_back(Texture(png, _device, tempCmdPool));
+		if (auto* pCompressed = std::get_if<KTX2Image>(&files[i]))
+		{
+			LoadTimeline::Scope step(_timeline, "texture upload", _textureFiles[i]);
+			_textures.push_back(Texture(*pCompressed, _device, uploads));
+			continue;
+		}
+
+		auto& image = std::get<PNGImage>(files[i]);
+		auto format = Texture::select_format(image, _textureColorSpaces[i], _device);
+		_textures.push_back(Texture(image.width(), image.height(), format, _device));
+		stagedPixels.push_back(uploads.stage_image(_textures.back(), image.size_in_bytes()));
+		pngIndices.push_back(i);
 	}
+
+	std::vector<std::future<void>> decodes;
+	for (size_t i = 0; i < pngIndices.size(); ++i)
+	{
+		decodes.push_back(pool.submit([this, &files, &stagedPixels, &pngIndices, i]() {
+			size_t fileIndex = pngIndices[i];
+			LoadTimeline::Scope step(_timeline, "texture decode", _textureFiles[fileIndex]);
+			std::get<PNGImage>(files[fileIndex]).decode(stagedPixels[i]);
+		}));
+	}
+
+	join_all(decodes);
 }
 
-void VulkanClient::_create_renderers(const std::vector<Shader>& shaders)
+void VulkanClient::_create_renderers(std::shared_ptr<const std::vector<Shader>> shaders)
 {
 	for (size_t i = 0; i < _windows.size(); ++i)
 	{
@@ -232,7 +436,40 @@ void VulkanClient::_create_renderers(const std::vector<Shader>& shaders)
 			_device,
 			_windows[i],
 			shaders,
-			_model3d
+			_meshes,
+			_modelMesh,
+			_model3d.get_texture()
 		));
+		_renderers.back().set_model_transform(_model3d.transform());
+		_renderers.back().set_lod_error_threshold(_lodErrorThreshold);
+		_renderers.back().set_pipeline_state(_pipelineState);
 	}
-}
\ No newline at end of file
+
+	for (const auto& extent : _offscreenExtents)
+	{
+		_offscreenRenderers.push_back(VulkanRenderer(
+			_device,
+			extent,
+			shaders,
+			_meshes,
+			_modelMesh,
+			_model3d.get_texture()
+		));
+		_offscreenRenderers.back().set_model_transform(_model3d.transform());
+		_offscreenRenderers.back().set_lod_error_threshold(_lodErrorThreshold);
+		_offscreenRenderers.back().set_pipeline_state(_pipelineState);
+	}
+}
+
+void VulkanClient::_enable_meshlet_culling(const Shader& cullShader)
+{
+	for (auto& renderer : _renderers)
+	{
+		renderer.enable_meshlet_culling(cullShader);
+	}
+
+	for (auto& renderer : _offscreenRenderers)
+	{
+		renderer.enable_meshlet_culling(cullShader);
+	}
+}
@@ -6,10 +6,17 @@
 #include <optional>
 #include <mutex>
 #include <future>
+#include <memory>
+#include <variant>
 
 #include "Window.h"
 #include "VulkanRenderer.h"
 #include "Model3D.h"
+#include "UploadBatch.h"
+#include "MeshRegistry.h"
+#include "LoadTimeline.h"
+#include "ThreadPool.h"
+#include "KTX2Image.h"
 
 /*
 * Class describing a client for rendering windows
@@ -38,6 +45,12 @@ public:
 	*/
 	void add_window(const char* title, uint32_t width, uint32_t height);
 
+	/* @brief Adds an offscreen target to be rendered without a window
+	* @param width Target width in pixels
+	* @param height Target height in pixels
+	*/
+	void add_offscreen_target(uint32_t width, uint32_t height);
+
 	/* @brief Loads a shader to be used for rendering
 	* @param filepath The path pointing to the shader file
 	* @param shaderType The type of shader being loaded
@@ -45,11 +58,35 @@ public:
 	void add_shader(const std::string& filepath, Shader::Type shaderType);
 
 	/* @brief Loads a texture to be used for rendering
-	* @param filepath The path pointing to the image file
+	* @param filepath The path pointing to the image file, either a PNG or a KTX2 container of compressed mip levels
+	* @param colorSpace Encoding of a PNG's color channels. Masks and roughness maps should be linear
+	*/
+	void add_texture(const std::string& filepath, Texture::ColorSpace colorSpace = Texture::ColorSpace::SRGB);
+
+	/* @brief Selects the layout meshes are uploaded in. Quantized meshes need the matching vertex shader
+	* @param vertexFormat Layout used for every mesh loaded by `init()`
+	*/
+	inline void set_vertex_format(VertexFormat vertexFormat) { _vertexFormat = vertexFormat; }
+
+	/* @brief Sets the largest on-screen error, in pixels, a mesh detail level may have before a finer one is drawn
+	* @param pixels Threshold passed to every renderer created by `init()`
+	*/
+	inline void set_lod_error_threshold(float pixels) { _lodErrorThreshold = pixels; }
+
+	/* @brief Sets the fixed-function state meshes are drawn with. Anything other than the default compiles after `init()`
+	* @param desc State passed to every renderer created by `init()`, its target fields are ignored
 	*/
-	void add_texture(const std::string& filepath);
+	inline void set_pipeline_state(const GraphicsPipeline::Desc& desc) { _pipelineState = desc; }
+
+	/* @brief Culls meshlets in a compute pass before the full detail level is drawn
+	* @param isEnabled Applies to every renderer created by `init()`, which then also loads the cull shader
+	*/
+	inline void set_meshlet_culling(bool isEnabled) { _meshletCulling = isEnabled; }
 
 	/* @brief Initializes the client internals. Must be called before running
+	*
+	* Model, texture and shader loading runs on a thread pool, overlapping with device creation where possible.
+	* Every step is recorded in the startup timeline
 	* 
 	* @param deviceExtensions List of device extensions to support
 	*/
@@ -59,14 +96,57 @@ public:
 	*/
 	void run();
 
+	/* @brief Renders every offscreen target. Client must be initialized before running
+	*
+	* @param numFrames Number of frames to render per target, or 0 to render until `stop()` is called
+	* @returns Frame timings for each offscreen target
+	*/
+	std::vector<VulkanRenderer::FrameStats> run_offscreen(uint32_t numFrames);
+
+	/* @brief Reads back the last frame rendered to an offscreen target as RGBA pixels
+	* @param index Index of the offscreen target, in the order they were added
+	*/
+	std::vector<uint8_t> read_offscreen_frame(size_t index = 0);
+
 	/* @brief Stops the client
 	*/
 	void stop();
 
+
+
+	/*
+	* PUBLIC CONST METHODS
+	*/
+
+	/* @brief Returns the device used for rendering. Only valid after `init()`
+	*/
+	inline const Device& device() const { return _device; }
+
+	/* @brief Returns the per-asset and per-phase durations of the last `init()`
+	*/
+	inline const LoadTimeline& startup_timeline() const { return _timeline; }
+
+	/* @brief Prints the format and device memory of every texture, and the bytes saved against uncompressed RGBA
+	*/
+	void print_texture_memory(std::ostream& out) const;
+
+	/* @brief Prints how many pipelines were created, how many hit the on-disk cache and how long creation took,
+	* and how many shader modules were shared instead of created
+	*/
+	void print_pipeline_cache_stats(std::ostream& out) const;
+
 private:
 
+	/* Texture file with its header read. PNGs still have to be decoded, KTX2 containers are mapped and ready to upload
+	*/
+	using _TextureFile = std::variant<PNGImage, KTX2Image>;
+
 	static constexpr size_t _NUM_FRAMES_IN_FLIGHT = 2;
 
+	static constexpr const char* _MODEL_FILE = "models/maxwell.obj";
+
+	static constexpr const char* _MESHLET_CULL_SHADER_FILE = "comp_meshlet_cull.spv";
+
 	/*
 	* PRIVATE MEMBERS
 	*/
@@ -79,6 +159,10 @@ private:
 	*/
 	std::vector<Window> _windows;
 
+	/* List of offscreen target sizes to draw
+	*/
+	std::vector<VkExtent2D> _offscreenExtents;
+
 	/* List of shader files and types
 	*/
 	std::vector < std::pair < std::string, Shader::Type> > _shaderFiles;
@@ -87,10 +171,18 @@ private:
 	*/
 	std::vector<std::string> _textureFiles;
 
+	/* Color space of each texture file
+	*/
+	std::vector<Texture::ColorSpace> _textureColorSpaces;
+
 	/* List of renderers, one per window
 	*/
 	std::vector<VulkanRenderer> _renderers;
 
+	/* List of headless renderers, one per offscreen target
+	*/
+	std::vector<VulkanRenderer> _offscreenRenderers;
+
 	/* List of futures for window renders
 	*/
 	std::vector<std::future<void>> _windowFutures;
@@ -103,8 +195,36 @@ private:
 	*/
 	Model3D _model3d;
 
+	/* GPU buffers of every mesh, shared by all renderers
+	*/
+	std::shared_ptr<MeshRegistry> _meshes;
+
+	/* Handle of the model's mesh in the registry
+	*/
+	MeshRegistry::Handle _modelMesh;
+
+	/* Layout meshes are uploaded in
+	*/
+	VertexFormat _vertexFormat;
+
+	/* Largest on-screen LOD error in pixels
+	*/
+	float _lodErrorThreshold;
+
+	/* Fixed-function state meshes are drawn with
+	*/
+	GraphicsPipeline::Desc _pipelineState;
+
+	/* Whether meshlets are culled on the GPU
+	*/
+	bool _meshletCulling;
+
 	std::vector<Texture> _textures;
 
+	/* Durations of the startup steps
+	*/
+	LoadTimeline _timeline;
+
 
 
 	/*
@@ -143,12 +263,22 @@ private:
 	*/
 	void _create_logical_device(const std::vector<const char*>& deviceExtensions);
 
-	std::vector<Shader> _load_shaders();
+	/* @brief Queues the creation of every shader module on the pool
+	*/
+	std::vector<std::future<Shader>> _load_shaders(ThreadPool& pool);
 
-	void _load_textures();
+	/* @brief Creates every texture and records its upload, decoding PNG pixels on the pool
+	*
+	* @param headers Tasks opening the texture files, in the order they were added
+	*/
+	void _load_textures(ThreadPool& pool, std::vector<std::future<_TextureFile>>& headers, UploadBatch& uploads);
+
+	/* @brief Creates the renderers that will draw to windows and offscreen targets
+	*/
+	void _create_renderers(std::shared_ptr<const std::vector<Shader>> shaders);
 
-	/* @brief Creates the renderers that will draw to windows
+	/* @brief Turns on meshlet culling in every renderer
 	*/
-	void _create_renderers(const std::vector<Shader>& shaders);
+	void _enable_meshlet_culling(const Shader& cullShader);
 };
 
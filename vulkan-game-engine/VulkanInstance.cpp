@@ -38,6 +38,9 @@ const std::vector<const char*> VulkanInstance::_VK_VALIDATION_LAYERS = {
     "VK_LAYER_KHRONOS_validation"
 };
 
+bool VulkanInstance::_isHeadless = false;
+bool VulkanInstance::_isCreated = false;
+
 
 
 
@@ -88,6 +91,16 @@ VulkanInstance& VulkanInstance::instance()
     return singleton;
 }
 
+void VulkanInstance::enable_headless_mode()
+{
+    if (_isCreated)
+    {
+        throw std::runtime_error("Headless mode must be enabled before the Vulkan instance is created");
+    }
+
+    _isHeadless = true;
+}
+
 
 
 
@@ -100,15 +113,20 @@ VulkanInstance::VulkanInstance()
     : _vkInstance(VkInstance{}), 
     _debugMessenger(VkDebugUtilsMessengerEXT{})
 {
-    glfwInit(); // Required to use GLFW methods
+    _isCreated = true;
+
+    if (!_isHeadless)
+    {
+        glfwInit(); // Required to use GLFW methods
+    }
 
     if (_VK_VALIDATION_IS_ENABLED && !validation_layers_are_supported(_VK_VALIDATION_LAYERS))
     {
         throw std::runtime_error("Requested validation layers are not supported");
     }
 
-    // Get required extensions
-    auto extensions = _get_gflw_extensions();
+    // Get required extensions, headless instances don't need any surface extensions
+    auto extensions = _isHeadless ? std::vector<const char*>{} : _get_gflw_extensions();
     if (_VK_VALIDATION_IS_ENABLED)
     {
         extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
@@ -144,7 +162,11 @@ VulkanInstance::~VulkanInstance()
 
     // Destroy instance and stop GLFW
     vkDestroyInstance(_vkInstance, nullptr);
-    glfwTerminate();
+
+    if (!_isHeadless)
+    {
+        glfwTerminate();
+    }
 }
 
 
@@ -56,6 +56,16 @@ public:
 	*/
 	static VulkanInstance& instance();
 
+	/* @brief Creates the instance without GLFW or any surface extensions. Must be called before `instance()`
+	*
+	* @throws std::runtime_error if the instance has already been created
+	*/
+	static void enable_headless_mode();
+
+	/* @brief Checks if the instance was created for headless rendering
+	*/
+	static inline bool is_headless() { return _isHeadless; }
+
 	/* @brief Checks if validation layers are enabled
 	*/
 	static inline constexpr bool validation_is_enabled() { return _VK_VALIDATION_IS_ENABLED; }
@@ -84,6 +94,20 @@ private:
 
 
 
+	/*
+	* PRIVATE STATIC VARS
+	*/
+
+	/* `true` if the instance is used without windows, `false` otherwise
+	*/
+	static bool _isHeadless;
+
+	/* `true` once the singleton has been constructed
+	*/
+	static bool _isCreated;
+
+
+
 	/*
 	* PRIVATE MEMBER VARS
 	*/
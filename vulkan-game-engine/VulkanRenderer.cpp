@@ -5,41 +5,67 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <cmath>
+
 VulkanRenderer::VulkanRenderer()
 	: _device(),
 	_window(),
-	_model(),
+	_meshes(nullptr),
+	_drawInfo({}),
+	_modelTransform(1.0f),
+	_lodErrorThreshold(_DEFAULT_LOD_ERROR_THRESHOLD),
+	_lodIndex(0),
 	_swapChain(),
 	_pipeline(),
+	_pipelineVariants(nullptr),
+	_pipelineDesc(),
 	_commandPool(),
 	_commandBuffers(),
 	_descriptorPool(),
-	_vertexBuffer(),
-	_indexBuffer(),
-	_uniformBuffers(),
-	_uniformBufMemory(),
+	_cullPipeline(),
+	_cullDescriptors(),
+	_drawCommands(),
+	_cullParamsOffset(0),
+	_frameRing(),
+	_uboOffset(0),
 	_ubo(),
 	_textureSampler(),
-	_depthImage()
+	_depthImage(),
+	_offscreenTarget(),
+	_isHeadless(false),
+	_lastImageIndex(0),
+	_stopRequested(false)
 {
 }
 
-VulkanRenderer::VulkanRenderer(const Device& device, const Window& window, const std::vector<Shader>& shaders, const Model3D& model3d)
+VulkanRenderer::VulkanRenderer(const Device& device, const Window& window, std::shared_ptr<const std::vector<Shader>> shaders, std::shared_ptr<const MeshRegistry> meshes, MeshRegistry::Handle mesh, const Texture& texture)
 	: _device(device),
 	_window(window),
-	_model(model3d),
+	_meshes(meshes),
+	_drawInfo(meshes->draw_info(mesh)),
+	_modelTransform(1.0f),
+	_lodErrorThreshold(_DEFAULT_LOD_ERROR_THRESHOLD),
+	_lodIndex(0),
 	_swapChain(),
 	_pipeline(),
+	_pipelineVariants(nullptr),
+	_pipelineDesc(),
 	_commandPool(),
 	_commandBuffers(),
 	_descriptorPool(),
-	_vertexBuffer(),
-	_indexBuffer(),
-	_uniformBuffers(),
-	_uniformBufMemory(),
+	_cullPipeline(),
+	_cullDescriptors(),
+	_drawCommands(),
+	_cullParamsOffset(0),
+	_frameRing(),
+	_uboOffset(0),
 	_ubo(),
 	_textureSampler(),
-	_depthImage()
+	_depthImage(),
+	_offscreenTarget(),
+	_isHeadless(false),
+	_lastImageIndex(0),
+	_stopRequested(false)
 {
 	_init_swap_chain();
 	_init_descriptor_pool();
@@ -47,29 +73,51 @@ VulkanRenderer::VulkanRenderer(const Device& device, const Window& window, const
 	_init_command_pool();
 	_init_depth_image();
 	_init_framebuffers();
-	_init_texture_sampler();
+	_init_texture_sampler(texture);
 	_init_buffers();
-	const auto& tex = _model.get_texture();
-	_init_descriptor_data(tex);
+	_init_descriptor_data(texture);
 	_init_command_buffers();
 }
 
-VulkanRenderer::VulkanRenderer(const VulkanRenderer& other)
-	: _device(other._device),
-	_window(other._window),
-	_model(other._model),
-	_swapChain(other._swapChain),
-	_pipeline(other._pipeline),
-	_commandPool(other._commandPool),
-	_descriptorPool(other._descriptorPool),
-	_vertexBuffer(other._vertexBuffer),
-	_indexBuffer(other._indexBuffer),
-	_uniformBuffers(other._uniformBuffers),
-	_uniformBufMemory(other._uniformBufMemory),
-	_ubo(other._ubo),
-	_textureSampler(other._textureSampler),
-	_depthImage(other._depthImage)
+VulkanRenderer::VulkanRenderer(const Device& device, VkExtent2D extent, std::shared_ptr<const std::vector<Shader>> shaders, std::shared_ptr<const MeshRegistry> meshes, MeshRegistry::Handle mesh, const Texture& texture)
+	: _device(device),
+	_window(),
+	_meshes(meshes),
+	_drawInfo(meshes->draw_info(mesh)),
+	_modelTransform(1.0f),
+	_lodErrorThreshold(_DEFAULT_LOD_ERROR_THRESHOLD),
+	_lodIndex(0),
+	_swapChain(),
+	_pipeline(),
+	_pipelineVariants(nullptr),
+	_pipelineDesc(),
+	_commandPool(),
+	_commandBuffers(),
+	_descriptorPool(),
+	_cullPipeline(),
+	_cullDescriptors(),
+	_drawCommands(),
+	_cullParamsOffset(0),
+	_frameRing(),
+	_uboOffset(0),
+	_ubo(),
+	_textureSampler(),
+	_depthImage(),
+	_offscreenTarget(),
+	_isHeadless(true),
+	_lastImageIndex(0),
+	_stopRequested(false)
 {
+	_init_offscreen_target(extent);
+	_init_descriptor_pool();
+	_init_graphics_pipeline(shaders);
+	_init_command_pool();
+	_init_depth_image();
+	_init_framebuffers();
+	_init_texture_sampler(texture);
+	_init_buffers();
+	_init_descriptor_data(texture);
+	_init_command_buffers();
 }
 
 VulkanRenderer::VulkanRenderer(VulkanRenderer&& other) noexcept
@@ -86,6 +134,8 @@ VulkanRenderer& VulkanRenderer::operator=(VulkanRenderer other)
 
 VulkanRenderer::~VulkanRenderer()
 {
+	// Variants still compiling use the descriptor set layout, which goes away with the descriptor pool
+	_pipelineVariants.reset();
 }
 
 
@@ -105,8 +155,8 @@ void VulkanRenderer::render(bool isAsync)
 		// Poll for events
 		_window.poll();
 
-		// Wait for fences
-		_commandPool.wait_for_fences();
+		// Wait for fences, which also frees this frame's ring buffer partition
+		_frameRing.begin_frame(_commandPool);
 
 		// Get next image from swap chain
 		bool swapChainIsOutdated = false;
@@ -123,14 +173,7 @@ void VulkanRenderer::render(bool isAsync)
 
 		auto currentTime = std::chrono::high_resolution_clock::now();
 		float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
-		auto extent = _swapChain.surface_extent();
-
-		auto model = glm::rotate(glm::mat4(1.0f), time * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-		auto view = glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-		auto proj = glm::perspective(glm::radians(45.0f), extent.width / (float)extent.height, 0.1f, 10.0f);
-		proj[1][1] *= -1;
-
-		_update_ubo(UBO(model, view, proj), _commandPool.get_current_frame_num());
+		_update_frame_ubo(time);
 
 		// Reset fences and record render pass command
 		_commandPool.reset_fences();
@@ -169,6 +212,135 @@ void VulkanRenderer::render(bool isAsync)
 
 
 
+VulkanRenderer::FrameStats VulkanRenderer::render_offscreen(uint32_t numFrames)
+{
+	if (!_isHeadless)
+	{
+		throw std::logic_error("Renderer was not created for offscreen rendering");
+	}
+
+	_mutex.lock();
+	auto graphicsQueue = _device.queue_family_info().get_queue_handle(QueueFamilyType::Graphics);
+	_mutex.unlock();
+
+	constexpr float FRAME_STEP_SECONDS = 1.0f / 60.0f;
+
+	FrameStats stats{ 0, 0.0, std::numeric_limits<double>::max(), 0.0 };
+
+	while (!_stopRequested && (numFrames == 0 || stats.frameCount < numFrames))
+	{
+		auto frameStart = std::chrono::high_resolution_clock::now();
+		auto currentFrame = _commandPool.get_current_frame_num();
+
+		// Wait for the frame that last used these resources
+		_frameRing.begin_frame(_commandPool);
+
+		// Every frame in flight owns one offscreen image
+		_update_frame_ubo(stats.frameCount * FRAME_STEP_SECONDS);
+
+		_commandPool.reset_fences();
+		_record_render_pass(_offscreenTarget.frame_buffer_at(currentFrame));
+
+		auto cmdBufHandle = _commandBuffers[currentFrame];
+
+		_mutex.lock();
+		_commandPool.submit_offscreen_to_queue(&cmdBufHandle, graphicsQueue);
+		_mutex.unlock();
+
+		_lastImageIndex = currentFrame;
+		_commandPool.increment_frame_counter();
+
+		auto frameEnd = std::chrono::high_resolution_clock::now();
+		double frameMs = std::chrono::duration<double, std::milli>(frameEnd - frameStart).count();
+		stats.totalMs += frameMs;
+		stats.minFrameMs = std::min(stats.minFrameMs, frameMs);
+		stats.maxFrameMs = std::max(stats.maxFrameMs, frameMs);
+		stats.frameCount++;
+	}
+
+	// Consume the stop on exit rather than entry, so a stop issued before the run started still ends it
+	_stopRequested = false;
+
+	// Include the GPU time of the frames still in flight
+	auto drainStart = std::chrono::high_resolution_clock::now();
+	vkDeviceWaitIdle(_device.handle());
+	stats.totalMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - drainStart).count();
+
+	if (stats.frameCount == 0)
+	{
+		stats.minFrameMs = 0.0;
+	}
+
+	return stats;
+}
+
+std::vector<uint8_t> VulkanRenderer::read_last_frame()
+{
+	if (!_isHeadless)
+	{
+		throw std::logic_error("Renderer was not created for offscreen rendering");
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	vkDeviceWaitIdle(_device.handle());
+	return _offscreenTarget.read_pixels(_device, _commandPool, _lastImageIndex);
+}
+
+void VulkanRenderer::set_pipeline_state(GraphicsPipeline::Desc desc)
+{
+	// Target fields have to match the render pass and vertex buffers the mesh is drawn with
+	const auto& baseDesc = _pipeline.desc();
+	desc.colorFormat = baseDesc.colorFormat;
+	desc.colorFinalLayout = baseDesc.colorFinalLayout;
+	desc.vertexFormat = baseDesc.vertexFormat;
+	desc.constants = baseDesc.constants.merged_with(desc.constants);
+
+	_pipelineDesc = desc;
+	if (desc != baseDesc)
+	{
+		_pipelineVariants->request(desc);
+	}
+}
+
+void VulkanRenderer::enable_meshlet_culling(const Shader& cullShader)
+{
+	// One indirect call draws every meshlet, drawing them one call each would cost more than the culling saves
+	if (_drawInfo.meshletCount == 0 || !_device.enabled_features().multiDrawIndirect)
+	{
+		return;
+	}
+
+	_cullDescriptors = DescriptorPool(
+		_device,
+		_NUM_FRAMES_IN_FLIGHT,
+		{ DescriptorPool::BindingType::UBO_DYNAMIC, DescriptorPool::BindingType::STORAGE_BUFFER, DescriptorPool::BindingType::STORAGE_BUFFER },
+		VK_SHADER_STAGE_COMPUTE_BIT
+	);
+	_cullPipeline = ComputePipeline(_device, cullShader, _cullDescriptors.descriptor_set_layout());
+	_drawCommands = Buffer(_device, Buffer::Type::INDIRECT, sizeof(VkDrawIndexedIndirectCommand) * _drawInfo.meshletCount);
+
+	std::vector<std::vector<DescriptorPool::DescriptorData>> descriptorData(_NUM_FRAMES_IN_FLIGHT);
+	for (uint32_t i = 0; i < _NUM_FRAMES_IN_FLIGHT; ++i)
+	{
+		DescriptorPool::DescriptorData paramsData{};
+		paramsData.uboSize = sizeof(_CullParams);
+		paramsData.uniformBuffer = _frameRing.handle();
+
+		DescriptorPool::DescriptorData meshletData{};
+		meshletData.storageSize = sizeof(MeshletBuilder::Meshlet) * _drawInfo.meshletCount;
+		meshletData.storageBuffer = _drawInfo.meshletBuffer;
+
+		DescriptorPool::DescriptorData drawData{};
+		drawData.storageSize = _drawCommands.size();
+		drawData.storageBuffer = _drawCommands.handle();
+
+		descriptorData[i] = { paramsData, meshletData, drawData };
+	}
+	_cullDescriptors.write_descriptor_set(descriptorData);
+}
+
+
+
 void VulkanRenderer::_init_swap_chain()
 {
 	auto formatFilter = [](VkSurfaceFormatKHR format)
@@ -184,18 +356,36 @@ void VulkanRenderer::_init_swap_chain()
 	_swapChain = SwapChain(_device, _window, formatFilter, presentModeFilter);
 }
 
+void VulkanRenderer::_init_offscreen_target(VkExtent2D extent)
+{
+	_offscreenTarget = OffscreenTarget(_device, extent, _NUM_FRAMES_IN_FLIGHT);
+}
+
 void VulkanRenderer::_init_descriptor_pool()
 {
 	_descriptorPool = DescriptorPool(
 		_device,
 		_NUM_FRAMES_IN_FLIGHT,
-		{ DescriptorPool::BindingType::UBO, DescriptorPool::BindingType::TEXTURE_SAMPLER }
+		{ DescriptorPool::BindingType::UBO_DYNAMIC, DescriptorPool::BindingType::TEXTURE_SAMPLER }
 	);
 }
 
-void VulkanRenderer::_init_graphics_pipeline(const std::vector<Shader>& shaders)
+void VulkanRenderer::_init_graphics_pipeline(std::shared_ptr<const std::vector<Shader>> shaders)
 {
-	_pipeline = GraphicsPipeline(_device, _swapChain, shaders, _descriptorPool);
+	GraphicsPipeline::Desc desc;
+	desc.colorFormat = _isHeadless ? OffscreenTarget::COLOR_FORMAT : _swapChain.surface_image_format();
+	desc.colorFinalLayout = _isHeadless ? OffscreenTarget::FINAL_LAYOUT : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+	desc.vertexFormat = _drawInfo.vertexFormat;
+
+	// Quantized coordinates that already span [0, 1] are passed through without the decode
+	bool decodeTexCoords = _drawInfo.decode.texCoord != glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+	desc.constants.set(Shader::DECODE_TEX_COORDS_CONSTANT, decodeTexCoords);
+
+	_pipeline = GraphicsPipeline(_device, desc, *shaders, _descriptorPool.descriptor_set_layout());
+
+	// Variants share the base pipeline's render pass format, so they can be bound inside its render pass
+	_pipelineVariants = std::make_shared<PipelineLibrary>(_device, shaders, _descriptorPool.descriptor_set_layout());
+	_pipelineDesc = _pipeline.desc();
 }
 
 void VulkanRenderer::_init_command_pool()
@@ -205,50 +395,30 @@ void VulkanRenderer::_init_command_pool()
 
 void VulkanRenderer::_init_depth_image()
 {
-	_depthImage = DepthImage(_device, _swapChain);
+	_depthImage = _isHeadless ? DepthImage(_device, _offscreenTarget.extent()) : DepthImage(_device, _swapChain);
 }
 
 void VulkanRenderer::_init_framebuffers()
 {
-	_swapChain.init_framebuffers(_pipeline.render_pass(), _depthImage.get_image_view());
+	if (_isHeadless)
+	{
+		_offscreenTarget.init_framebuffers(_pipeline.render_pass(), _depthImage.get_image_view());
+	}
+	else
+	{
+		_swapChain.init_framebuffers(_pipeline.render_pass(), _depthImage.get_image_view());
+	}
 }
 
-void VulkanRenderer::_init_texture_sampler()
+void VulkanRenderer::_init_texture_sampler(const Texture& texture)
 {
-	_textureSampler = TextureSampler(_device);
+	_textureSampler = TextureSampler(_device, texture.mip_levels());
 }
 
 void VulkanRenderer::_init_buffers()
 {
-	auto cmdPool = _commandPool.handle();
-	auto graphicsQueue = _device.queue_family_info().get_queue_handle(QueueFamilyType::Graphics);
-
-	// Create staging buffers for vertex/index buffers
-	auto mesh = _model.get_mesh();
-	auto vertexBufSize = mesh.size_of_vertices();
-	auto indexBufSize = mesh.size_of_indices();
-	Buffer vertexStagingBuf(_device, Buffer::Type::STAGING, vertexBufSize);
-	Buffer indexStagingBuf(_device, Buffer::Type::STAGING, indexBufSize);
-
-	// Create vertex buffer
-	_vertexBuffer = Buffer(_device, Buffer::Type::VERTEX, vertexBufSize);
-	vertexStagingBuf.copy_to_mapped_mem(mesh.vertex_data());
-	vertexStagingBuf.copy_to(_vertexBuffer, cmdPool, graphicsQueue);
-
-	// Create index buffer
-	_indexBuffer = Buffer(_device, Buffer::Type::INDEX, indexBufSize);
-	indexStagingBuf.copy_to_mapped_mem(mesh.index_data());
-	indexStagingBuf.copy_to(_indexBuffer, cmdPool, graphicsQueue);
-
-	// Create uniform buffers
-	_uniformBuffers = std::array<Buffer, _NUM_FRAMES_IN_FLIGHT>();
-	_uniformBuffers.fill(Buffer(_device, Buffer::Type::UNIFORM, sizeof(UBO)));
-
-	_uniformBufMemory = std::array<void*, _NUM_FRAMES_IN_FLIGHT>();
-	for (size_t i = 0; i < _NUM_FRAMES_IN_FLIGHT; ++i)
-	{
-		_uniformBuffers[i].map_memory(&_uniformBufMemory[i]);
-	}
+	// Mesh buffers live in the shared registry, per-frame data is sub-allocated from a single ring buffer
+	_frameRing = FrameRingBuffer(_device, _FRAME_RING_PARTITION_SIZE, _NUM_FRAMES_IN_FLIGHT);
 }
 
 void VulkanRenderer::_init_descriptor_data(const Texture& texture)
@@ -258,7 +428,7 @@ void VulkanRenderer::_init_descriptor_data(const Texture& texture)
 	{
 		DescriptorPool::DescriptorData uboData{};
 		uboData.uboSize = sizeof(UBO);
-		uboData.uniformBuffer = _uniformBuffers[i].handle();
+		uboData.uniformBuffer = _frameRing.handle();
 
 		DescriptorPool::DescriptorData samplerData{};
 		samplerData.textureImageView = texture.get_image_view();
@@ -283,17 +453,25 @@ void VulkanRenderer::_record_render_pass(VkFramebuffer frameBuffer)
 
 	VkCommandBufferBeginInfo cmdBeginInfo{};
 	VkRenderPassBeginInfo passBeginInfo{};
-	std::vector<VkClearValue> clearValues(2);
+	std::array<VkClearValue, 2> clearValues{};
 	clearValues[0].color = { {0.0f, 0.0f, 0.0f, 1.0f} };
 	clearValues[1].depthStencil = { 1.0f, 0 };
 
 	_configure_render_pass_cmd(&cmdBeginInfo, &passBeginInfo, frameBuffer, clearValues);
 	_commandBuffers.begin_one(cmdBeginInfo, currentFrame);
 
+	// Compute work can't be recorded inside a render pass, so the cull pass runs before it begins
+	const auto& pipeline = _current_pipeline();
+	bool isCulling = _is_culling(pipeline);
+	if (isCulling)
+	{
+		_record_cull_pass();
+	}
+
 	vkCmdBeginRenderPass(cmdBufHandle, &passBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
-	vkCmdBindPipeline(cmdBufHandle, VK_PIPELINE_BIND_POINT_GRAPHICS, _pipeline.handle());
+	vkCmdBindPipeline(cmdBufHandle, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.handle());
 
-	auto extent = _swapChain.surface_extent();
+	auto extent = _render_extent();
 	VkViewport viewport{};
 	viewport.x = 0.0f;
 	viewport.y = 0.0f;
@@ -308,22 +486,27 @@ void VulkanRenderer::_record_render_pass(VkFramebuffer frameBuffer)
 	scissor.extent = extent;
 	vkCmdSetScissor(cmdBufHandle, 0, 1, &scissor);
 
-	VkDeviceSize offsets[] = { 0 };
-	VkBuffer pVertexBuffers[] = {_vertexBuffer.handle()};
-	vkCmdBindVertexBuffers(cmdBufHandle, 0, 1, pVertexBuffers, offsets);
-	vkCmdBindIndexBuffer(cmdBufHandle, _indexBuffer.handle(), 0, VK_INDEX_TYPE_UINT32);
+	vkCmdBindVertexBuffers(cmdBufHandle, 0, 1, &_drawInfo.vertexBuffer, &_drawInfo.vertexBufferOffset);
+	vkCmdBindIndexBuffer(cmdBufHandle, _drawInfo.indexBuffer, _drawInfo.indexBufferOffset, _drawInfo.indexType);
 
 	auto descriptor = _descriptorPool[currentFrame];
-	auto mesh = _model.get_mesh();
-	vkCmdBindDescriptorSets(cmdBufHandle, VK_PIPELINE_BIND_POINT_GRAPHICS, _pipeline.layout_handle(), 0, 1, &descriptor, 0, nullptr);
-	vkCmdDrawIndexed(cmdBufHandle, static_cast<uint32_t>(mesh.indices().size()), 1, 0, 0, 0);
+	vkCmdBindDescriptorSets(cmdBufHandle, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.layout_handle(), 0, 1, &descriptor, 1, &_uboOffset);
+	if (isCulling)
+	{
+		vkCmdDrawIndexedIndirect(cmdBufHandle, _drawCommands.handle(), 0, _drawInfo.meshletCount, sizeof(VkDrawIndexedIndirectCommand));
+	}
+	else
+	{
+		const auto& lod = _drawInfo.lods[_lodIndex];
+		vkCmdDrawIndexed(cmdBufHandle, lod.indexCount, 1, lod.firstIndex, _drawInfo.vertexOffset, 0);
+	}
 
 	vkCmdEndRenderPass(cmdBufHandle);
 
 	_commandBuffers.end_one(currentFrame);
 }
 
-void VulkanRenderer::_configure_render_pass_cmd(VkCommandBufferBeginInfo* pCommandInfo, VkRenderPassBeginInfo* pPassInfo, VkFramebuffer frameBuffer, std::vector<VkClearValue>& clearValues)
+void VulkanRenderer::_configure_render_pass_cmd(VkCommandBufferBeginInfo* pCommandInfo, VkRenderPassBeginInfo* pPassInfo, VkFramebuffer frameBuffer, const std::array<VkClearValue, 2>& clearValues)
 {
 	memset(pCommandInfo, 0, sizeof(VkCommandBufferBeginInfo));
 	pCommandInfo->sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -333,7 +516,7 @@ void VulkanRenderer::_configure_render_pass_cmd(VkCommandBufferBeginInfo* pComma
 	pPassInfo->renderPass = _pipeline.render_pass();
 	pPassInfo->framebuffer = frameBuffer;
 	pPassInfo->renderArea.offset = { 0, 0 };
-	pPassInfo->renderArea.extent = _swapChain.surface_extent();
+	pPassInfo->renderArea.extent = _render_extent();
 
 	pPassInfo->clearValueCount = static_cast<uint32_t>(clearValues.size());
 	pPassInfo->pClearValues = clearValues.data();
@@ -355,8 +538,139 @@ void VulkanRenderer::_recreate_swap_chain()
 	_init_framebuffers();
 }
 
-void VulkanRenderer::_update_ubo(const UBO& src, size_t frameNum)
+void VulkanRenderer::_update_ubo(const UBO& src)
 {
 	_ubo = src;
-	memcpy(_uniformBufMemory[frameNum], &_ubo, sizeof(_ubo));
+	_uboOffset = static_cast<uint32_t>(_frameRing.push_uniform(_ubo).offset);
+}
+
+void VulkanRenderer::_update_frame_ubo(float time)
+{
+	auto extent = _render_extent();
+	const glm::vec3 eye(2.0f, 2.0f, 2.0f);
+
+	// Quantized positions are decoded first, then the model's own transform is applied, then the spin around the world z axis
+	auto world = glm::rotate(glm::mat4(1.0f), time * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f)) * _modelTransform;
+	auto model = world * _drawInfo.decode.position;
+	auto view = glm::lookAt(eye, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+	auto proj = glm::perspective(glm::radians(_FIELD_OF_VIEW_DEGREES), extent.width / (float)extent.height, _NEAR_PLANE, _FAR_PLANE);
+	proj[1][1] *= -1;
+
+	_select_lod(world, eye, extent);
+	_update_ubo(UBO(model, view, proj, _drawInfo.decode.texCoord));
+	if (_cullPipeline.handle() != VK_NULL_HANDLE)
+	{
+		_update_cull_params(world, proj * view, eye);
+	}
+}
+
+void VulkanRenderer::_update_cull_params(const glm::mat4& world, const glm::mat4& viewProj, const glm::vec3& eye)
+{
+	// Planes are the rows of the view projection matrix combined, with clip space depth running from 0 to w
+	auto row = [&viewProj](int i) { return glm::vec4(viewProj[0][i], viewProj[1][i], viewProj[2][i], viewProj[3][i]); };
+	std::array<glm::vec4, 6> planes = {
+		row(3) + row(0),
+		row(3) - row(0),
+		row(3) + row(1),
+		row(3) - row(1),
+		row(2),
+		row(3) - row(2)
+	};
+
+	_CullParams params{};
+	for (size_t i = 0; i < planes.size(); ++i)
+	{
+		// A normalized world space plane multiplied by the world matrix measures world distances from mesh space points
+		auto plane = planes[i] / glm::length(glm::vec3(planes[i]));
+		params.frustumPlanes[i] = plane * world;
+	}
+
+	float scale = std::max({ glm::length(glm::vec3(world[0])), glm::length(glm::vec3(world[1])), glm::length(glm::vec3(world[2])) });
+	params.cameraPosition = glm::vec4(glm::vec3(glm::inverse(world) * glm::vec4(eye, 1.0f)), scale);
+	params.meshletCount = _drawInfo.meshletCount;
+	params.firstIndex = _drawInfo.firstIndex;
+	params.vertexOffset = _drawInfo.vertexOffset;
+
+	_cullParamsOffset = static_cast<uint32_t>(_frameRing.push_uniform(params).offset);
+}
+
+bool VulkanRenderer::_is_culling(const GraphicsPipeline& pipeline) const
+{
+	// Meshlets only cover the full detail level, and the cone test assumes back faces are never drawn
+	return _cullPipeline.handle() != VK_NULL_HANDLE && _lodIndex == 0 && pipeline.desc().cullMode == VK_CULL_MODE_BACK_BIT;
+}
+
+void VulkanRenderer::_record_cull_pass()
+{
+	auto currentFrame = _commandPool.get_current_frame_num();
+
+	// The previous frame's draw may still be reading the commands this dispatch overwrites
+	_commandBuffers.buffer_barrier(
+		currentFrame,
+		_drawCommands.handle(),
+		VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT
+	);
+
+	_commandBuffers.dispatch(
+		currentFrame,
+		_cullPipeline,
+		_cullDescriptors[currentFrame],
+		{ _cullParamsOffset },
+		ComputePipeline::group_count(_drawInfo.meshletCount, _CULL_GROUP_SIZE)
+	);
+
+	_commandBuffers.buffer_barrier(
+		currentFrame,
+		_drawCommands.handle(),
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+		VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT
+	);
+}
+
+const GraphicsPipeline& VulkanRenderer::_current_pipeline()
+{
+	if (_pipelineDesc == _pipeline.desc())
+	{
+		return _pipeline;
+	}
+
+	// Drawing with the base pipeline for a few frames is better than stalling one on the compile
+	const auto* pVariant = _pipelineVariants->find_ready(_pipelineDesc);
+	return (pVariant != nullptr) ? *pVariant : _pipeline;
+}
+
+void VulkanRenderer::_select_lod(const glm::mat4& model, const glm::vec3& eye, VkExtent2D extent)
+{
+	_lodIndex = 0;
+	if (_drawInfo.lodCount <= 1)
+	{
+		return;
+	}
+
+	// Errors and the bounding sphere are in mesh units, the largest axis scale converts them to world units
+	float scale = std::max({ glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2])) });
+	glm::vec3 center = glm::vec3(model * glm::vec4(glm::vec3(_drawInfo.boundingSphere), 1.0f));
+	float distance = glm::length(center - eye) - _drawInfo.boundingSphere.w * scale;
+	if (distance <= _NEAR_PLANE)
+	{
+		return;
+	}
+
+	// Size of one world unit in pixels at the nearest point of the mesh
+	float pixelsPerUnit = extent.height / (2.0f * std::tan(glm::radians(_FIELD_OF_VIEW_DEGREES) * 0.5f) * distance);
+
+	for (uint32_t i = 1; i < _drawInfo.lodCount; ++i)
+	{
+		if (_drawInfo.lods[i].error * scale * pixelsPerUnit > _lodErrorThreshold)
+		{
+			break;
+		}
+		_lodIndex = i;
+	}
+}
+
+VkExtent2D VulkanRenderer::_render_extent() const
+{
+	return _isHeadless ? _offscreenTarget.extent() : _swapChain.surface_extent();
 }
\ No newline at end of file
@@ -2,12 +2,16 @@
 
 #include <array>
 #include <mutex>
+#include <atomic>
 #include <algorithm>
+#include <memory>
 
 #include "Device.h"
 #include "Shader.h"
 #include "SwapChain.h"
 #include "GraphicsPipeline.h"
+#include "PipelineLibrary.h"
+#include "ComputePipeline.h"
 #include "CommandPool.h"
 #include "DescriptorPool.h"
 #include "Buffer.h"
@@ -17,78 +21,228 @@
 #include "Texture.h"
 #include "TextureSampler.h"
 #include "DepthImage.h"
-#include "Model3D.h"
+#include "OffscreenTarget.h"
+#include "FrameRingBuffer.h"
+#include "MeshRegistry.h"
+#include "MeshletBuilder.h"
 
 class VulkanRenderer
 {
 
 public:
 
+	/* Frame timings collected while rendering offscreen
+	*/
+	struct FrameStats
+	{
+		uint32_t frameCount;
+		double totalMs;
+		double minFrameMs;
+		double maxFrameMs;
+
+		inline double average_frame_ms() const { return frameCount > 0 ? totalMs / frameCount : 0.0; }
+	};
+
 	friend void swap(VulkanRenderer& rendA, VulkanRenderer& rendB)
 	{
 		using std::swap;
 
 		swap(rendA._device, rendB._device);
 		swap(rendA._window, rendB._window);
-		swap(rendA._model, rendB._model);
+		swap(rendA._meshes, rendB._meshes);
+		swap(rendA._drawInfo, rendB._drawInfo);
+		swap(rendA._modelTransform, rendB._modelTransform);
+		swap(rendA._lodErrorThreshold, rendB._lodErrorThreshold);
+		swap(rendA._lodIndex, rendB._lodIndex);
 		swap(rendA._swapChain, rendB._swapChain);
 		swap(rendA._pipeline, rendB._pipeline);
+		swap(rendA._pipelineVariants, rendB._pipelineVariants);
+		swap(rendA._pipelineDesc, rendB._pipelineDesc);
 		swap(rendA._commandPool, rendB._commandPool);
 		swap(rendA._commandBuffers, rendB._commandBuffers);
 		swap(rendA._descriptorPool, rendB._descriptorPool);
-		swap(rendA._vertexBuffer, rendB._vertexBuffer);
-		swap(rendA._indexBuffer, rendB._indexBuffer);
-		swap(rendA._uniformBuffers, rendB._uniformBuffers);
-		swap(rendA._uniformBufMemory, rendB._uniformBufMemory);
+		swap(rendA._cullPipeline, rendB._cullPipeline);
+		swap(rendA._cullDescriptors, rendB._cullDescriptors);
+		swap(rendA._drawCommands, rendB._drawCommands);
+		swap(rendA._cullParamsOffset, rendB._cullParamsOffset);
+		swap(rendA._frameRing, rendB._frameRing);
+		swap(rendA._uboOffset, rendB._uboOffset);
 		swap(rendA._ubo, rendB._ubo);
 		swap(rendA._textureSampler, rendB._textureSampler);
 		swap(rendA._depthImage, rendB._depthImage);
+		swap(rendA._offscreenTarget, rendB._offscreenTarget);
+		swap(rendA._isHeadless, rendB._isHeadless);
+		swap(rendA._lastImageIndex, rendB._lastImageIndex);
 	}
 
 	VulkanRenderer();
-	VulkanRenderer(const Device& device, const Window& window, const std::vector<Shader>& shaders, const Model3D& model3d);
-	VulkanRenderer(const VulkanRenderer& other);
+	/*
+	* @param shaders Shaders the renderer's pipelines are built from, kept alive for variants compiled later
+	* @param meshes Registry holding the mesh to draw, shared with other renderers
+	* @param mesh Handle of the mesh to draw
+	* @param texture Texture sampled when drawing the mesh
+	*/
+	VulkanRenderer(const Device& device, const Window& window, std::shared_ptr<const std::vector<Shader>> shaders, std::shared_ptr<const MeshRegistry> meshes, MeshRegistry::Handle mesh, const Texture& texture);
+	/* Creates a headless renderer that draws into offscreen images instead of a window
+	*/
+	VulkanRenderer(const Device& device, VkExtent2D extent, std::shared_ptr<const std::vector<Shader>> shaders, std::shared_ptr<const MeshRegistry> meshes, MeshRegistry::Handle mesh, const Texture& texture);
+	VulkanRenderer(const VulkanRenderer&) = delete;
 	VulkanRenderer(VulkanRenderer&& other) noexcept;
 	VulkanRenderer& operator=(VulkanRenderer other);
 	~VulkanRenderer();
 
 	void render(bool isAsync = false);
 
+	/* @brief Renders offscreen for a fixed number of frames, or until `stop()` is called if `numFrames` is 0. 
+	* Animation advances at a fixed 60 Hz step per frame so runs are reproducible
+	*/
+	FrameStats render_offscreen(uint32_t numFrames = 0);
+
+	/* @brief Requests an offscreen render loop to stop after the current frame, or the next loop to stop before its first
+	* frame if none is running. Safe to call from another thread
+	*/
+	inline void stop() { _stopRequested = true; }
+
+	/* @brief Waits for the device and reads back the last frame rendered offscreen as RGBA pixels
+	*/
+	std::vector<uint8_t> read_last_frame();
+
+	/* @brief Sets the local transform of the drawn mesh. It goes into the UBO every frame, so the mesh itself is never rewritten
+	*/
+	inline void set_model_transform(const glm::mat4& transform) { _modelTransform = transform; }
+
+	/* @brief Sets the largest on-screen error, in pixels, a detail level may have before a finer one is drawn
+	*/
+	inline void set_lod_error_threshold(float pixels) { _lodErrorThreshold = pixels; }
+
+	/* @brief Switches the mesh to a pipeline with different fixed-function state
+	*
+	* The target fields of the description are replaced with the renderer's own, and its constants are applied on top of the
+	* renderer's. A new variant compiles in the background
+	* and the mesh keeps being drawn with the base pipeline until it is ready
+	*/
+	void set_pipeline_state(GraphicsPipeline::Desc desc);
+
+	/* @brief Culls the mesh's meshlets on the GPU before drawing the full detail level
+	*
+	* Each frame a compute pass writes one indirect draw per meshlet, with meshlets outside the frustum or facing away
+	* from the camera drawn zero times. Nothing changes if the device lacks multi-draw indirect. Coarser detail levels
+	* and pipelines without back-face culling are still drawn directly
+	*
+	* @param cullShader The meshlet cull compute shader, it can be destroyed once this returns
+	*/
+	void enable_meshlet_culling(const Shader& cullShader);
+
+	/* @brief Returns the detail level picked for the last frame, 0 being the full mesh
+	*/
+	inline uint32_t lod_index() const { return _lodIndex; }
+
+	/* @brief Checks if this renderer draws offscreen
+	*/
+	inline bool is_headless() const { return _isHeadless; }
+
 private:
 
 	static constexpr uint32_t _NUM_FRAMES_IN_FLIGHT = 2;
 
+	/* Bytes of per-frame data (UBOs, dynamic geometry) available to each frame in flight
+	*/
+	static constexpr VkDeviceSize _FRAME_RING_PARTITION_SIZE = 256 * 1024;
+
+	static constexpr float _DEFAULT_LOD_ERROR_THRESHOLD = 1.0f;
+	static constexpr float _FIELD_OF_VIEW_DEGREES = 45.0f;
+	static constexpr float _NEAR_PLANE = 0.1f;
+	static constexpr float _FAR_PLANE = 10.0f;
+
+	/* Workgroup size declared by the meshlet cull shader
+	*/
+	static constexpr uint32_t _CULL_GROUP_SIZE = 64;
+
+	/* Uniform block of the meshlet cull shader
+	*/
+	struct _CullParams
+	{
+		/* Frustum planes moved into mesh space, still giving distances in world units
+		*/
+		glm::vec4 frustumPlanes[6];
+
+		/* Camera position in mesh space in xyz, the mesh's world scale in w
+		*/
+		glm::vec4 cameraPosition;
+		uint32_t meshletCount;
+
+		/* Where the mesh starts in the shared buffers, added to every meshlet's mesh-relative draw
+		*/
+		uint32_t firstIndex;
+		int32_t vertexOffset;
+	};
+
 	Device _device;
 	Window _window;
-	Model3D _model;
+	std::shared_ptr<const MeshRegistry> _meshes;
+	MeshRegistry::DrawInfo _drawInfo;
+	glm::mat4 _modelTransform;
+	float _lodErrorThreshold;
+	uint32_t _lodIndex;
 	SwapChain _swapChain;
 	GraphicsPipeline _pipeline;
+	std::shared_ptr<PipelineLibrary> _pipelineVariants;
+	GraphicsPipeline::Desc _pipelineDesc;
 	CommandPool _commandPool;
 	CommandBufferPool _commandBuffers;
 	DescriptorPool _descriptorPool;
-	Buffer _vertexBuffer;
-	Buffer _indexBuffer;
-	std::array<Buffer, _NUM_FRAMES_IN_FLIGHT> _uniformBuffers;
-	std::array<void*, _NUM_FRAMES_IN_FLIGHT> _uniformBufMemory;
+	ComputePipeline _cullPipeline;
+	DescriptorPool _cullDescriptors;
+	Buffer _drawCommands;
+	uint32_t _cullParamsOffset;
+	FrameRingBuffer _frameRing;
+	uint32_t _uboOffset;
 	UBO _ubo;
 	TextureSampler _textureSampler;
 	DepthImage _depthImage;
+	OffscreenTarget _offscreenTarget;
+	bool _isHeadless;
+	uint32_t _lastImageIndex;
 	std::mutex _mutex;
+	std::atomic<bool> _stopRequested;
 
 	void _init_swap_chain();
+	void _init_offscreen_target(VkExtent2D extent);
 	void _init_descriptor_pool();
-	void _init_graphics_pipeline(const std::vector<Shader>& shaders);
+	void _init_graphics_pipeline(std::shared_ptr<const std::vector<Shader>> shaders);
 	void _init_command_pool();
 	void _init_depth_image();
 	void _init_framebuffers();
-	void _init_texture_sampler();
+	void _init_texture_sampler(const Texture& texture);
 	void _init_buffers();
 	void _init_descriptor_data(const Texture& texture);
 	void _init_command_buffers();
 
-	void _configure_render_pass_cmd(VkCommandBufferBeginInfo* pCommandInfo, VkRenderPassBeginInfo* pPassInfo, VkFramebuffer frameBuffer, std::vector<VkClearValue>& clearValues);
+	void _configure_render_pass_cmd(VkCommandBufferBeginInfo* pCommandInfo, VkRenderPassBeginInfo* pPassInfo, VkFramebuffer frameBuffer, const std::array<VkClearValue, 2>& clearValues);
 	void _record_render_pass(VkFramebuffer frameBuffer);
 	void _recreate_swap_chain();
-	void _update_ubo(const UBO& src, size_t frameNum);
+	void _update_ubo(const UBO& src);
+	void _update_frame_ubo(float time);
+
+	/* @brief Pushes this frame's meshlet cull parameters into the ring buffer
+	*/
+	void _update_cull_params(const glm::mat4& world, const glm::mat4& viewProj, const glm::vec3& eye);
+
+	/* @brief Checks if this frame's draw goes through the meshlet cull pass
+	*/
+	bool _is_culling(const GraphicsPipeline& pipeline) const;
+
+	/* @brief Records the meshlet cull dispatch and the barriers around the indirect draw buffer it writes
+	*/
+	void _record_cull_pass();
+
+	/* @brief Returns the pipeline the mesh is drawn with this frame, the base one while the requested variant compiles
+	*/
+	const GraphicsPipeline& _current_pipeline();
+
+	/* @brief Picks the coarsest detail level whose projected error stays under the threshold
+	*/
+	void _select_lod(const glm::mat4& model, const glm::vec3& eye, VkExtent2D extent);
+	VkExtent2D _render_extent() const;
 };
 
@@ -69,9 +69,12 @@ Window& Window::operator=(Window other)
 
 Window::~Window()
 {
-	auto& vulkan = VulkanInstance::instance();
-	vkDestroySurfaceKHR(vulkan.handle(), _surface, nullptr);
-	glfwDestroyWindow(_pWin);
+	if (_pWin != nullptr)
+	{
+		auto& vulkan = VulkanInstance::instance();
+		vkDestroySurfaceKHR(vulkan.handle(), _surface, nullptr);
+		glfwDestroyWindow(_pWin);
+	}
 }
 
 
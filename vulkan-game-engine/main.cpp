@@ -6,29 +6,277 @@
 #include <glm/vec4.hpp>
 #include <glm/mat4x4.hpp>
 
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
 #include <iostream>
+#include <string>
 
 #include "VulkanClient.h"
 #include "VulkanInstance.h"
 
+#include "Benchmarks.h"
 #include "PNGImage.h"
 
+static constexpr uint32_t WINDOW_WIDTH = 1920;
+static constexpr uint32_t WINDOW_HEIGHT = 1080;
+
+/* @brief Returns the compiled vertex shader that reads the given vertex layout
+*/
+static const char* vertex_shader_file(VertexFormat vertexFormat)
+{
+    return vertexFormat == VertexFormat::QUANTIZED ? "vert_quantized.spv" : "vert.spv";
+}
+
+/* @brief Checks that a compiled shader is present, and prints how to build it if not
+*
+* @param binaryPath SPIR-V file the renderer loads
+* @param sourcePath GLSL file the project build compiles it from
+*/
+static bool require_shader_binary(const std::string& binaryPath, const std::string& sourcePath)
+{
+    if (std::filesystem::exists(binaryPath))
+    {
+        return true;
+    }
+
+    std::cerr << binaryPath << " is missing, build the project to compile it from " << sourcePath << std::endl;
+    return false;
+}
+
+/* @brief Checks that a compiled shader declares every specialization constant in a set, and prints how to rebuild it if not
+*
+* @param binaryPath SPIR-V file the renderer loads
+* @param sourcePath GLSL file compile-shaders.bat builds it from
+*/
+static bool require_shader_constants(const std::string& binaryPath, const std::string& sourcePath, const SpecializationConstants& constants)
+{
+    auto declared = Shader::declared_constants(binaryPath);
+    for (const auto& [constantId, value] : constants.values())
+    {
+        if (std::find(declared.begin(), declared.end(), constantId) == declared.end())
+        {
+            std::cerr << binaryPath << " doesn't declare specialization constant " << constantId << ", rebuild it from " << sourcePath << " with compile-shaders.bat" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* @brief Renders offscreen for a fixed number of frames and prints frame timings
+*
+* @param numFrames Number of frames to render
+* @param capturePath If not empty, the last frame is written to this PNG file
+* @param vertexFormat Layout meshes are uploaded and drawn with
+* @param lodThreshold Largest on-screen LOD error in pixels
+* @param pipelineState Fixed-function state the mesh is drawn with
+* @param meshletCulling Whether meshlets are culled on the GPU before drawing
+*/
+static int run_headless(uint32_t numFrames, const std::string& capturePath, VertexFormat vertexFormat, float lodThreshold, const GraphicsPipeline::Desc& pipelineState, bool meshletCulling)
+{
+    VulkanInstance::enable_headless_mode();
+    VulkanInstance& vulkan = VulkanInstance::instance();
+    VulkanClient client;
+
+    client.add_offscreen_target(WINDOW_WIDTH, WINDOW_HEIGHT);
+    client.set_vertex_format(vertexFormat);
+    client.set_lod_error_threshold(lodThreshold);
+    client.set_pipeline_state(pipelineState);
+    client.set_meshlet_culling(meshletCulling);
+    client.add_shader(vertex_shader_file(vertexFormat), Shader::VERTEX);
+    client.add_shader("frag.spv", Shader::FRAGMENT);
+    client.add_texture("textures/dingus.png");
+    client.init();
+    client.startup_timeline().print(std::cout);
+    client.print_texture_memory(std::cout);
+    client.print_pipeline_cache_stats(std::cout);
+
+    auto stats = client.run_offscreen(numFrames).front();
+    std::cout << "Rendered " << stats.frameCount << " frames in " << stats.totalMs << " ms" << std::endl;
+    std::cout << "Frame time avg/min/max: "
+        << stats.average_frame_ms() << " / "
+        << stats.minFrameMs << " / "
+        << stats.maxFrameMs << " ms" << std::endl;
+
+    for (const auto& heap : client.device().allocator()->heap_stats())
+    {
+        std::cout << "Heap " << heap.heapIndex << ": "
+            << heap.usedBytes << " used / "
+            << heap.reservedBytes << " reserved / "
+            << heap.fragmentedBytes << " fragmented bytes in "
+            << heap.blockCount << " blocks, "
+            << heap.dedicatedCount << " dedicated" << std::endl;
+    }
+
+    if (!capturePath.empty())
+    {
+        PNGImage::write_rgba(capturePath, WINDOW_WIDTH, WINDOW_HEIGHT, client.read_offscreen_frame());
+        std::cout << "Wrote last frame to " << capturePath << std::endl;
+    }
+
+    return 0;
+}
+
 int main(int argc, char* argv[])
 {
+    // Usage: [--headless [numFrames]] [--capture file.png] [--bench-obj file.obj [iterations]] [--bench-mesh [numVertices]] [--bench-png file.png [iterations]] [--quantized] [--lod-threshold pixels]
+    //        [--double-sided] [--untextured] [--alpha-test [cutoff]] [--gpu-cull] [--encode-ktx2 in.png out.ktx2 [bc1|bc3|bc5|bc7]]
+    bool headless = false;
+    uint32_t numFrames = 300;
+    std::string capturePath;
+    VertexFormat vertexFormat = VertexFormat::FULL;
+    float lodThreshold = 1.0f;
+    GraphicsPipeline::Desc pipelineState;
+    bool meshletCulling = false;
+    std::string benchObjPath;
+    uint32_t benchIterations = 5;
+    uint32_t benchMeshVertices = 0;
+    std::string benchPngPath;
+    std::string encodePngPath;
+    std::string encodeKtx2Path;
+    std::string encodeFormat = "bc7";
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--headless")
+        {
+            headless = true;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0])))
+            {
+                numFrames = static_cast<uint32_t>(std::stoul(argv[++i]));
+            }
+        }
+        else if (arg == "--quantized")
+        {
+            vertexFormat = VertexFormat::QUANTIZED;
+        }
+        else if (arg == "--double-sided")
+        {
+            pipelineState.cullMode = VK_CULL_MODE_NONE;
+        }
+        else if (arg == "--gpu-cull")
+        {
+            meshletCulling = true;
+        }
+        else if (arg == "--untextured")
+        {
+            pipelineState.constants.set(Shader::USE_TEXTURE_CONSTANT, false);
+        }
+        else if (arg == "--alpha-test")
+        {
+            pipelineState.constants.set(Shader::ALPHA_TEST_CONSTANT, true);
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0])))
+            {
+                pipelineState.constants.set(Shader::ALPHA_CUTOFF_CONSTANT, std::stof(argv[++i]));
+            }
+        }
+        else if (arg == "--lod-threshold" && i + 1 < argc)
+        {
+            lodThreshold = std::stof(argv[++i]);
+        }
+        else if (arg == "--capture" && i + 1 < argc)
+        {
+            capturePath = argv[++i];
+        }
+        else if (arg == "--bench-obj" && i + 1 < argc)
+        {
+            benchObjPath = argv[++i];
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0])))
+            {
+                benchIterations = std::max(1u, static_cast<uint32_t>(std::stoul(argv[++i])));
+            }
+        }
+        else if (arg == "--bench-png" && i + 1 < argc)
+        {
+            benchPngPath = argv[++i];
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0])))
+            {
+                benchIterations = std::max(1u, static_cast<uint32_t>(std::stoul(argv[++i])));
+            }
+        }
+        else if (arg == "--encode-ktx2" && i + 2 < argc)
+        {
+            encodePngPath = argv[++i];
+            encodeKtx2Path = argv[++i];
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                encodeFormat = argv[++i];
+            }
+        }
+        else if (arg == "--bench-mesh")
+        {
+            benchMeshVertices = 4000000;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0])))
+            {
+                benchMeshVertices = std::max(1u, static_cast<uint32_t>(std::stoul(argv[++i])));
+            }
+        }
+    }
+
+    if (!encodePngPath.empty())
+    {
+        return Benchmarks::run_ktx2_encode(encodePngPath, encodeKtx2Path, encodeFormat);
+    }
+
+    if (benchMeshVertices > 0)
+    {
+        return Benchmarks::run_mesh_kernels(benchMeshVertices);
+    }
+
+    if (!benchPngPath.empty())
+    {
+        return Benchmarks::run_png_decode(benchPngPath, benchIterations);
+    }
+
+    if (!benchObjPath.empty())
+    {
+        return Benchmarks::run_obj_parser(benchObjPath, benchIterations);
+    }
+
+    // Only the fragment shader's features can be picked from the command line
+    if (!pipelineState.constants.empty() && !require_shader_constants("frag.spv", "shaders/shader.frag", pipelineState.constants))
+    {
+        return 1;
+    }
+
+    if (vertexFormat == VertexFormat::QUANTIZED && !require_shader_binary(vertex_shader_file(vertexFormat), "shaders/shader_quantized.vert"))
+    {
+        return 1;
+    }
+
+    if (meshletCulling && !require_shader_binary("comp_meshlet_cull.spv", "shaders/meshlet_cull.comp"))
+    {
+        return 1;
+    }
+
+    if (headless)
+    {
+        return run_headless(numFrames, capturePath, vertexFormat, lodThreshold, pipelineState, meshletCulling);
+    }
+
     VulkanInstance& vulkan = VulkanInstance::instance();
     VulkanClient client;
 
-    client.add_window("Game Engine", 1920, 1080);
+    client.add_window("Game Engine", WINDOW_WIDTH, WINDOW_HEIGHT);
     /**
     for (int i = 0; i < 1; i++)
     {
         client.add_window("Small", 800, 600);
     }
     //*/
-    client.add_shader("vert.spv", Shader::VERTEX);
+    client.set_vertex_format(vertexFormat);
+    client.set_lod_error_threshold(lodThreshold);
+    client.set_pipeline_state(pipelineState);
+    client.set_meshlet_culling(meshletCulling);
+    client.add_shader(vertex_shader_file(vertexFormat), Shader::VERTEX);
     client.add_shader("frag.spv", Shader::FRAGMENT);
     client.add_texture("textures/dingus.png");
     client.init({ VK_KHR_SWAPCHAIN_EXTENSION_NAME });
+    client.startup_timeline().print(std::cout);
+    client.print_texture_memory(std::cout);
+    client.print_pipeline_cache_stats(std::cout);
     client.run();
 
 	return 0;
@@ -1,5 +1,10 @@
 #version 450
 
+// Specialization constants, resolved when the pipeline is created so the unused paths compile away
+layout(constant_id = 0) const bool USE_TEXTURE = true;
+layout(constant_id = 1) const bool ALPHA_TEST = false;
+layout(constant_id = 2) const float ALPHA_CUTOFF = 0.5;
+
 layout(binding = 1) uniform sampler2D texSampler;
 
 layout(location = 0) in vec3 fragColor;
@@ -8,6 +13,13 @@ layout(location = 1) in vec2 fragTexCoord;
 layout(location = 0) out vec4 outColor;
 
 void main() {
-    outColor = texture(texSampler, fragTexCoord);
-    // outColor = vec4(fragColor, 1.0);
+    if (USE_TEXTURE) {
+        outColor = texture(texSampler, fragTexCoord);
+    } else {
+        outColor = vec4(fragColor, 1.0);
+    }
+
+    if (ALPHA_TEST && outColor.a < ALPHA_CUTOFF) {
+        discard;
+    }
 }
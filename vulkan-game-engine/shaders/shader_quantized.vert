@@ -0,0 +1,24 @@
+#version 450
+
+// Off when the mesh's texture coordinates already span [0, 1], which skips the decode
+layout(constant_id = 3) const bool DECODE_TEX_COORDS = true;
+
+layout(binding = 0) uniform UniformBufferObject {
+    mat4 model;
+    mat4 view;
+    mat4 proj;
+    vec4 texCoordDecode;
+} ubo;
+
+// UNORM16 attributes arrive in [0, 1], the model matrix already includes the position decode
+layout(location = 0) in vec3 inPosition;
+layout(location = 2) in vec2 inTexCoord;
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec2 fragTexCoord;
+
+void main() {
+    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0);
+    fragColor = vec3(1.0);
+    fragTexCoord = DECODE_TEX_COORDS ? ubo.texCoordDecode.xy + inTexCoord * ubo.texCoordDecode.zw : inTexCoord;
+}